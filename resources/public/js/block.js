@@ -704,6 +704,8 @@ function connectBlock() {
                     break;
                 case "plotdir-progress":
                 case "plotdirs-rescan":
+                case "plot-corrupted":
+                case "plot-health":
                     // do nothing
                     break;
                 default:
@@ -1,4 +1,8 @@
 var websocket;
+// the sequence number of the last state change, a reconnect resumes after it
+var websocketSeq = 0;
+// the id of the miner instance, the sequence number belongs to
+var websocketEpoch = "";
 var servername = 'creepMiner';
 var MasterMiner = 'false';
 var loggers = [
@@ -20,16 +24,50 @@ var levels = [
 
 function connect(onMessage) {
 	if ("WebSocket" in window) {
-		if (websocket)
+		if (websocket) {
+			websocket.onclose = null;
 			websocket.close();
+		}
 
 		if (location.protocol == "https:")
 			protocol ="wss"
 		else
 			protocol = "ws"
 
-		websocket = new WebSocket(protocol + "://" + window.location.host);
-		websocket.onmessage = onMessage;
+		var reconnect = websocketSeq > 0;
+		var url = protocol + "://" + window.location.host;
+
+		// the miner only sends the changes, that were missed while the connection was lost
+		if (reconnect)
+			url += "/?since=" + websocketSeq + "&epoch=" + encodeURIComponent(websocketEpoch);
+
+		websocket = new WebSocket(url);
+		websocket.onmessage = function (msg) {
+			var data = msg["data"];
+
+			if (typeof data === "string" && data != "ping") {
+				var json = JSON.parse(data);
+
+				// the missed changes are gone, so the page starts again with a new snapshot
+				if (reconnect && json["type"] == "sync" && json["snapshot"]) {
+					location.reload();
+					return;
+				}
+
+				if (json["seq"])
+					websocketSeq = json["seq"];
+
+				if (json["epoch"])
+					websocketEpoch = json["epoch"];
+			}
+
+			onMessage(msg);
+		};
+		websocket.onclose = function () {
+			setTimeout(function () {
+				connect(onMessage);
+			}, 3000);
+		};
 	}
 	else {
 		websocket = null;
@@ -4,6 +4,8 @@ var plotDirElements = [];
 
 var activePlotDir = null;
 var confirmedPlotfiles = [];
+var corruptedPlotfiles = [];
+var unhealthyPlotfiles = [];
 var current_selected = null;
 
 var isChecking=false;
@@ -31,6 +33,8 @@ function connectCallback(msg) {
                 resetProgress();
                 resetLineTypes();
                 confirmedPlotfiles = [];
+                colorUnhealthyPlotfiles();
+                colorCorruptedPlotfiles();
                 checkVersion(response["runningVersion"], response["onlineVersion"]);
                 break;
             case "plotdir-progress":
@@ -44,6 +48,12 @@ function connectCallback(msg) {
                 parsePlots();
                 fillDirs();
                 break;
+            case "plot-corrupted":
+                plotCorrupted(response["plotfile"]);
+                break;
+            case "plot-health":
+                setPlotHealth(response);
+                break;
             case "plotcheck-result":
                 setPlotIntegrity(response);
                 break;
@@ -76,6 +86,8 @@ function createDirLine(dirElement, index) {
         showPlotfiles(plotDirElements[index]["plotfiles"]); // Old version: showPlotfiles(dirElement["plotfiles"]);
         activePlotDir = dirElement;
         colorConfirmedPlotfiles();
+        colorUnhealthyPlotfiles();
+        colorCorruptedPlotfiles();
         current_selected = dirElement;
     });
 
@@ -297,6 +309,74 @@ function nonceConfirmed(plotfile) {
     colorConfirmedPlotfiles();
 }
 
+function colorPlotfiles(plotfiles, lineType) {
+    if (!activePlotDir) {
+        return;
+    }
+
+    for (var j = 0; j < plotfiles.length; ++j) {
+        for (var i = 0; i < activePlotDir.plotfiles.length; ++i) {
+            if (activePlotDir.plotfiles[i].path == plotfiles[j]) {
+                activePlotDir.plotfiles[i].setLineType(lineType);
+                break;
+            }
+        }
+    }
+}
+
+function colorCorruptedPlotfiles() {
+    colorPlotfiles(corruptedPlotfiles, 'danger');
+}
+
+function colorUnhealthyPlotfiles() {
+    colorPlotfiles(unhealthyPlotfiles, 'warning');
+}
+
+function setPlotHealth(health) {
+    health["devices"].forEach(function (device) {
+        var title = "latency " + device["latency"].toFixed(1) + "ms" +
+            ", p50 " + device["p50"].toFixed(1) + "ms" +
+            ", p95 " + device["p95"].toFixed(1) + "ms" +
+            ", p99 " + device["p99"].toFixed(1) + "ms" +
+            ", " + device["errors"] + " errors";
+
+        device["dirs"].forEach(function (dir) {
+            for (var i = 0; i < plotDirElements.length; ++i) {
+                if (plotDirElements[i]["path"] == dir) {
+                    plotDirElements[i]["element"].attr("title", title + (device["quarantined"] ? ", quarantined" : ""));
+
+                    if (device["quarantined"])
+                        plotDirElements[i].setProgressBarType('progress-bar-warning');
+                    break;
+                }
+            }
+        });
+    });
+
+    unhealthyPlotfiles = health["files"].map(function (file) {
+        return file["path"];
+    });
+
+    colorUnhealthyPlotfiles();
+    colorCorruptedPlotfiles();
+}
+
+function plotCorrupted(plotfile) {
+    for (var i = 0; i < plotDirElements.length; ++i) {
+        if (plotfile.length > plotDirElements[i].path.length) {
+            if (plotfile.substring(0, plotDirElements[i].path.length) == plotDirElements[i].path) {
+                plotDirElements[i].setProgressBarType('progress-bar-danger');
+                break;
+            }
+        }
+    }
+
+    if (corruptedPlotfiles.indexOf(plotfile) < 0)
+        corruptedPlotfiles.push(plotfile);
+
+    colorCorruptedPlotfiles();
+}
+
 function remove_selected_plot_dir() {
     if (current_selected) {
         $.get("/");
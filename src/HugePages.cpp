@@ -0,0 +1,205 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#include "HugePages.hpp"
+#include <mutex>
+#include <new>
+#include <unordered_set>
+#include <Poco/String.h>
+
+#if defined(__linux__)
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+#endif
+
+std::atomic<Burst::HugePageMode> Burst::HugePages::mode_{HugePageMode::Off};
+std::atomic<Poco::UInt64> Burst::HugePages::allocations_{0};
+std::atomic<Poco::UInt64> Burst::HugePages::hugeTlbAllocations_{0};
+std::atomic<Poco::UInt64> Burst::HugePages::advisedAllocations_{0};
+
+constexpr size_t Burst::HugePages::PageSize;
+
+namespace
+{
+	size_t toPageSize(const size_t bytes)
+	{
+		return (bytes + Burst::HugePages::PageSize - 1) / Burst::HugePages::PageSize * Burst::HugePages::PageSize;
+	}
+
+	// the mode can change while buffers are alive, so deallocate() looks up, which buffers were mapped
+	std::mutex mappedMutex;
+	std::unordered_set<void*> mapped;
+
+	void addMapped(void* memory)
+	{
+		std::lock_guard<std::mutex> lock{mappedMutex};
+		mapped.insert(memory);
+	}
+
+	bool removeMapped(void* memory)
+	{
+		std::lock_guard<std::mutex> lock{mappedMutex};
+		return mapped.erase(memory) > 0;
+	}
+}
+
+void Burst::HugePages::setMode(const HugePageMode mode)
+{
+	mode_ = mode;
+}
+
+Burst::HugePageMode Burst::HugePages::getMode()
+{
+	return mode_;
+}
+
+Burst::HugePageMode Burst::HugePages::fromString(const std::string& mode)
+{
+	const auto modeLower = Poco::toLower(mode);
+
+	if (modeLower == "transparent")
+		return HugePageMode::Transparent;
+
+	if (modeLower == "hugetlb")
+		return HugePageMode::HugeTlb;
+
+	return HugePageMode::Off;
+}
+
+std::string Burst::HugePages::toString(const HugePageMode mode)
+{
+	switch (mode)
+	{
+	case HugePageMode::Transparent: return "transparent";
+	case HugePageMode::HugeTlb: return "hugetlb";
+	default: return "off";
+	}
+}
+
+void* Burst::HugePages::allocate(const size_t bytes)
+{
+#if defined(__linux__)
+	const auto mode = mode_.load();
+
+	// with hugepages big buffers are mapped on their own
+	if (bytes >= PageSize && mode != HugePageMode::Off)
+	{
+		const auto length = toPageSize(bytes);
+		++allocations_;
+
+#ifdef MAP_HUGETLB
+		if (mode == HugePageMode::HugeTlb)
+		{
+			const auto memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+			if (memory != MAP_FAILED)
+			{
+				++hugeTlbAllocations_;
+				addMapped(memory);
+				return memory;
+			}
+		}
+#endif
+
+		// no reserved hugepages (left), take normal pages
+		const auto memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+		if (memory == MAP_FAILED)
+			throw std::bad_alloc{};
+
+#ifdef MADV_HUGEPAGE
+		// and let the kernel merge them into transparent hugepages
+		if (madvise(memory, length, MADV_HUGEPAGE) == 0)
+			++advisedAllocations_;
+#endif
+
+		addMapped(memory);
+		return memory;
+	}
+#endif
+
+	return ::operator new(bytes);
+}
+
+void Burst::HugePages::deallocate(void* memory, const size_t bytes) noexcept
+{
+	if (memory == nullptr)
+		return;
+
+#if defined(__linux__)
+	if (bytes >= PageSize && removeMapped(memory))
+	{
+		munmap(memory, toPageSize(bytes));
+		return;
+	}
+#endif
+
+	::operator delete(memory);
+}
+
+Poco::UInt64 Burst::HugePages::getAllocations()
+{
+	return allocations_;
+}
+
+Poco::UInt64 Burst::HugePages::getHugeTlbAllocations()
+{
+	return hugeTlbAllocations_;
+}
+
+Poco::UInt64 Burst::HugePages::getAdvisedAllocations()
+{
+	return advisedAllocations_;
+}
+
+double Burst::HugePages::getHitRate()
+{
+	const auto allocations = getAllocations();
+
+	if (allocations == 0)
+		return 0.;
+
+	return static_cast<double>(getHugeTlbAllocations()) / allocations;
+}
+
+Poco::UInt64 Burst::HugePages::getTransparentBytes()
+{
+#if defined(__linux__)
+	std::ifstream smaps{"/proc/self/smaps_rollup"};
+	std::string line;
+
+	while (smaps && std::getline(smaps, line))
+	{
+		// e.g. "AnonHugePages:    409600 kB"
+		if (line.compare(0, 14, "AnonHugePages:") != 0)
+			continue;
+
+		std::stringstream sstream{line.substr(14)};
+		Poco::UInt64 kiloBytes = 0;
+		sstream >> kiloBytes;
+		return kiloBytes * 1024;
+	}
+#endif
+
+	return 0;
+}
@@ -0,0 +1,154 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Declarations.hpp"
+
+namespace Burst
+{
+	enum class HugePageMode
+	{
+		Off,
+		Transparent,
+		HugeTlb
+	};
+
+	/**
+	 * \brief Allocates big buffers with 2 MB hugepages.
+	 * Buffers smaller than a hugepage and all buffers with mode Off are allocated on the heap as usual.
+	 */
+	class HugePages
+	{
+	public:
+		~HugePages() = delete;
+
+		static constexpr size_t PageSize = 2 * 1024 * 1024;
+
+		/**
+		 * \brief Sets, how the big buffers are backed.
+		 * Off leaves it to the system, Transparent advises the kernel to use transparent hugepages
+		 * and HugeTlb takes reserved hugepages and falls back to Transparent, when there are none left.
+		 * \param mode The mode.
+		 */
+		static void setMode(HugePageMode mode);
+		static HugePageMode getMode();
+
+		/**
+		 * \brief Parses a mode ("off", "transparent" or "hugetlb").
+		 * \param mode The mode as string.
+		 * \return The mode, Off if the string is unknown.
+		 */
+		static HugePageMode fromString(const std::string& mode);
+		static std::string toString(HugePageMode mode);
+
+		/**
+		 * \brief Allocates memory.
+		 * \param bytes The size of the memory.
+		 * \return The memory, never nullptr.
+		 * \throws std::bad_alloc If the memory could not be allocated.
+		 */
+		static void* allocate(size_t bytes);
+
+		/**
+		 * \brief Gives free memory, that was allocated with allocate().
+		 * \param memory The memory.
+		 * \param bytes The size, that was passed to allocate().
+		 */
+		static void deallocate(void* memory, size_t bytes) noexcept;
+
+		/**
+		 * \brief Returns the number of big buffers, that were allocated with hugepages enabled so far.
+		 */
+		static Poco::UInt64 getAllocations();
+
+		/**
+		 * \brief Returns the number of big buffers, that are backed by reserved hugepages.
+		 */
+		static Poco::UInt64 getHugeTlbAllocations();
+
+		/**
+		 * \brief Returns the number of big buffers, that were advised for transparent hugepages.
+		 * The kernel is free to ignore the advice, getTransparentBytes() tells, how much it followed it.
+		 */
+		static Poco::UInt64 getAdvisedAllocations();
+
+		/**
+		 * \brief Returns the share of big buffers, that are backed by reserved hugepages.
+		 * \return The hit rate between 0 and 1.
+		 */
+		static double getHitRate();
+
+		/**
+		 * \brief Returns the memory of the process, that is currently backed by transparent hugepages.
+		 * \return The size in bytes, 0 if unknown.
+		 */
+		static Poco::UInt64 getTransparentBytes();
+
+	private:
+		static std::atomic<HugePageMode> mode_;
+		static std::atomic<Poco::UInt64> allocations_, hugeTlbAllocations_, advisedAllocations_;
+	};
+
+	/**
+	 * \brief A std allocator, that allocates with HugePages.
+	 */
+	template <typename T>
+	struct HugePageAllocator
+	{
+		using value_type = T;
+
+		HugePageAllocator() = default;
+
+		template <typename U>
+		HugePageAllocator(const HugePageAllocator<U>&) noexcept
+		{}
+
+		T* allocate(const size_t n)
+		{
+			return static_cast<T*>(HugePages::allocate(n * sizeof(T)));
+		}
+
+		void deallocate(T* memory, const size_t n) noexcept
+		{
+			HugePages::deallocate(memory, n * sizeof(T));
+		}
+	};
+
+	template <typename T, typename U>
+	bool operator==(const HugePageAllocator<T>&, const HugePageAllocator<U>&)
+	{
+		return true;
+	}
+
+	template <typename T, typename U>
+	bool operator!=(const HugePageAllocator<T>&, const HugePageAllocator<U>&)
+	{
+		return false;
+	}
+
+	using ScoopBuffer = std::vector<ScoopData, HugePageAllocator<ScoopData>>;
+}
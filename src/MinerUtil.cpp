@@ -45,6 +45,8 @@
 #include <Poco/HMACEngine.h>
 #include <Poco/SHA1Engine.h>
 #include <Poco/File.h>
+#include <Poco/NumberParser.h>
+#include <Poco/String.h>
 #include <fstream>
 #include "plots/PlotSizes.hpp"
 #include <chrono>
@@ -52,14 +54,27 @@
 #if defined(_WIN32)
 #include <Windows.h>
 #include <conio.h>
+#include <Poco/UnicodeConverter.h>
 #elif defined(__unix__) || defined(__unix) || defined(unix) || (defined(__APPLE__) && defined(__MACH__))
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/param.h>
 #include <termios.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 #if defined(BSD)
 #include <sys/sysctl.h>
 #endif
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#include <linux/fiemap.h>
+#include <sys/sysmacros.h>
+#include <climits>
+#include <cstdlib>
+#endif
 
 #endif
 
@@ -1112,3 +1127,197 @@ Poco::Path Burst::getMinerHomeDir(const std::string& filename)
 {
 	return getMinerHomeDir().append(filename);
 }
+
+Poco::UInt64 Burst::getDeviceId(const std::string& path)
+{
+#if defined(_WIN32)
+	// the serial number of the volume, so volumes mounted into a folder of another drive are distinguished
+	std::wstring pathW, volumeW(MAX_PATH + 1, L'\0');
+	Poco::UnicodeConverter::toUTF16(Poco::Path{path}.absolute().toString(), pathW);
+
+	if (!GetVolumePathNameW(pathW.c_str(), &volumeW[0], static_cast<DWORD>(volumeW.size())))
+		return 0;
+
+	DWORD serial = 0;
+
+	if (!GetVolumeInformationW(volumeW.c_str(), nullptr, 0, &serial, nullptr, nullptr, nullptr, 0))
+		return 0;
+
+	return static_cast<Poco::UInt64>(serial);
+#else
+	struct stat fileStat{};
+
+	if (stat(path.c_str(), &fileStat) != 0)
+		return 0;
+
+	return static_cast<Poco::UInt64>(fileStat.st_dev);
+#endif
+}
+
+std::vector<Burst::FileExtent> Burst::getFileExtents(const std::string& path)
+{
+	std::vector<FileExtent> extents;
+
+#if defined(__linux__)
+	const auto fd = open(path.c_str(), O_RDONLY);
+
+	if (fd < 0)
+		return extents;
+
+	// first we ask for the number of extents...
+	fiemap countRequest{};
+	countRequest.fm_start = 0;
+	countRequest.fm_length = FIEMAP_MAX_OFFSET;
+	countRequest.fm_extent_count = 0;
+
+	if (ioctl(fd, FS_IOC_FIEMAP, &countRequest) == 0 && countRequest.fm_mapped_extents > 0)
+	{
+		// ... and then for the extents itself
+		const auto extentCount = countRequest.fm_mapped_extents;
+		std::vector<char> request(sizeof(fiemap) + extentCount * sizeof(fiemap_extent));
+		auto map = reinterpret_cast<fiemap*>(request.data());
+		map->fm_start = 0;
+		map->fm_length = FIEMAP_MAX_OFFSET;
+		map->fm_extent_count = extentCount;
+
+		if (ioctl(fd, FS_IOC_FIEMAP, map) == 0)
+		{
+			extents.reserve(map->fm_mapped_extents);
+
+			for (auto i = 0u; i < map->fm_mapped_extents; ++i)
+			{
+				const auto& extent = map->fm_extents[i];
+
+				// the physical position of these extents is meaningless
+				if (extent.fe_flags & (FIEMAP_EXTENT_UNKNOWN | FIEMAP_EXTENT_DELALLOC | FIEMAP_EXTENT_NOT_ALIGNED))
+					continue;
+
+				extents.emplace_back(FileExtent{extent.fe_logical, extent.fe_physical, extent.fe_length});
+			}
+		}
+	}
+
+	close(fd);
+#else
+	// not supported, the caller falls back to the logical order
+	(void)path;
+#endif
+
+	return extents;
+}
+
+std::vector<unsigned> Burst::parseCpuList(const std::string& cpuList)
+{
+	std::vector<unsigned> cpus;
+
+	try
+	{
+		for (auto range : splitStr(cpuList, ','))
+		{
+			range = Poco::trim(range);
+
+			if (range.empty())
+				continue;
+
+			const auto dash = range.find('-');
+			const auto first = Poco::NumberParser::parseUnsigned(range.substr(0, dash));
+			const auto last = dash == std::string::npos ? first : Poco::NumberParser::parseUnsigned(range.substr(dash + 1));
+
+			for (auto cpu = first; cpu <= last; ++cpu)
+				cpus.emplace_back(cpu);
+		}
+	}
+	catch (Poco::Exception&)
+	{
+		return {};
+	}
+
+	std::sort(cpus.begin(), cpus.end());
+	cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+
+	return cpus;
+}
+
+std::vector<unsigned> Burst::getNumaNodeCpus(const unsigned node)
+{
+#if defined(__linux__)
+	std::ifstream cpuListFile{"/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"};
+	std::string cpuList;
+
+	if (cpuListFile && std::getline(cpuListFile, cpuList))
+		return parseCpuList(cpuList);
+#endif
+
+	return {};
+}
+
+bool Burst::setThreadAffinity(const std::vector<unsigned>& cpus)
+{
+	if (cpus.empty())
+		return false;
+
+#if defined(__linux__)
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+
+	for (const auto cpu : cpus)
+		if (cpu < CPU_SETSIZE)
+			CPU_SET(cpu, &cpuSet);
+
+	return pthread_setaffinity_np(pthread_self(), sizeof cpuSet, &cpuSet) == 0;
+#elif defined(_WIN32)
+	DWORD_PTR mask = 0;
+
+	// without processor groups only the first 64 cpus can be addressed
+	for (const auto cpu : cpus)
+		if (cpu < sizeof(DWORD_PTR) * 8)
+			mask |= DWORD_PTR{1} << cpu;
+
+	return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#else
+	// macOS only knows affinity hints, not hard pinning
+	return false;
+#endif
+}
+
+Burst::DevicePowerState Burst::getDevicePowerState(const std::string& path)
+{
+#if defined(__linux__)
+	struct stat fileStat{};
+
+	if (stat(path.c_str(), &fileStat) != 0)
+		return DevicePowerState::Unknown;
+
+	const auto sysDevice = "/sys/dev/block/" + std::to_string(major(fileStat.st_dev)) + ":" +
+		std::to_string(minor(fileStat.st_dev));
+
+	char resolved[PATH_MAX];
+
+	if (realpath(sysDevice.c_str(), resolved) == nullptr)
+		return DevicePowerState::Unknown;
+
+	std::string blockDevice = resolved;
+
+	// the power state belongs to the whole disk, not to the partition
+	if (Poco::File{blockDevice + "/partition"}.exists())
+		blockDevice = Poco::Path{blockDevice}.parent().toString();
+
+	std::ifstream controlFile{blockDevice + "/device/power/control"};
+	std::ifstream statusFile{blockDevice + "/device/power/runtime_status"};
+	std::string control, status;
+
+	// without runtime power management the status is always active, even for a sleeping disk
+	if (!std::getline(controlFile, control) || Poco::trim(control) != "auto" || !std::getline(statusFile, status))
+		return DevicePowerState::Unknown;
+
+	Poco::trimInPlace(status);
+
+	if (status == "suspended")
+		return DevicePowerState::Standby;
+
+	if (status == "active")
+		return DevicePowerState::Active;
+#endif
+
+	return DevicePowerState::Unknown;
+}
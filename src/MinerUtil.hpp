@@ -78,6 +78,16 @@ namespace Burst
 		Incomplete
 	};
 
+	/**
+	 * \brief A contiguous region of a file on its device.
+	 */
+	struct FileExtent
+	{
+		Poco::UInt64 logical;
+		Poco::UInt64 physical;
+		Poco::UInt64 length;
+	};
+
 	enum class DeadlineFragment
 	{
 		Years,
@@ -174,6 +184,58 @@ namespace Burst
 	size_t getMemorySize();
 	void setStdInEcho(bool enable);
 
+	/**
+	 * \brief Returns an id of the device, on which the file or directory is stored.
+	 * \param path The path to the file or directory.
+	 * \return The device id, 0 if it could not be determined.
+	 */
+	Poco::UInt64 getDeviceId(const std::string& path);
+
+	/**
+	 * \brief Returns the extents of a file on its device.
+	 * \param path The path to the file.
+	 * \return A list of all extents ordered by their logical offset.
+	 * Empty, if the extents could not be determined.
+	 */
+	std::vector<FileExtent> getFileExtents(const std::string& path);
+
+	/**
+	 * \brief Parses a list of cpus in the format of the linux sysfs (e.g. "0-3,8,10-11").
+	 * \param cpuList The list of cpus.
+	 * \return The cpu indices in ascending order, empty if the list is invalid.
+	 */
+	std::vector<unsigned> parseCpuList(const std::string& cpuList);
+
+	/**
+	 * \brief Returns the cpus of a NUMA node.
+	 * \param node The index of the NUMA node.
+	 * \return The cpu indices of the node, empty if unknown or not supported.
+	 */
+	std::vector<unsigned> getNumaNodeCpus(unsigned node);
+
+	/**
+	 * \brief Restricts the calling thread to a set of cpus.
+	 * Memory, that is touched first by the thread afterwards, is allocated by the OS on the NUMA node of the cpus.
+	 * \param cpus The cpu indices.
+	 * \return true, if the affinity was set, false otherwise.
+	 */
+	bool setThreadAffinity(const std::vector<unsigned>& cpus);
+
+	enum class DevicePowerState
+	{
+		Unknown,
+		Active,
+		Standby
+	};
+
+	/**
+	 * \brief Returns the power state of the disk, on which a file or directory is stored.
+	 * On Linux, the runtime power management of the disk is read from sysfs.
+	 * \param path The path to the file or directory.
+	 * \return The power state, Unknown if the disk does not report it.
+	 */
+	DevicePowerState getDevicePowerState(const std::string& path);
+
 	Poco::Path getMinerHomeDir();
 	Poco::Path getMinerHomeDir(const std::string& filename);
 }
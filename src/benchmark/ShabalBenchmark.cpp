@@ -0,0 +1,302 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+// Microbenchmarks of the Shabal kernels, the nonce generation and the deadline calculation.
+// Every benchmark is repeated until it ran for a minimum time, then nonces/s and bytes/s are reported.
+//
+// usage: creepMinerBenchmark [--filter=<regex>] [--min-time=<seconds>]
+
+#include "Declarations.hpp"
+#include "MinerUtil.hpp"
+#include "plots/PlotGenerator.hpp"
+#include "plots/PlotVerifier.hpp"
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace Burst
+{
+	namespace ShabalBenchmark
+	{
+		struct Benchmark
+		{
+			std::string name;
+			bool available;
+			Poco::UInt64 noncesPerIteration;
+			Poco::UInt64 bytesPerIteration;
+			std::function<void(Poco::UInt64)> run;
+		};
+
+		// the number of scoops, that are verified in one iteration
+		constexpr size_t VerifyScoops = 4096;
+
+		// prevents the compiler from optimizing away the results of a benchmark
+		volatile Poco::UInt64 sink = 0;
+
+		GensigData createGensig()
+		{
+			GensigData gensig;
+
+			for (size_t i = 0; i < gensig.size(); ++i)
+				gensig[i] = static_cast<unsigned char>(i * 7 + 1);
+
+			return gensig;
+		}
+
+		ScoopBuffer createScoops(const size_t size)
+		{
+			std::mt19937_64 random{42};
+			ScoopBuffer scoops(size);
+
+			for (auto& scoop : scoops)
+				for (auto& byte : scoop)
+					byte = static_cast<unsigned char>(random());
+
+			return scoops;
+		}
+
+		template <typename TAlgorithm>
+		Benchmark verify(const std::string& name, const bool available)
+		{
+			return {"verify/" + name, available, VerifyScoops, VerifyScoops * Settings::ScoopSize, [](const Poco::UInt64 iterations)
+			{
+				auto scoops = createScoops(VerifyScoops);
+				const auto gensig = createGensig();
+
+				for (Poco::UInt64 i = 0; i < iterations; ++i)
+					sink += TAlgorithm::run(scoops, 0, i, 50000, gensig, []() { return false; }, nullptr).second;
+			}};
+		}
+
+		template <typename TShabal, typename TOperations>
+		Benchmark deadline96(const std::string& name, const bool available)
+		{
+			constexpr auto lanes = TShabal::HashSize;
+
+			// the gensig and one scoop, hashed from scratch for every nonce
+			return {"deadline96/" + name, available, lanes, lanes * (Settings::HashSize + Settings::ScoopSize),
+				[](const Poco::UInt64 iterations)
+			{
+				const auto scoops = createScoops(lanes);
+				auto gensig = createGensig();
+				std::array<HashData, lanes> targets;
+				std::array<const unsigned char*, lanes> gensigPtr, scoopPtr;
+				std::array<unsigned char*, lanes> targetPtr;
+
+				for (size_t i = 0; i < lanes; ++i)
+				{
+					gensigPtr[i] = gensig.data();
+					scoopPtr[i] = scoops[i].data();
+					targetPtr[i] = targets[i].data();
+				}
+
+				for (Poco::UInt64 i = 0; i < iterations; ++i)
+				{
+					TShabal shabal;
+					TOperations::update(shabal, gensigPtr, Settings::HashSize);
+					TOperations::update(shabal, scoopPtr, Settings::ScoopSize);
+					TOperations::close(shabal, targetPtr);
+					sink += targets[0][0];
+				}
+			}};
+		}
+
+		template <typename TGenerate>
+		Benchmark generateNonces(const std::string& name, const bool available, const Poco::UInt64 lanes, TGenerate generateFunction)
+		{
+			return {"generate/" + name, available, lanes, lanes * Settings::PlotSize, [generateFunction, lanes](const Poco::UInt64 iterations)
+			{
+				for (Poco::UInt64 i = 0; i < iterations; ++i)
+					sink += generateFunction(1234567890ull, i * lanes);
+			}};
+		}
+
+		template <typename TGenerate, typename TCalculate>
+		Benchmark calculateDeadline(const std::string& name, const bool available, const Poco::UInt64 lanes,
+			TGenerate generateFunction, TCalculate calculateFunction)
+		{
+			return {"calculateDeadline/" + name, available, lanes, lanes * Settings::ScoopSize,
+				[generateFunction, calculateFunction](const Poco::UInt64 iterations)
+			{
+				auto gendata = generateFunction(1234567890ull, 0);
+				auto gensig = createGensig();
+
+				for (Poco::UInt64 i = 0; i < iterations; ++i)
+					sink += calculateFunction(gendata, gensig, i % Settings::ScoopPerPlot);
+			}};
+		}
+
+		std::vector<Benchmark> createBenchmarks()
+		{
+			const auto sse4 = Settings::Sse4 && cpuHasInstructionSet(CpuInstructionSet::sse4);
+			const auto avx = Settings::Avx && cpuHasInstructionSet(CpuInstructionSet::avx);
+			const auto avx2 = Settings::Avx2 && cpuHasInstructionSet(CpuInstructionSet::avx2);
+
+			const auto sumFirst = [](const auto& results)
+			{
+				return static_cast<Poco::UInt64>(results[0]);
+			};
+
+			return {
+				verify<PlotVerifierAlgorithm_sse2>("SSE2", true),
+				verify<PlotVerifierAlgorithm_sse4>("SSE4", sse4),
+				verify<PlotVerifierAlgorithm_avx>("AVX", avx),
+				verify<PlotVerifierAlgorithm_avx2>("AVX2", avx2),
+
+				deadline96<Shabal256_SSE2, PlotGeneratorOperations1<Shabal256_SSE2>>("SSE2", true),
+				deadline96<Shabal256_SSE4, PlotGeneratorOperations4<Shabal256_SSE4>>("SSE4", sse4),
+				deadline96<Shabal256_AVX, PlotGeneratorOperations4<Shabal256_AVX>>("AVX", avx),
+				deadline96<Shabal256_AVX2, PlotGeneratorOperations8<Shabal256_AVX2>>("AVX2", avx2),
+
+				generateNonces("SSE2", true, 1, [](Poco::UInt64 account, Poco::UInt64 nonce)
+				{
+					return static_cast<Poco::UInt64>(PlotGenerator::generateSse2(account, nonce)[0]);
+				}),
+				generateNonces("SSE4", sse4, Shabal256_SSE4::HashSize, [sumFirst](Poco::UInt64 account, Poco::UInt64 nonce)
+				{
+					return sumFirst(PlotGenerator::generateSse4(account, nonce)[0]);
+				}),
+				generateNonces("AVX", avx, Shabal256_AVX::HashSize, [sumFirst](Poco::UInt64 account, Poco::UInt64 nonce)
+				{
+					return sumFirst(PlotGenerator::generateAvx(account, nonce)[0]);
+				}),
+				generateNonces("AVX2", avx2, Shabal256_AVX2::HashSize, [sumFirst](Poco::UInt64 account, Poco::UInt64 nonce)
+				{
+					return sumFirst(PlotGenerator::generateAvx2(account, nonce)[0]);
+				}),
+
+				{"convertToPoC2", true, 1, Settings::PlotSize, [](const Poco::UInt64 iterations)
+				{
+					auto gendata = PlotGenerator::generateSse2(1234567890ull, 0);
+
+					for (Poco::UInt64 i = 0; i < iterations; ++i)
+						PlotGenerator::convertToPoC2(gendata.data());
+
+					sink += static_cast<Poco::UInt64>(gendata[0]);
+				}},
+
+				calculateDeadline("SSE2", true, 1, PlotGenerator::generateSse2,
+					[](std::vector<char>& gendata, GensigData& gensig, Poco::UInt64 scoop)
+				{
+					return PlotGenerator::calculateDeadlineSse2(gendata, gensig, scoop, 50000);
+				}),
+				calculateDeadline("SSE4", sse4, Shabal256_SSE4::HashSize, PlotGenerator::generateSse4,
+					[sumFirst](std::array<std::vector<char>, Shabal256_SSE4::HashSize>& gendatas, GensigData& gensig, Poco::UInt64 scoop)
+				{
+					return sumFirst(PlotGenerator::calculateDeadlineSse4(gendatas, gensig, scoop, 50000));
+				}),
+				calculateDeadline("AVX", avx, Shabal256_AVX::HashSize, PlotGenerator::generateAvx,
+					[sumFirst](std::array<std::vector<char>, Shabal256_AVX::HashSize>& gendatas, GensigData& gensig, Poco::UInt64 scoop)
+				{
+					return sumFirst(PlotGenerator::calculateDeadlineAvx(gendatas, gensig, scoop, 50000));
+				}),
+				calculateDeadline("AVX2", avx2, Shabal256_AVX2::HashSize, PlotGenerator::generateAvx2,
+					[sumFirst](std::array<std::vector<char>, Shabal256_AVX2::HashSize>& gendatas, GensigData& gensig, Poco::UInt64 scoop)
+				{
+					return sumFirst(PlotGenerator::calculateDeadlineAvx2(gendatas, gensig, scoop, 50000));
+				})
+			};
+		}
+
+		void runBenchmark(const Benchmark& benchmark, const double minTime)
+		{
+			using Clock = std::chrono::steady_clock;
+
+			Poco::UInt64 iterations = 1;
+			auto seconds = 0.;
+
+			// double the iterations, until the benchmark runs long enough
+			while (true)
+			{
+				const auto start = Clock::now();
+				benchmark.run(iterations);
+				seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+				if (seconds >= minTime)
+					break;
+
+				iterations *= 2;
+			}
+
+			const auto nonces = static_cast<double>(iterations * benchmark.noncesPerIteration);
+			const auto bytes = static_cast<double>(iterations * benchmark.bytesPerIteration);
+
+			std::cout << std::left << std::setw(28) << benchmark.name << std::right
+				<< std::setw(12) << iterations
+				<< std::setw(14) << std::fixed << std::setprecision(1) << seconds / iterations * 1e9
+				<< std::setw(16) << std::setprecision(0) << nonces / seconds
+				<< std::setw(14) << std::setprecision(2) << bytes / seconds / 1024 / 1024
+				<< std::endl;
+		}
+	}
+}
+
+int main(const int argc, const char* argv[])
+{
+	using namespace Burst::ShabalBenchmark;
+
+	std::regex filter{".*"};
+	auto minTime = 0.5;
+
+	for (auto i = 1; i < argc; ++i)
+	{
+		const std::string argument = argv[i];
+
+		if (argument.find("--filter=") == 0)
+			filter = std::regex{argument.substr(9)};
+		else if (argument.find("--min-time=") == 0)
+			minTime = std::stod(argument.substr(11));
+		else
+		{
+			std::cout << "usage: " << argv[0] << " [--filter=<regex>] [--min-time=<seconds>]" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::cout << std::left << std::setw(28) << "benchmark" << std::right
+		<< std::setw(12) << "iterations"
+		<< std::setw(14) << "ns/iteration"
+		<< std::setw(16) << "nonces/s"
+		<< std::setw(14) << "MB/s"
+		<< std::endl
+		<< std::string(84, '-') << std::endl;
+
+	for (const auto& benchmark : createBenchmarks())
+	{
+		if (!std::regex_search(benchmark.name, filter))
+			continue;
+
+		if (!benchmark.available)
+		{
+			std::cout << std::left << std::setw(28) << benchmark.name << " not supported by this CPU or build" << std::endl;
+			continue;
+		}
+
+		runBenchmark(benchmark, minTime);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,116 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+// Encodes a sample of every binary websocket message, decodes it again and compares it with the JSON message.
+// Every field of the JSON message has to survive the round trip, otherwise binary clients get less information.
+//
+// usage: creepMinerCodecCheck
+
+#include "MinerUtil.hpp"
+#include "webserver/WebsocketCodec.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <Poco/JSON/Object.h>
+
+namespace Burst
+{
+	namespace WebsocketCodecCheck
+	{
+		std::vector<Poco::JSON::Object> createSamples()
+		{
+			Poco::JSON::Object progress, plotDirProgress, deadline;
+
+			progress.set("type", "progress");
+			progress.set("seq", Poco::UInt64{1});
+			progress.set("value", 12.5);
+			progress.set("valueVerification", 10.25);
+
+			plotDirProgress.set("type", "plotdir-progress");
+			plotDirProgress.set("seq", Poco::UInt64{2});
+			plotDirProgress.set("value", 50.);
+			plotDirProgress.set("dir", "/plots/\xc3\xa4");
+
+			// the same fields as createJsonDeadline
+			deadline.set("type", "nonce confirmed");
+			deadline.set("seq", Poco::UInt64{3});
+			deadline.set("nonce", "18446744073709551615");
+			deadline.set("deadline", deadlineFormat(1234567));
+			deadline.set("deadlineNum", "1234567");
+			deadline.set("accountId", "12345678901234567890");
+			deadline.set("blockheight", "500000");
+			deadline.set("account", "creepMiner");
+			deadline.set("plotfile", "12345678901234567890_0_8192_8192");
+			deadline.set("time", "12:34:56");
+
+			return {progress, plotDirProgress, deadline};
+		}
+
+		bool check(const Poco::JSON::Object& json)
+		{
+			const auto type = json.getValue<std::string>("type");
+			std::string binary;
+			Poco::JSON::Object decoded;
+
+			if (!WebsocketCodec::encode(json, binary))
+			{
+				std::cout << type << ": not encoded" << std::endl;
+				return false;
+			}
+
+			if (!WebsocketCodec::decode(binary, decoded))
+			{
+				std::cout << type << ": not decoded" << std::endl;
+				return false;
+			}
+
+			auto success = decoded.size() == json.size();
+
+			for (const auto& field : json)
+			{
+				const auto expected = field.second.convert<std::string>();
+				const auto found = decoded.has(field.first) ? decoded.get(field.first).convert<std::string>() : "<missing>";
+
+				if (found != expected)
+				{
+					std::cout << type << ": " << field.first << " is " << found << ", expected " << expected << std::endl;
+					success = false;
+				}
+			}
+
+			std::cout << type << ": " << (success ? "OK" : "FAILED") << std::endl;
+			return success;
+		}
+	}
+}
+
+int main()
+{
+	using namespace Burst::WebsocketCodecCheck;
+
+	auto success = true;
+
+	for (const auto& json : createSamples())
+		success = check(json) && success;
+
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "Declarations.hpp"
+#include "HugePages.hpp"
 #include "gpu/gpu_shell.hpp"
 #include "logging/Message.hpp"
 
@@ -30,7 +31,7 @@ namespace Burst
 	struct Gpu_Algorithm_Atomic
 	{
 		template <typename TGpu_Impl>
-		static bool run(std::vector<ScoopData>& scoops,
+		static bool run(ScoopBuffer& scoops,
 			const GensigData& gensig,
 			Poco::UInt64 nonceStart, Poco::UInt64 baseTarget, void* stream,
 			std::pair<Poco::UInt64, Poco::UInt64>& bestDeadline)
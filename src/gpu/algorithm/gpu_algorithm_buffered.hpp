@@ -0,0 +1,73 @@
+// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+#pragma once
+
+#include "Declarations.hpp"
+#include "HugePages.hpp"
+#include "gpu/gpu_shell.hpp"
+#include "logging/Message.hpp"
+
+namespace Burst
+{
+	/**
+	 * \brief Verifies the scoops with the memory the stream keeps on the GPU.
+	 * Other than Gpu_Algorithm_Atomic nothing is allocated or freed per chunk and
+	 * the transfers run asynchronously to the kernels.
+	 */
+	struct Gpu_Algorithm_Buffered
+	{
+		template <typename TGpu_Impl>
+		static bool run(ScoopBuffer& scoops,
+			const GensigData& gensig,
+			Poco::UInt64 nonceStart, Poco::UInt64 baseTarget, void* stream,
+			std::pair<Poco::UInt64, Poco::UInt64>& bestDeadline)
+		{
+			using shell = Gpu_Shell<TGpu_Impl>;
+
+			std::string errorString;
+			Poco::UInt64 minDeadline;
+			Poco::UInt64 minDeadlineIndex;
+
+			if (scoops.empty())
+				return true;
+
+			// upload, verify and reduce the chunk on the gpu
+			shell::verifyBuffered(scoops.data(), scoops.size(), gensig, baseTarget, minDeadline, minDeadlineIndex, stream);
+
+			// fetch the last error if there is one
+			const auto ok = !shell::getError(errorString);
+
+			if (ok)
+			{
+				bestDeadline.first = nonceStart + minDeadlineIndex;
+				bestDeadline.second = minDeadline;
+			}
+			else
+			{
+				// print the error
+				log_error(MinerLogger::plotVerifier, "Error while verifying a plot file!\n\tError: %s", errorString);
+			}
+
+			return ok;
+		}
+	};
+}
@@ -51,6 +51,18 @@ namespace Burst
 			return TImpl::initStream(std::forward<Args&&>(args)...);
 		}
 
+		/**
+		* \brief Releases a stream (queue) and everything it holds on the GPU.
+		* \tparam Args Variadic template types.
+		* \param args The arguments to release the stream.
+		* \return true, when the stream was released, false otherwise.
+		*/
+		template <typename ...Args>
+		static bool releaseStream(Args&&... args)
+		{
+			return TImpl::releaseStream(std::forward<Args&&>(args)...);
+		}
+
 		/**
 		 * \brief Allocates memory on the GPU.
 		 * \tparam Args Variadic template types.
@@ -116,6 +128,19 @@ namespace Burst
 			return TImpl::verify(std::forward<Args&&>(args)...);
 		}
 
+		/**
+		 * \brief Searches for the best deadline in a memory block on the host.
+		 * The stream keeps its memory on the GPU, so nothing is allocated per call.
+		 * \tparam Args Variadic template types.
+		 * \param args The arguments that are needed to verify the deadlines.
+		 * \return true, when there was no error, false otherwise.
+		 */
+		template <typename ...Args>
+		static bool verifyBuffered(Args&&... args)
+		{
+			return TImpl::verifyBuffered(std::forward<Args&&>(args)...);
+		}
+
 		/**
 		 * \brief Searches for the best deadline in an array of deadlines.
 		 * \tparam Args Variadic template types. 
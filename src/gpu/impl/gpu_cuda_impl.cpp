@@ -34,6 +34,11 @@ bool Burst::Gpu_Cuda_Impl::initStream(void** stream)
 	return true;
 }
 
+bool Burst::Gpu_Cuda_Impl::releaseStream(void* stream)
+{
+	return true;
+}
+
 bool Burst::Gpu_Cuda_Impl::allocateMemory(void** memory, MemoryType type, size_t size)
 {
 	useDevice(MinerConfig::getConfig().getGpuPlatform());
@@ -10,6 +10,7 @@ namespace Burst
 	struct Gpu_Cuda_Impl
 	{
 		static bool initStream(void** stream);
+		static bool releaseStream(void* stream);
 		static bool allocateMemory(void** memory, MemoryType type, size_t size);
 		static bool copyMemory(const void* input, void* output, MemoryType type, size_t size, MemoryCopyDirection direction, void* stream);
 		static bool verify(const GensigData* gpuGensig, ScoopData* gpuScoops, Poco::UInt64* gpuDeadlines, size_t nonces,
@@ -25,183 +25,337 @@
 #include <random>
 #include "logging/Message.hpp"
 #include "logging/MinerLogger.hpp"
+#include "mining/MinerConfig.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
 
 int Burst::Gpu_Opencl_Impl::lastError_ = 0;
 
-bool Burst::Gpu_Opencl_Impl::initStream(void** stream)
-{
 #ifdef USE_OPENCL
-	const auto queue = MinerCL::getCL().createCommandQueue();
-
-	if (queue == nullptr)
-		return false;
+namespace Burst
+{
+	/**
+	 * \brief One buffer set of a stream, that can be in flight while the others are filled.
+	 * The memory on the device and the pinned staging memory are kept between the chunks
+	 * and only grow, when a bigger chunk arrives.
+	 */
+	struct Gpu_Opencl_Slot
+	{
+		cl_command_queue queue = nullptr;
+		cl_kernel kernel = nullptr;
+		cl_mem staging = nullptr, scoops = nullptr, gensig = nullptr, best = nullptr;
+		ScoopData* stagingMemory = nullptr;
+		size_t capacity = 0, local = 1, groups = 1, groupsUsed = 0;
+		GensigData gensigData;
+		std::vector<Poco::UInt64> bestData;
+		Poco::UInt64 offset = 0;
+		cl_event readback = nullptr;
+	};
 
-	*stream = queue;
-#endif
-	return true;
+	struct Gpu_Opencl_Stream
+	{
+		std::vector<Gpu_Opencl_Slot> slots;
+	};
 }
+#endif
 
-bool Burst::Gpu_Opencl_Impl::allocateMemory(void** memory, MemoryType type, size_t size)
+bool Burst::Gpu_Opencl_Impl::initStream(void** stream)
 {
 #ifdef USE_OPENCL
-	cl_int ret;
+	auto& cl = MinerCL::getCL();
+	const auto slots = std::max(2u, MinerConfig::getConfig().getGpuBuffers());
+	std::unique_ptr<Gpu_Opencl_Stream> clStream(new Gpu_Opencl_Stream);
 
-	size = Gpu_Helper::calcMemorySize(type, size);
+	clStream->slots.resize(slots);
 
-	if (size <= 0)
-		return false;
+	for (auto& slot : clStream->slots)
+	{
+		cl_int ret;
+		slot.queue = cl.createCommandQueue();
 
-	const auto allocated = clCreateBuffer(MinerCL::getCL().getContext(), CL_MEM_READ_WRITE, size, nullptr, &ret);
+		if (slot.queue == nullptr)
+		{
+			releaseStream(clStream.release());
+			return false;
+		}
 
-	if (ret == CL_SUCCESS)
-	{
-		*memory = allocated;
-		return true;
+		// every stream has its own kernel, so the arguments of two verifiers do not overwrite each other
+		slot.kernel = clCreateKernel(cl.getProgram(), "calculate_best_deadline", &ret);
+
+		if (ret == CL_SUCCESS)
+			ret = clGetKernelWorkGroupInfo(slot.kernel, *cl.getDeviceId(), CL_KERNEL_WORK_GROUP_SIZE, sizeof slot.local,
+			                               &slot.local, nullptr);
+
+		// the reduction needs two words of local memory per work item
+		slot.local = std::max<size_t>(std::min<size_t>(slot.local, 256), 1);
+
+		// enough work groups to keep all compute units busy, every group delivers its best deadline
+		slot.groups = std::max<size_t>(cl.getComputeUnits(), 1) * 4;
+		slot.bestData.resize(slot.groups * 2);
+
+		if (ret != CL_SUCCESS)
+		{
+			lastError_ = ret;
+			releaseStream(clStream.release());
+			return false;
+		}
 	}
 
-	lastError_ = ret;
-	return false;
-#else
-	return true;
+	*stream = clStream.release();
 #endif
+	return true;
 }
 
 namespace Burst
 {
 	struct Gpu_Opencl_Impl_Helper
 	{
-		static size_t calcOccupancy(const size_t elements, const size_t local_optimal, const size_t local_preferred_multiply)
+#ifdef USE_OPENCL
+		static cl_command_queue getQueue(void* stream)
+		{
+			return static_cast<Gpu_Opencl_Stream*>(stream)->slots.front().queue;
+		}
+
+		static void releaseBuffers(Gpu_Opencl_Slot& slot)
+		{
+			if (slot.stagingMemory != nullptr)
+			{
+				clEnqueueUnmapMemObject(slot.queue, slot.staging, slot.stagingMemory, 0, nullptr, nullptr);
+				clFinish(slot.queue);
+				slot.stagingMemory = nullptr;
+			}
+
+			for (auto memory : {&slot.staging, &slot.scoops, &slot.gensig, &slot.best})
+			{
+				if (*memory != nullptr)
+					clReleaseMemObject(*memory);
+
+				*memory = nullptr;
+			}
+
+			slot.capacity = 0;
+		}
+
+		static cl_int reserveBuffers(Gpu_Opencl_Slot& slot, const size_t nonces)
+		{
+			if (slot.capacity >= nonces)
+				return CL_SUCCESS;
+
+			releaseBuffers(slot);
+
+			const auto context = MinerCL::getCL().getContext();
+			const auto scoopBytes = Gpu_Helper::calcMemorySize(MemoryType::Buffer, nonces);
+			cl_int ret;
+
+			// the staging memory is allocated by the runtime, so it can be pinned and transferred by dma
+			slot.staging = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, scoopBytes, nullptr, &ret);
+
+			if (ret == CL_SUCCESS)
+				slot.stagingMemory = static_cast<ScoopData*>(clEnqueueMapBuffer(slot.queue, slot.staging, CL_TRUE, CL_MAP_WRITE,
+				                                                                0, scoopBytes, 0, nullptr, nullptr, &ret));
+
+			if (ret == CL_SUCCESS)
+				slot.scoops = clCreateBuffer(context, CL_MEM_READ_ONLY, scoopBytes, nullptr, &ret);
+
+			if (ret == CL_SUCCESS)
+				slot.gensig = clCreateBuffer(context, CL_MEM_READ_ONLY, Gpu_Helper::calcMemorySize(MemoryType::Gensig, 1), nullptr, &ret);
+
+			if (ret == CL_SUCCESS)
+				slot.best = clCreateBuffer(context, CL_MEM_WRITE_ONLY, Gpu_Helper::calcMemorySize<Poco::UInt64>(slot.bestData.size()),
+				                           nullptr, &ret);
+
+			if (ret == CL_SUCCESS)
+				slot.capacity = nonces;
+			else
+				releaseBuffers(slot);
+
+			return ret;
+		}
+
+		static cl_int enqueueBatch(Gpu_Opencl_Slot& slot, const ScoopData* scoops, size_t nonces, const GensigData& gensig,
+		                           Poco::UInt64 baseTarget)
+		{
+			auto ret = reserveBuffers(slot, nonces);
+
+			if (ret != CL_SUCCESS)
+				return ret;
+
+			// while this copy runs, the device is still busy with the batch of the other slots
+			memcpy(slot.stagingMemory, scoops, Gpu_Helper::calcMemorySize(MemoryType::Buffer, nonces));
+			slot.gensigData = gensig;
+
+			ret = clEnqueueWriteBuffer(slot.queue, slot.scoops, CL_FALSE, 0, Gpu_Helper::calcMemorySize(MemoryType::Buffer, nonces),
+			                           slot.stagingMemory, 0, nullptr, nullptr);
+
+			if (ret == CL_SUCCESS)
+				ret = clEnqueueWriteBuffer(slot.queue, slot.gensig, CL_FALSE, 0, Gpu_Helper::calcMemorySize(MemoryType::Gensig, 1),
+				                           slot.gensigData.data(), 0, nullptr, nullptr);
+
+			// hash the scoops and reduce them to the best deadline of every work group
+			const cl_ulong nonceCount = nonces;
+			const cl_ulong target = baseTarget;
+			slot.groupsUsed = std::min(slot.groups, (nonces + slot.local - 1) / slot.local);
+			auto global = slot.groupsUsed * slot.local;
+
+			if (ret == CL_SUCCESS)
+				ret = clSetKernelArg(slot.kernel, 0, sizeof(cl_mem), &slot.gensig);
+
+			if (ret == CL_SUCCESS)
+				ret = clSetKernelArg(slot.kernel, 1, sizeof(cl_mem), &slot.scoops);
+
+			if (ret == CL_SUCCESS)
+				ret = clSetKernelArg(slot.kernel, 2, sizeof(cl_ulong), &nonceCount);
+
+			if (ret == CL_SUCCESS)
+				ret = clSetKernelArg(slot.kernel, 3, sizeof(cl_ulong), &target);
+
+			if (ret == CL_SUCCESS)
+				ret = clSetKernelArg(slot.kernel, 4, sizeof(cl_ulong) * slot.local, nullptr);
+
+			if (ret == CL_SUCCESS)
+				ret = clSetKernelArg(slot.kernel, 5, sizeof(cl_ulong) * slot.local, nullptr);
+
+			if (ret == CL_SUCCESS)
+				ret = clSetKernelArg(slot.kernel, 6, sizeof(cl_mem), &slot.best);
+
+			if (ret == CL_SUCCESS)
+				ret = clEnqueueNDRangeKernel(slot.queue, slot.kernel, 1, nullptr, &global, &slot.local, 0, nullptr, nullptr);
+
+			// the results are read back without blocking, the event tells when they arrived
+			if (ret == CL_SUCCESS)
+				ret = clEnqueueReadBuffer(slot.queue, slot.best, CL_FALSE, 0, Gpu_Helper::calcMemorySize<Poco::UInt64>(slot.groupsUsed * 2),
+				                          slot.bestData.data(), 0, nullptr, &slot.readback);
+
+			if (ret == CL_SUCCESS)
+				ret = clFlush(slot.queue);
+
+			return ret;
+		}
+
+		static cl_int collectBatch(Gpu_Opencl_Slot& slot, Poco::UInt64& minDeadline, Poco::UInt64& minDeadlineIndex)
 		{
-			if (local_preferred_multiply == 0 || local_optimal == 0)
-				return 1;
+			if (slot.readback == nullptr)
+				return CL_SUCCESS;
 
-			auto local = local_optimal;
+			const auto ret = clWaitForEvents(1, &slot.readback);
 
-			for (auto i = local / local_preferred_multiply; i > 0 && local == local_optimal; i--)
-				if (fmod(elements, i * local_preferred_multiply) == 0.f)
-					local = i * local_preferred_multiply;
+			clReleaseEvent(slot.readback);
+			slot.readback = nullptr;
 
-			if (local == local_optimal)
-				local = 1;
+			// the best deadlines of the work groups are reduced here
+			for (size_t i = 0; ret == CL_SUCCESS && i < slot.groupsUsed; ++i)
+			{
+				if (slot.bestData[i * 2 + 1] < minDeadline)
+				{
+					minDeadlineIndex = slot.offset + slot.bestData[i * 2];
+					minDeadline = slot.bestData[i * 2 + 1];
+				}
+			}
 
-			return local;
+			return ret;
 		}
+#endif
 	};
 }
 
-bool Burst::Gpu_Opencl_Impl::verify(const GensigData* gpuGensig, ScoopData* gpuScoops, Poco::UInt64* gpuDeadlines,
-	size_t nonces, Poco::UInt64 nonceStart, Poco::UInt64 baseTarget, void* stream)
+bool Burst::Gpu_Opencl_Impl::releaseStream(void* stream)
 {
 #ifdef USE_OPENCL
-	auto ret = clSetKernelArg(MinerCL::getCL().getKernel_Calculate(), 0, sizeof(cl_mem), &gpuGensig);
-
-	if (ret == CL_SUCCESS)
-		ret = clSetKernelArg(MinerCL::getCL().getKernel_Calculate(), 1, sizeof(cl_mem), &gpuScoops);
+	const auto clStream = static_cast<Gpu_Opencl_Stream*>(stream);
 
-	if (ret == CL_SUCCESS)
-		ret = clSetKernelArg(MinerCL::getCL().getKernel_Calculate(), 2, sizeof(cl_mem), &gpuDeadlines);
-
-	if (ret == CL_SUCCESS)
-		ret = clSetKernelArg(MinerCL::getCL().getKernel_Calculate(), 3, sizeof(cl_ulong), reinterpret_cast<const void*>(&nonces));
-	
-	if (ret == CL_SUCCESS)
-		ret = clSetKernelArg(MinerCL::getCL().getKernel_Calculate(), 4, sizeof(cl_ulong), reinterpret_cast<const void*>(&baseTarget));
+	if (clStream == nullptr)
+		return true;
 
-	if (ret != CL_SUCCESS)
-		return false;
+	for (auto& slot : clStream->slots)
+	{
+		if (slot.queue != nullptr)
+			clFinish(slot.queue);
 
-	auto local = Gpu_Opencl_Impl_Helper::calcOccupancy(nonces, MinerCL::getCL().getKernelCalculateWorkGroupSize(),
-	                                                   MinerCL::getCL().getKernelCalculateWorkGroupSize(true));
+		if (slot.readback != nullptr)
+			clReleaseEvent(slot.readback);
 
-	ret = clEnqueueNDRangeKernel(static_cast<cl_command_queue>(stream), MinerCL::getCL().getKernel_Calculate(), 1, nullptr,
-	                             &nonces, &local, 0, nullptr, nullptr);
+		Gpu_Opencl_Impl_Helper::releaseBuffers(slot);
 
-	if (ret != CL_SUCCESS)
-	{
-		lastError_ = ret;
-		return false;
+		if (slot.kernel != nullptr)
+			clReleaseKernel(slot.kernel);
 	}
+
+	// the queues belong to MinerCL and are released there
+	delete clStream;
 #endif
 	return true;
 }
 
-bool Burst::Gpu_Opencl_Impl::getMinDeadline(Poco::UInt64* gpuDeadlines, size_t size, Poco::UInt64& minDeadline, Poco::UInt64& minDeadlineIndex, void* stream)
+bool Burst::Gpu_Opencl_Impl::allocateMemory(void** memory, MemoryType type, size_t size)
 {
 #ifdef USE_OPENCL
-	auto errorCode = CL_SUCCESS;
-	Poco::UInt64* gpuBestMemory;
+	cl_int ret;
 
-	//auto global = size;
-	//const auto preferred_local_size = MinerCL::getCL().getKernelFindBestWorkGroupSize(true);
+	size = Gpu_Helper::calcMemorySize(type, size);
 
-	//if (global % preferred_local_size != 0)
-	//	global = (global / preferred_local_size + 1) * preferred_local_size;
+	if (size <= 0)
+		return false;
 
-	//auto local = Gpu_Opencl_Impl_Helper::calcOccupancy(size, MinerCL::getCL().getKernelFindBestWorkGroupSize(),
-	//                                                   MinerCL::getCL().getKernelFindBestWorkGroupSize(true));
+	const auto allocated = clCreateBuffer(MinerCL::getCL().getContext(), CL_MEM_READ_WRITE, size, nullptr, &ret);
 
-	//auto local = MinerCL::getCL().getComputeUnits() * MinerCL::getCL().getKernelFindBestWorkGroupSize(true);
+	if (ret == CL_SUCCESS)
+	{
+		*memory = allocated;
+		return true;
+	}
 
-	//local = MinerCL::getCL().getKernelFindBestWorkGroupSize();
-	//global = local * 4;
+	lastError_ = ret;
+	return false;
+#else
+	return true;
+#endif
+}
 
-	auto local = MinerCL::getCL().getKernelFindBestWorkGroupSize();
-	auto global = local;
+bool Burst::Gpu_Opencl_Impl::verifyBuffered(const ScoopData* scoops, size_t nonces, const GensigData& gensig,
+	Poco::UInt64 baseTarget, Poco::UInt64& minDeadline, Poco::UInt64& minDeadlineIndex, void* stream)
+{
+#ifdef USE_OPENCL
+	auto& slots = static_cast<Gpu_Opencl_Stream*>(stream)->slots;
 
-	const auto reduction_groups = global / local;
-	const auto reduction_group_size = 2;
-	const auto reduction_group_bytes = reduction_group_size * sizeof(Poco::UInt64);
-	const auto reduction_groups_size = reduction_groups * reduction_group_size;
-	const auto reduction_groups_bytes = reduction_groups * reduction_group_bytes;
+	// the chunk is split into one batch per slot, so the upload of one batch
+	// overlaps the kernels of the batch before
+	const auto batchSize = (nonces + slots.size() - 1) / slots.size();
+	auto ret = CL_SUCCESS;
 
-	if (!allocateMemory(reinterpret_cast<void**>(&gpuBestMemory), MemoryType::Bytes, reduction_groups_bytes))
-		return false;
+	minDeadline = std::numeric_limits<Poco::UInt64>::max();
+	minDeadlineIndex = 0;
 
-	auto ret = true;
-	ret = ret && (errorCode = clSetKernelArg(MinerCL::getCL().getKernel_GetMin(), 0, sizeof(cl_mem), &gpuDeadlines)) == CL_SUCCESS;
-	ret = ret && (errorCode = clSetKernelArg(MinerCL::getCL().getKernel_GetMin(), 1, sizeof(cl_uint), &size)) == CL_SUCCESS;
-	ret = ret && (errorCode = clSetKernelArg(MinerCL::getCL().getKernel_GetMin(), 2, sizeof(cl_uint) * local, nullptr)) == CL_SUCCESS;
-	ret = ret && (errorCode = clSetKernelArg(MinerCL::getCL().getKernel_GetMin(), 3, sizeof(cl_ulong) * local, nullptr)) == CL_SUCCESS;
-	ret = ret && (errorCode = clSetKernelArg(MinerCL::getCL().getKernel_GetMin(), 4, sizeof(cl_mem), &gpuBestMemory)) == CL_SUCCESS;
-
-	ret = ret && (errorCode = clEnqueueNDRangeKernel(static_cast<cl_command_queue>(stream),
-	                                                 MinerCL::getCL().getKernel_GetMin(), 1, nullptr,
-	                                                 &global, &local, 0, nullptr, nullptr)) == CL_SUCCESS;
-
-	ret = ret && (errorCode = clEnqueueReadBuffer(static_cast<cl_command_queue>(stream), cl_mem(gpuBestMemory), CL_TRUE,
-	                                              0, sizeof(Poco::UInt64), &minDeadlineIndex, 0,
-	                                              nullptr, nullptr)) == CL_SUCCESS;
-
-	ret = ret && (errorCode = clEnqueueReadBuffer(static_cast<cl_command_queue>(stream), cl_mem(gpuBestMemory), CL_TRUE,
-	                                              sizeof(Poco::UInt64), sizeof(Poco::UInt64), &minDeadline, 0,
-	                                              nullptr, nullptr)) == CL_SUCCESS;
-	
-	std::vector<Poco::UInt64> bestMemory(reduction_groups_size);
-
-	// only needed when global == local * N; N > 1
-	/*copyMemory(gpuBestMemory, bestMemory.data(), MemoryType::Bytes, reduction_groups_bytes, MemoryCopyDirection::ToHost, stream);
-	
-	for (auto i = 0; i < reduction_groups_size; ++i)
+	for (size_t offset = 0, i = 0; offset < nonces && ret == CL_SUCCESS; offset += batchSize, ++i)
 	{
-		if (i % 2 == 0)
-		{
-			if (minDeadline > bestMemory[i] || i == 0)
-			{
-				minDeadlineIndex = bestMemory[i + 0];
-				minDeadline = bestMemory[i + 1];
-			}
-		}
-	}*/
+		auto& slot = slots[i % slots.size()];
 
-	if (!ret)
-		lastError_ = errorCode;
+		// the slot is reused only after its last batch is done
+		ret = Gpu_Opencl_Impl_Helper::collectBatch(slot, minDeadline, minDeadlineIndex);
 
-	freeMemory(gpuBestMemory);
+		slot.offset = offset;
 
-	return ret;
-#else
-	return true;
+		if (ret == CL_SUCCESS)
+			ret = Gpu_Opencl_Impl_Helper::enqueueBatch(slot, scoops + offset, std::min(batchSize, nonces - offset), gensig, baseTarget);
+	}
+
+	// wait for the batches that are still in flight
+	for (auto& slot : slots)
+	{
+		const auto collected = Gpu_Opencl_Impl_Helper::collectBatch(slot, minDeadline, minDeadlineIndex);
+
+		if (ret == CL_SUCCESS)
+			ret = collected;
+	}
+
+	if (ret != CL_SUCCESS)
+	{
+		lastError_ = ret;
+		return false;
+	}
 #endif
+	return true;
 }
 
 bool Burst::Gpu_Opencl_Impl::freeMemory(void* memory)
@@ -311,7 +465,7 @@ bool Burst::Gpu_Opencl_Impl::copyMemory(const void* input, void* output, MemoryT
 
 	if (direction == MemoryCopyDirection::ToDevice)
 	{
-		const auto ret = clEnqueueWriteBuffer(static_cast<cl_command_queue>(stream), cl_mem(output), CL_TRUE, 0, size, input, 0,
+		const auto ret = clEnqueueWriteBuffer(Gpu_Opencl_Impl_Helper::getQueue(stream), cl_mem(output), CL_TRUE, 0, size, input, 0,
 		                                      nullptr, nullptr);
 
 		if (ret == CL_SUCCESS)
@@ -323,7 +477,7 @@ bool Burst::Gpu_Opencl_Impl::copyMemory(const void* input, void* output, MemoryT
 
 	if (direction == MemoryCopyDirection::ToHost)
 	{
-		const auto ret = clEnqueueReadBuffer(static_cast<cl_command_queue>(stream), cl_mem(input), CL_TRUE, 0, size, output, 0,
+		const auto ret = clEnqueueReadBuffer(Gpu_Opencl_Impl_Helper::getQueue(stream), cl_mem(input), CL_TRUE, 0, size, output, 0,
 		                                     nullptr, nullptr);
 
 		if (ret == CL_SUCCESS)
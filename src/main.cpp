@@ -45,8 +45,14 @@
 #include <Poco/File.h>
 #include <Poco/DirectoryIterator.h>
 #include <regex>
+#include <Poco/NumberParser.h>
 #include <Poco/Data/SQLite/Connector.h>
 #include "MinerUtil.hpp"
+#include "mining/Benchmark.hpp"
+#include "mining/GoldenRound.hpp"
+#include "network/LoadGenerator.hpp"
+#include "webserver/StubPool.hpp"
+#include <thread>
 
 class SslInitializer
 {
@@ -70,15 +76,103 @@ struct Arguments
 
 	bool helpRequested = false;
 	std::string confPath = "mining.conf";
+	bool benchmark = false;
+	unsigned benchmarkRounds = 0;
+	std::string recordPath;
+	std::string replayPath;
+	std::string stubPoolPath;
+	std::string loadTestPath;
+
+	/**
+	 * \brief Checks, if the miner runs offline rounds instead of mining.
+	 * \return true, if a benchmark runs or a golden round is recorded or replayed.
+	 */
+	bool isOffline() const;
+
+	/**
+	 * \brief Checks, if a stub pool or a load generator runs instead of the miner.
+	 * \return true, if one of the load test scripts is set.
+	 */
+	bool isLoadTest() const;
 
 private:
 	void displayHelp(const std::string& name, const std::string& value);
 	void setConfPath(const std::string& name, const std::string& value);
+	void setBenchmark(const std::string& name, const std::string& value);
+	void setRecordPath(const std::string& name, const std::string& value);
+	void setReplayPath(const std::string& name, const std::string& value);
+	void setStubPoolPath(const std::string& name, const std::string& value);
+	void setLoadTestPath(const std::string& name, const std::string& value);
 
 private:
 	Poco::Util::OptionSet options_;
 };
 
+bool runOffline(const Arguments& arguments)
+{
+	auto& config = Burst::MinerConfig::getConfig();
+
+	// the offline rounds must not end up in the block history
+	config.setDatabasePath(":memory:");
+	config.checkPlotOverlaps();
+
+	if (!arguments.recordPath.empty())
+		return Burst::GoldenRound::record(arguments.recordPath);
+
+	if (!arguments.replayPath.empty())
+		return Burst::GoldenRound::replay(arguments.replayPath);
+
+	if (arguments.benchmarkRounds > 0)
+		config.setBenchmarkRounds(arguments.benchmarkRounds);
+
+	Burst::Miner miner;
+	Burst::Benchmark benchmark{config.getBenchmarkRounds()};
+
+	Burst::MinerLogger::setChannelMinerData(&miner.getData());
+	const auto success = benchmark.run(miner) && benchmark.writeReport(config.getBenchmarkReportPath());
+	Burst::MinerLogger::setChannelMinerData(nullptr);
+
+	return success;
+}
+
+bool runLoadTest(const Arguments& arguments)
+{
+	Burst::StubPool stubPool;
+	Burst::LoadGenerator loadGenerator;
+
+	if (!arguments.stubPoolPath.empty() && !stubPool.load(arguments.stubPoolPath))
+		return false;
+
+	if (!arguments.loadTestPath.empty() && !loadGenerator.load(arguments.loadTestPath))
+		return false;
+
+	if (arguments.loadTestPath.empty())
+		return stubPool.run();
+
+	// with both scripts the stub pool serves the simulated miners of this process
+	std::thread stubPoolThread;
+
+	if (!arguments.stubPoolPath.empty())
+	{
+		stubPoolThread = std::thread{[&stubPool] { stubPool.run(); }};
+
+		// the simulated miners must not run against a stub pool, that is not listening (yet)
+		if (!stubPool.waitStarted())
+		{
+			stubPoolThread.join();
+			return false;
+		}
+	}
+
+	loadGenerator.run();
+	stubPool.stop();
+
+	if (stubPoolThread.joinable())
+		stubPoolThread.join();
+
+	return loadGenerator.writeReport();
+}
+
 int main(const int argc, const char* argv[])
 {
 	poco_ndc(main);
@@ -128,6 +222,8 @@ int main(const int argc, const char* argv[])
 	log_information(general, "Burst :   BURST-JBKL-ZUAV-UXMB-2G795");
 	log_information(general, "----------------------------------------------");
 
+	auto exitCode = EXIT_SUCCESS;
+
 	try
 	{
 		using namespace Poco;
@@ -144,13 +240,25 @@ int main(const int argc, const char* argv[])
 		HTTPSSessionInstantiator::registerInstantiator();
 
 		// start versionChecker timer thread , checking online version every 30 minutes
+		// (offline rounds run without any network)
 		Timer checkVersionTimer(100, 1800000);
-		checkVersionTimer.start(Poco::TimerCallback<Burst::ProjectData>(Burst::Settings::Project, &Burst::ProjectData::refreshAndCheckOnlineVersion));
+
+		if (!arguments.isOffline() && !arguments.isLoadTest())
+			checkVersionTimer.start(Poco::TimerCallback<Burst::ProjectData>(Burst::Settings::Project, &Burst::ProjectData::refreshAndCheckOnlineVersion));
 
 		auto running = true;
 		
 		Data::SQLite::Connector::registerConnector();
 
+		// the load test tools work without a miner config
+		if (arguments.isLoadTest())
+		{
+			if (!runLoadTest(arguments))
+				exitCode = EXIT_FAILURE;
+
+			running = false;
+		}
+
 		while (running)
 		{
 			// load the config
@@ -218,7 +326,8 @@ int main(const int argc, const char* argv[])
 					SSLManager::instance().initializeServer(privateKeyPassphraseHandler, ptrCert, serverContext);
 				}
 
-				if (Burst::MinerConfig::getConfig().getProcessorType() == "OPENCL" &&
+				if ((Burst::MinerConfig::getConfig().getProcessorType() == "OPENCL" ||
+					Burst::MinerConfig::getConfig().getProcessorType() == "HYBRID") &&
 					!Burst::MinerCL::getCL().initialized())
 					Burst::MinerCL::getCL().create(Burst::MinerConfig::getConfig().getGpuPlatform(),
 						Burst::MinerConfig::getConfig().getGpuDevice());
@@ -228,6 +337,14 @@ int main(const int argc, const char* argv[])
 					Burst::Gpu_Cuda_Impl::useDevice(Burst::MinerConfig::getConfig().getGpuDevice());
 				}
 
+				if (arguments.isOffline())
+				{
+					if (!runOffline(arguments))
+						exitCode = EXIT_FAILURE;
+
+					break;
+				}
+
 				Burst::Miner miner;
 				Burst::MinerServer server{miner};
 
@@ -260,10 +377,12 @@ int main(const int argc, const char* argv[])
 	{
 		log_fatal(general, "Aborting program due to exceptional state: %s", exc.displayText());
 		log_exception(general, exc);
+		exitCode = EXIT_FAILURE;
 	}
 	catch (std::exception& exc)
 	{
 		log_fatal(general, "Aborting program due to exceptional state: %s", std::string(exc.what()));
+		exitCode = EXIT_FAILURE;
 	}
 
 	// wake up all message dispatcher
@@ -273,7 +392,7 @@ int main(const int argc, const char* argv[])
 	Poco::ThreadPool::defaultPool().stopAll();
 	Poco::ThreadPool::defaultPool().joinAll();
 
-	return 0;
+	return exitCode;
 }
 
 SslInitializer::SslInitializer()
@@ -303,6 +422,49 @@ Arguments::Arguments()
 		.repeatable(false)
 		.argument("path")
 		.callback(Poco::Util::OptionCallback<Arguments>(this, &Arguments::setConfPath)));
+
+	options_.addOption(Option("bench", "b", "Mines a number of offline rounds with fixed block data\n"
+		"against the plot files of the config and writes a JSON report.\n"
+		"The block data and the report path are set in the benchmark section of the config.\n"
+		"e.g. --bench=10")
+		.required(false)
+		.repeatable(false)
+		.argument("rounds", false)
+		.callback(Poco::Util::OptionCallback<Arguments>(this, &Arguments::setBenchmark)));
+
+	options_.addOption(Option("record", "", "Mines one offline round with the block data of the benchmark\n"
+		"section and saves its inputs and deadlines as golden round.\n"
+		"e.g. --record=golden.json")
+		.required(false)
+		.repeatable(false)
+		.argument("path")
+		.callback(Poco::Util::OptionCallback<Arguments>(this, &Arguments::setRecordPath)));
+
+	options_.addOption(Option("replay", "", "Replays a golden round with every available verifier\n"
+		"and fails, if one of them finds other deadlines.\n"
+		"A config for OPENCL or HYBRID fails, if the OpenCL device is missing.\n"
+		"e.g. --replay=golden.json")
+		.required(false)
+		.repeatable(false)
+		.argument("path")
+		.callback(Poco::Util::OptionCallback<Arguments>(this, &Arguments::setReplayPath)));
+
+	options_.addOption(Option("stub-pool", "", "Starts a local stub pool and wallet, that plays the blocks of a script\n"
+		"and answers nonce submissions with scripted latency and errors.\n"
+		"e.g. --stub-pool=stubpool.json")
+		.required(false)
+		.repeatable(false)
+		.argument("path")
+		.callback(Poco::Util::OptionCallback<Arguments>(this, &Arguments::setStubPoolPath)));
+
+	options_.addOption(Option("load-test", "", "Simulates the downstream miners of a script against a pool or proxy\n"
+		"and writes their request latencies and throughput as JSON report.\n"
+		"Together with --stub-pool the stub pool runs in the same process.\n"
+		"e.g. --load-test=loadtest.json")
+		.required(false)
+		.repeatable(false)
+		.argument("path")
+		.callback(Poco::Util::OptionCallback<Arguments>(this, &Arguments::setLoadTestPath)));
 }
 
 bool Arguments::process(const int argc, const char* argv[])
@@ -361,6 +523,44 @@ void Arguments::setConfPath(const std::string& name, const std::string& value)
 	confPath = value;
 }
 
+bool Arguments::isOffline() const
+{
+	return benchmark || !recordPath.empty() || !replayPath.empty();
+}
+
+void Arguments::setRecordPath(const std::string& name, const std::string& value)
+{
+	recordPath = value;
+}
+
+void Arguments::setReplayPath(const std::string& name, const std::string& value)
+{
+	replayPath = value;
+}
+
+bool Arguments::isLoadTest() const
+{
+	return !stubPoolPath.empty() || !loadTestPath.empty();
+}
+
+void Arguments::setStubPoolPath(const std::string& name, const std::string& value)
+{
+	stubPoolPath = value;
+}
+
+void Arguments::setLoadTestPath(const std::string& name, const std::string& value)
+{
+	loadTestPath = value;
+}
+
+void Arguments::setBenchmark(const std::string& name, const std::string& value)
+{
+	benchmark = true;
+
+	if (!value.empty())
+		benchmarkRounds = Poco::NumberParser::parseUnsigned(value);
+}
+
 KeyConfigHandler::KeyConfigHandler(bool server)
 	: PrivateKeyPassphraseHandler{server}
 {}
@@ -0,0 +1,355 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+#include "Benchmark.hpp"
+#include "Miner.hpp"
+#include "MinerConfig.hpp"
+#include "MinerUtil.hpp"
+#include "logging/MinerLogger.hpp"
+#include "plots/PlotReader.hpp"
+#include "plots/VerifierBalance.hpp"
+#include <algorithm>
+#include <cmath>
+#include <Poco/Delegate.h>
+#include <Poco/FileStream.h>
+#include <Poco/JSON/Object.h>
+#include <Poco/JSON/Array.h>
+#include <Poco/NumberFormatter.h>
+
+namespace
+{
+	// the time a round may take, before the benchmark gives up: one minute plus one second per MiB of scoops
+	long getRoundTimeout(const Poco::UInt64 plotSize)
+	{
+		return static_cast<long>(60 * 1000 + plotSize / Burst::Settings::ScoopPerPlot / 1024);
+	}
+}
+
+std::atomic<bool> Burst::RoundStats::active_{false};
+std::array<std::atomic<Poco::UInt64>, Burst::RoundStats::StageCount> Burst::RoundStats::time_;
+std::array<std::atomic<Poco::UInt64>, Burst::RoundStats::StageCount> Burst::RoundStats::bytes_;
+std::array<std::atomic<Poco::UInt64>, Burst::RoundStats::StageCount> Burst::RoundStats::count_;
+
+void Burst::RoundStats::setActive(const bool active)
+{
+	active_ = active;
+}
+
+bool Burst::RoundStats::isActive()
+{
+	return active_;
+}
+
+void Burst::RoundStats::reset()
+{
+	for (size_t i = 0; i < StageCount; ++i)
+	{
+		time_[i] = 0;
+		bytes_[i] = 0;
+		count_[i] = 0;
+	}
+}
+
+void Burst::RoundStats::add(const Stage stage, const Poco::UInt64 microseconds, const Poco::UInt64 bytes)
+{
+	const auto index = static_cast<size_t>(stage);
+	time_[index] += microseconds;
+	bytes_[index] += bytes;
+	++count_[index];
+}
+
+Poco::UInt64 Burst::RoundStats::getTime(const Stage stage)
+{
+	return time_[static_cast<size_t>(stage)];
+}
+
+Poco::UInt64 Burst::RoundStats::getBytes(const Stage stage)
+{
+	return bytes_[static_cast<size_t>(stage)];
+}
+
+Poco::UInt64 Burst::RoundStats::getCount(const Stage stage)
+{
+	return count_[static_cast<size_t>(stage)];
+}
+
+std::string Burst::RoundStats::getName(const Stage stage)
+{
+	switch (stage)
+	{
+	case Stage::ReadQueue: return "readQueue";
+	case Stage::Allocation: return "allocation";
+	case Stage::Read: return "read";
+	case Stage::VerifyQueue: return "verifyQueue";
+	case Stage::Verify: return "verify";
+	default: return "";
+	}
+}
+
+Burst::Benchmark::Benchmark(const unsigned rounds)
+	: rounds_{rounds}, awaitedHeight_{0}
+{
+}
+
+bool Burst::Benchmark::run(Miner& miner)
+{
+	poco_ndc(Benchmark::run);
+
+	auto& config = MinerConfig::getConfig();
+
+	if (config.getPlotFiles().empty())
+	{
+		log_error(MinerLogger::miner, "There are no plot files to benchmark!");
+		return false;
+	}
+
+	results_.clear();
+	RoundStats::setActive(true);
+	miner.roundProcessed += Poco::delegate(this, &Benchmark::onRoundProcessed);
+	miner.runOffline();
+
+	log_information(MinerLogger::miner, "Benchmarking %u rounds with %s of plot files...", rounds_,
+		memToString(config.getTotalPlotsize(), 2));
+
+	for (auto i = 0u; i < rounds_; ++i)
+	{
+		const auto height = config.getBenchmarkHeight() + i;
+
+		roundProcessed_.reset();
+		awaitedHeight_ = height;
+		RoundStats::reset();
+
+		miner.updateGensig(config.getBenchmarkGensig(), height, config.getBenchmarkBaseTarget());
+
+		// a round, that never finishes (e.g. after a crashed reader), fails the benchmark instead of hanging it
+		const auto timeout = getRoundTimeout(config.getTotalPlotsize());
+
+		if (!roundProcessed_.tryWait(timeout))
+		{
+			log_error(MinerLogger::miner, "Benchmark round %u/%u did not finish within %lds!", i + 1, rounds_, timeout / 1000);
+			break;
+		}
+
+		const auto block = miner.getData().getBlockData();
+
+		if (block == nullptr)
+			break;
+
+		Round round;
+		round.height = height;
+		round.scoop = block->getScoop();
+		round.roundTime = block->getRoundTime();
+		round.gpuShare = VerifierBalance::isActive() ? VerifierBalance::getGpuShare() : 0.;
+
+		for (size_t stage = 0; stage < RoundStats::StageCount; ++stage)
+		{
+			round.stageTime[stage] = RoundStats::getTime(static_cast<RoundStats::Stage>(stage));
+			round.stageBytes[stage] = RoundStats::getBytes(static_cast<RoundStats::Stage>(stage));
+			round.stageCount[stage] = RoundStats::getCount(static_cast<RoundStats::Stage>(stage));
+		}
+
+		block->forDeadlines([&round](const Deadline& deadline)
+		{
+			auto iter = round.bestDeadlines.find(deadline.getAccountId());
+
+			if (iter == round.bestDeadlines.end() || deadline.getDeadline() < iter->second.second)
+				round.bestDeadlines[deadline.getAccountId()] = std::make_pair(deadline.getNonce(), deadline.getDeadline());
+
+			return true;
+		});
+
+		results_.emplace_back(round);
+
+		log_information(MinerLogger::miner, "Benchmark round %u/%u done in %ss", i + 1, rounds_,
+			Poco::NumberFormatter::format(round.roundTime, 3));
+	}
+
+	miner.stop();
+	miner.roundProcessed -= Poco::delegate(this, &Benchmark::onRoundProcessed);
+	RoundStats::setActive(false);
+
+	return results_.size() == rounds_;
+}
+
+bool Burst::Benchmark::writeReport(const std::string& path) const
+{
+	const auto megabytesPerSecond = [](const Poco::UInt64 bytes, const double seconds)
+	{
+		return seconds > 0. ? bytes / 1024. / 1024. / seconds : 0.;
+	};
+
+	Poco::JSON::Object report;
+	Poco::JSON::Array rounds;
+	std::vector<double> roundTimes;
+	std::array<Poco::UInt64, RoundStats::StageCount> stageTime{}, stageBytes{}, stageCount{};
+	auto totalTime = 0.;
+
+	report.set("version", Settings::Project.getVersion());
+	report.set("processorType", MinerConfig::getConfig().getProcessorType());
+	report.set("instructionSet", MinerConfig::getConfig().getCpuInstructionSet());
+	report.set("plotReaders", MinerConfig::getConfig().getMaxPlotReaders());
+	report.set("intensity", MinerConfig::getConfig().getMiningIntensity());
+	report.set("bufferSize", MinerConfig::getConfig().getMaxBufferSize());
+	report.set("plotSize", static_cast<Poco::UInt64>(MinerConfig::getConfig().getTotalPlotsize()));
+	report.set("gensig", MinerConfig::getConfig().getBenchmarkGensig());
+	report.set("baseTarget", MinerConfig::getConfig().getBenchmarkBaseTarget());
+
+	for (const auto& round : results_)
+	{
+		Poco::JSON::Object roundJson;
+		Poco::JSON::Object stagesJson;
+		Poco::JSON::Array deadlines;
+
+		roundJson.set("height", round.height);
+		roundJson.set("scoop", round.scoop);
+		roundJson.set("roundTime", round.roundTime);
+
+		for (size_t stage = 0; stage < RoundStats::StageCount; ++stage)
+		{
+			Poco::JSON::Object stageJson;
+			const auto seconds = round.stageTime[stage] / 1000. / 1000.;
+
+			stageJson.set("seconds", seconds);
+			stageJson.set("bytes", round.stageBytes[stage]);
+			stageJson.set("count", round.stageCount[stage]);
+
+			if (round.stageBytes[stage] > 0)
+			{
+				// the throughput of the stage while it was working and the rate seen by the whole round
+				stageJson.set("throughput", megabytesPerSecond(round.stageBytes[stage], seconds));
+				stageJson.set("rate", megabytesPerSecond(round.stageBytes[stage], round.roundTime));
+			}
+
+			stagesJson.set(RoundStats::getName(static_cast<RoundStats::Stage>(stage)), stageJson);
+
+			stageTime[stage] += round.stageTime[stage];
+			stageBytes[stage] += round.stageBytes[stage];
+			stageCount[stage] += round.stageCount[stage];
+		}
+
+		for (const auto& bestDeadline : round.bestDeadlines)
+		{
+			Poco::JSON::Object deadline;
+			deadline.set("account", bestDeadline.first);
+			deadline.set("nonce", bestDeadline.second.first);
+			deadline.set("deadline", bestDeadline.second.second);
+			deadlines.add(deadline);
+		}
+
+		roundJson.set("stages", stagesJson);
+		roundJson.set("bestDeadlines", deadlines);
+		rounds.add(roundJson);
+
+		roundTimes.emplace_back(round.roundTime);
+		totalTime += round.roundTime;
+	}
+
+	// the round times as nearest rank percentiles
+	{
+		Poco::JSON::Object roundTimeJson;
+		std::sort(roundTimes.begin(), roundTimes.end());
+
+		const auto percentile = [&roundTimes](const double p)
+		{
+			if (roundTimes.empty())
+				return 0.;
+
+			const auto rank = static_cast<size_t>(std::ceil(p / 100. * roundTimes.size()));
+			return roundTimes[std::max(rank, size_t{1}) - 1];
+		};
+
+		roundTimeJson.set("min", roundTimes.empty() ? 0. : roundTimes.front());
+		roundTimeJson.set("max", roundTimes.empty() ? 0. : roundTimes.back());
+		roundTimeJson.set("avg", roundTimes.empty() ? 0. : totalTime / roundTimes.size());
+		roundTimeJson.set("p50", percentile(50));
+		roundTimeJson.set("p90", percentile(90));
+		roundTimeJson.set("p99", percentile(99));
+
+		report.set("roundTime", roundTimeJson);
+	}
+
+	// the stages summed up over all rounds
+	{
+		Poco::JSON::Object stagesJson;
+
+		for (size_t stage = 0; stage < RoundStats::StageCount; ++stage)
+		{
+			Poco::JSON::Object stageJson;
+			const auto seconds = stageTime[stage] / 1000. / 1000.;
+
+			stageJson.set("seconds", seconds);
+			stageJson.set("bytes", stageBytes[stage]);
+			stageJson.set("count", stageCount[stage]);
+
+			if (stageCount[stage] > 0)
+				stageJson.set("avgSeconds", seconds / stageCount[stage]);
+
+			if (stageBytes[stage] > 0)
+			{
+				stageJson.set("throughput", megabytesPerSecond(stageBytes[stage], seconds));
+				stageJson.set("rate", megabytesPerSecond(stageBytes[stage], totalTime));
+			}
+
+			stagesJson.set(RoundStats::getName(static_cast<RoundStats::Stage>(stage)), stageJson);
+		}
+
+		report.set("stages", stagesJson);
+	}
+
+	report.set("rounds", rounds);
+
+	// how many of the chunk buffers got hugepages
+	{
+		Poco::JSON::Object hugePagesJson;
+		hugePagesJson.set("mode", HugePages::toString(HugePages::getMode()));
+		hugePagesJson.set("allocations", HugePages::getAllocations());
+		hugePagesJson.set("hugetlb", HugePages::getHugeTlbAllocations());
+		hugePagesJson.set("advised", HugePages::getAdvisedAllocations());
+		hugePagesJson.set("hitRate", HugePages::getHitRate());
+		hugePagesJson.set("transparentBytes", HugePages::getTransparentBytes());
+		report.set("hugePages", hugePagesJson);
+	}
+
+	try
+	{
+		Poco::FileStream reportStream{path, std::ios_base::out | std::ios::trunc};
+		report.stringify(reportStream, 4);
+		reportStream << std::endl;
+		log_success(MinerLogger::miner, "Wrote benchmark report into %s", path);
+		return true;
+	}
+	catch (...)
+	{
+		log_error(MinerLogger::miner, "Could not write benchmark report into %s!", path);
+		return false;
+	}
+}
+
+const std::vector<Burst::Benchmark::Round>& Burst::Benchmark::getResults() const
+{
+	return results_;
+}
+
+void Burst::Benchmark::onRoundProcessed(const void* sender, Poco::UInt64& blockHeight)
+{
+	if (blockHeight == awaitedHeight_)
+		roundProcessed_.set();
+}
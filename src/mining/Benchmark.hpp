@@ -0,0 +1,177 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+#include <Poco/Event.h>
+#include <Poco/Types.h>
+
+namespace Burst
+{
+	class Miner;
+
+	/**
+	 * \brief Sums up the time and the bytes, that the stages of a mining round need.
+	 * The stages are only measured, when the measurement is active.
+	 */
+	class RoundStats
+	{
+	public:
+		enum class Stage
+		{
+			ReadQueue,
+			Allocation,
+			Read,
+			VerifyQueue,
+			Verify
+		};
+
+		static constexpr size_t StageCount = 5;
+
+	public:
+		~RoundStats() = delete;
+
+		/**
+		 * \brief Activates or deactivates the measurement.
+		 * \param active true, if the stages are measured, false otherwise.
+		 */
+		static void setActive(bool active);
+
+		/**
+		 * \brief Checks, if the stages are measured.
+		 * \return true, if the stages are measured, false otherwise.
+		 */
+		static bool isActive();
+
+		/**
+		 * \brief Resets all measurements.
+		 */
+		static void reset();
+
+		/**
+		 * \brief Adds a measurement for a stage.
+		 * \param stage The stage.
+		 * \param microseconds The time the stage needed.
+		 * \param bytes The bytes, that were processed by the stage.
+		 */
+		static void add(Stage stage, Poco::UInt64 microseconds, Poco::UInt64 bytes = 0);
+
+		/**
+		 * \brief Returns the summed up time of a stage.
+		 * \param stage The stage.
+		 * \return The time in microseconds.
+		 */
+		static Poco::UInt64 getTime(Stage stage);
+
+		/**
+		 * \brief Returns the summed up bytes of a stage.
+		 * \param stage The stage.
+		 * \return The processed bytes.
+		 */
+		static Poco::UInt64 getBytes(Stage stage);
+
+		/**
+		 * \brief Returns the number of measurements of a stage.
+		 * \param stage The stage.
+		 * \return The number of measurements.
+		 */
+		static Poco::UInt64 getCount(Stage stage);
+
+		/**
+		 * \brief Returns the name of a stage.
+		 * \param stage The stage.
+		 * \return The name.
+		 */
+		static std::string getName(Stage stage);
+
+	private:
+		static std::atomic<bool> active_;
+		static std::array<std::atomic<Poco::UInt64>, StageCount> time_, bytes_, count_;
+	};
+
+	/**
+	 * \brief Mines a number of rounds with fixed block data against the configured plot files.
+	 * The miner does not need a network connection, every found deadline is accepted locally.
+	 */
+	class Benchmark
+	{
+	public:
+		/**
+		 * \brief The results of a mined round.
+		 */
+		struct Round
+		{
+			Poco::UInt64 height = 0;
+			Poco::UInt64 scoop = 0;
+			double roundTime = 0.;
+			std::array<Poco::UInt64, RoundStats::StageCount> stageTime, stageBytes, stageCount;
+
+			/**
+			 * \brief The share of the gpu on the verified nonces in hybrid mode, 0 otherwise.
+			 */
+			double gpuShare = 0.;
+
+			/**
+			 * \brief The best nonce and deadline per account.
+			 */
+			std::map<Poco::UInt64, std::pair<Poco::UInt64, Poco::UInt64>> bestDeadlines;
+		};
+
+		/**
+		 * \brief Constructor.
+		 * \param rounds The number of rounds, that are mined.
+		 */
+		explicit Benchmark(unsigned rounds);
+
+		/**
+		 * \brief Mines all rounds.
+		 * \param miner The miner, that needs to be started offline.
+		 * \return true, if all rounds were processed, false otherwise.
+		 */
+		bool run(Miner& miner);
+
+		/**
+		 * \brief Writes the results of all rounds into a JSON file.
+		 * \param path The path of the report.
+		 * \return true, if the report was written, false otherwise.
+		 */
+		bool writeReport(const std::string& path) const;
+
+		/**
+		 * \brief Returns the results of all mined rounds.
+		 * \return The results in the order of the rounds.
+		 */
+		const std::vector<Round>& getResults() const;
+
+	private:
+		void onRoundProcessed(const void* sender, Poco::UInt64& blockHeight);
+
+		unsigned rounds_;
+		std::vector<Round> results_;
+		std::atomic<Poco::UInt64> awaitedHeight_;
+		Poco::Event roundProcessed_;
+	};
+}
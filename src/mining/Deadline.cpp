@@ -86,6 +86,20 @@ bool Burst::Deadline::isConfirmed() const
 	return confirmed_.load();
 }
 
+Burst::DeadlineStatus Burst::Deadline::getStatus() const
+{
+	if (isConfirmed())
+		return DeadlineStatus::Confirmed;
+
+	if (isSent())
+		return DeadlineStatus::Sent;
+
+	if (isOnTheWay())
+		return DeadlineStatus::OnTheWay;
+
+	return DeadlineStatus::Found;
+}
+
 const std::string& Burst::Deadline::getPlotFile() const
 {
 	Poco::ScopedLock<Poco::FastMutex> lock{ mutex_ };
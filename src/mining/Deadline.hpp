@@ -34,6 +34,18 @@ namespace Burst
 	class Account;
 	class BlockData;
 
+	/**
+	 * \brief How far a deadline got on its way to the pool.
+	 * The values are stored in the database and must not change.
+	 */
+	enum class DeadlineStatus
+	{
+		Found = 0,
+		OnTheWay = 1,
+		Sent = 2,
+		Confirmed = 3
+	};
+
 	class Deadline : public std::enable_shared_from_this<Deadline>
 	{
 	public:
@@ -62,6 +74,12 @@ namespace Burst
 		bool isSent() const;
 		bool isConfirmed() const;
 
+		/**
+		 * \brief Returns the furthest status, the deadline reached.
+		 * \return The status.
+		 */
+		DeadlineStatus getStatus() const;
+
 		void setDeadline(Poco::UInt64 deadline);
 		void setMiner(const std::string& miner);
 		void setTotalPlotsize(Poco::UInt64 plotsize);
@@ -0,0 +1,273 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+#include "GoldenRound.hpp"
+#include "Miner.hpp"
+#include "MinerConfig.hpp"
+#include "MinerCL.hpp"
+#include "MinerUtil.hpp"
+#include "logging/MinerLogger.hpp"
+#include "plots/Plot.hpp"
+#include <algorithm>
+#include <Poco/FileStream.h>
+#include <Poco/JSON/Array.h>
+#include <Poco/JSON/Object.h>
+#include <Poco/JSON/Parser.h>
+#include <Poco/NumberFormatter.h>
+
+bool Burst::GoldenRound::record(const std::string& path)
+{
+	poco_ndc(GoldenRound::record);
+
+	auto& config = MinerConfig::getConfig();
+	Benchmark::Round round;
+
+	if (!mine(round))
+		return false;
+
+	Poco::JSON::Object golden;
+	Poco::JSON::Array plots;
+	Poco::JSON::Array deadlines;
+
+	golden.set("gensig", config.getBenchmarkGensig());
+	golden.set("height", config.getBenchmarkHeight());
+	golden.set("baseTarget", config.getBenchmarkBaseTarget());
+	golden.set("scoop", round.scoop);
+
+	for (const auto& plot : createPlotCatalog())
+		plots.add(plot);
+
+	for (const auto& bestDeadline : round.bestDeadlines)
+	{
+		Poco::JSON::Object deadline;
+		deadline.set("account", bestDeadline.first);
+		deadline.set("nonce", bestDeadline.second.first);
+		deadline.set("deadline", bestDeadline.second.second);
+		deadlines.add(deadline);
+	}
+
+	golden.set("plots", plots);
+	golden.set("deadlines", deadlines);
+	golden.set("processorType", config.getProcessorType());
+	golden.set("instructionSet", config.getCpuInstructionSet());
+	golden.set("roundTime", round.roundTime);
+
+	// when set, every replayed round needs to be faster
+	golden.set("maxRoundTime", 0.);
+
+	try
+	{
+		Poco::FileStream goldenStream{path, std::ios_base::out | std::ios::trunc};
+		golden.stringify(goldenStream, 4);
+		goldenStream << std::endl;
+		log_success(MinerLogger::miner, "Recorded the golden round into %s", path);
+		return true;
+	}
+	catch (...)
+	{
+		log_error(MinerLogger::miner, "Could not write the golden round into %s!", path);
+		return false;
+	}
+}
+
+bool Burst::GoldenRound::replay(const std::string& path)
+{
+	poco_ndc(GoldenRound::replay);
+
+	auto& config = MinerConfig::getConfig();
+	Poco::JSON::Object::Ptr golden;
+
+	try
+	{
+		Poco::FileInputStream goldenStream{path};
+		Poco::JSON::Parser parser;
+		golden = parser.parse(goldenStream).extract<Poco::JSON::Object::Ptr>();
+	}
+	catch (Poco::Exception& exc)
+	{
+		log_error(MinerLogger::miner, "Could not read the golden round %s\n\t%s", path, exc.displayText());
+		return false;
+	}
+
+	std::map<Poco::UInt64, std::pair<Poco::UInt64, Poco::UInt64>> expectedDeadlines;
+	std::vector<std::string> plots;
+
+	for (const auto& plot : *golden->getArray("plots"))
+		plots.emplace_back(plot.convert<std::string>());
+
+	for (const auto& deadline : *golden->getArray("deadlines"))
+	{
+		const auto deadlineObj = deadline.extract<Poco::JSON::Object::Ptr>();
+		expectedDeadlines[deadlineObj->getValue<Poco::UInt64>("account")] = std::make_pair(
+			deadlineObj->getValue<Poco::UInt64>("nonce"), deadlineObj->getValue<Poco::UInt64>("deadline"));
+	}
+
+	// the deadlines can only be the same, when the same nonces are mined
+	if (plots != createPlotCatalog())
+	{
+		log_error(MinerLogger::miner, "The plot files of the config are not the plot files of the golden round %s!", path);
+		return false;
+	}
+
+	const auto maxRoundTime = golden->optValue("maxRoundTime", 0.);
+
+	config.setBenchmarkBlock(golden->getValue<std::string>("gensig"), golden->getValue<Poco::UInt64>("height"),
+		golden->getValue<Poco::UInt64>("baseTarget"));
+
+	const auto processorType = config.getProcessorType();
+	const auto instructionSet = config.getCpuInstructionSet();
+	const auto progressiveReading = config.isProgressiveReading();
+	const auto variants = getVariants();
+	auto success = true;
+
+	// a config for OpenCL needs the OpenCL variants, otherwise a missing device would pass unnoticed
+	if ((processorType == "OPENCL" || processorType == "HYBRID") &&
+		std::none_of(variants.begin(), variants.end(), [](const Variant& variant) { return variant.processorType == "OPENCL"; }))
+	{
+		log_error(MinerLogger::miner, "The config uses %s, but the OpenCL device %u on platform %u could not be initialized!",
+			processorType, config.getGpuDevice(), config.getGpuPlatform());
+		return false;
+	}
+
+	for (const auto& variant : variants)
+	{
+		config.setProcessorType(variant.processorType);
+		config.setCpuInstructionSet(variant.instructionSet);
+		config.setProgressiveReading(variant.progressiveReading);
+
+		Benchmark::Round round;
+		auto variantSuccess = mine(round);
+
+		if (variantSuccess && round.bestDeadlines != expectedDeadlines)
+		{
+			variantSuccess = false;
+
+			for (const auto& expected : expectedDeadlines)
+			{
+				const auto found = round.bestDeadlines.find(expected.first);
+
+				if (found == round.bestDeadlines.end())
+					log_error(MinerLogger::miner, "%s: no deadline for account %Lu, expected nonce %Lu with deadline %Lu",
+						variant.getName(), expected.first, expected.second.first, expected.second.second);
+				else if (found->second != expected.second)
+					log_error(MinerLogger::miner, "%s: account %Lu found nonce %Lu with deadline %Lu, expected nonce %Lu with deadline %Lu",
+						variant.getName(), expected.first, found->second.first, found->second.second,
+						expected.second.first, expected.second.second);
+			}
+
+			for (const auto& found : round.bestDeadlines)
+				if (expectedDeadlines.find(found.first) == expectedDeadlines.end())
+					log_error(MinerLogger::miner, "%s: unexpected deadline for account %Lu", variant.getName(), found.first);
+		}
+
+		// the hybrid mode is only tested, when the cpu and the gpu verifiers got chunks
+		if (variantSuccess && variant.processorType == "HYBRID" && (round.gpuShare <= 0. || round.gpuShare >= 1.))
+		{
+			variantSuccess = false;
+			log_error(MinerLogger::miner, "%s: the gpu verified %s%% of the nonces, but both the cpu and the gpu need to verify",
+				variant.getName(), Poco::NumberFormatter::format(round.gpuShare * 100, 1));
+		}
+
+		if (variantSuccess && maxRoundTime > 0. && round.roundTime > maxRoundTime)
+		{
+			variantSuccess = false;
+			log_error(MinerLogger::miner, "%s: the round took %ss, allowed are %ss", variant.getName(),
+				Poco::NumberFormatter::format(round.roundTime, 3), Poco::NumberFormatter::format(maxRoundTime, 3));
+		}
+
+		if (variantSuccess)
+			log_success(MinerLogger::miner, "%s: OK in %ss", variant.getName(), Poco::NumberFormatter::format(round.roundTime, 3));
+		else
+			log_error(MinerLogger::miner, "%s: FAILED", variant.getName());
+
+		success = success && variantSuccess;
+	}
+
+	config.setProcessorType(processorType);
+	config.setCpuInstructionSet(instructionSet);
+	config.setProgressiveReading(progressiveReading);
+
+	return success;
+}
+
+std::string Burst::GoldenRound::Variant::getName() const
+{
+	return (processorType == "CPU" ? instructionSet : processorType) +
+		(progressiveReading ? " (progressive reading)" : "");
+}
+
+bool Burst::GoldenRound::mine(Benchmark::Round& round)
+{
+	Miner miner;
+	Benchmark benchmark{1};
+
+	if (!benchmark.run(miner) || benchmark.getResults().empty())
+		return false;
+
+	round = benchmark.getResults().front();
+	return true;
+}
+
+std::vector<Burst::GoldenRound::Variant> Burst::GoldenRound::getVariants()
+{
+	auto& config = MinerConfig::getConfig();
+	std::vector<Variant> variants;
+
+	variants.push_back({"CPU", "SSE2", false});
+
+	if (Settings::Sse4 && cpuHasInstructionSet(CpuInstructionSet::sse4))
+		variants.push_back({"CPU", "SSE4", false});
+
+	if (Settings::Avx && cpuHasInstructionSet(CpuInstructionSet::avx))
+		variants.push_back({"CPU", "AVX", false});
+
+	if (Settings::Avx2 && cpuHasInstructionSet(CpuInstructionSet::avx2))
+		variants.push_back({"CPU", "AVX2", false});
+
+	// the OpenCL device (e.g. POCL) is chosen by the gpu platform and device of the config
+	if (Settings::OpenCl && (MinerCL::getCL().initialized() ||
+		MinerCL::getCL().create(config.getGpuPlatform(), config.getGpuDevice())))
+	{
+		variants.push_back({"OPENCL", config.getCpuInstructionSet(), false});
+		variants.push_back({"HYBRID", config.getCpuInstructionSet(), false});
+	}
+
+	// the CUDA device is only initialized, when the miner is configured for it
+	if (Settings::Cuda && config.getProcessorType() == "CUDA")
+		variants.push_back({"CUDA", config.getCpuInstructionSet(), false});
+
+	// the reading modes need to find the same deadlines
+	variants.push_back({"CPU", "SSE2", true});
+
+	return variants;
+}
+
+std::vector<std::string> Burst::GoldenRound::createPlotCatalog()
+{
+	std::vector<std::string> catalog;
+
+	for (const auto& plotFile : MinerConfig::getConfig().getPlotFiles())
+		catalog.emplace_back(Poco::format("%Lu_%Lu_%Lu (PoC%s)", plotFile->getAccountId(), plotFile->getNonceStart(),
+			plotFile->getNonces(), std::string(plotFile->isPoC(2) ? "2" : "1")));
+
+	std::sort(catalog.begin(), catalog.end());
+	return catalog;
+}
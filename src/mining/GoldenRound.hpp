@@ -0,0 +1,84 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Benchmark.hpp"
+
+namespace Burst
+{
+	/**
+	 * \brief Records the inputs and the results of a round and replays them with every available verifier.
+	 * A golden round contains the block data, the catalog of the plot files and the best deadline per account.
+	 * When replaying, every verifier and every reading mode needs to find exactly the same deadlines.
+	 */
+	class GoldenRound
+	{
+	public:
+		~GoldenRound() = delete;
+
+		/**
+		 * \brief Mines one offline round with the block data of the benchmark config and saves it as golden round.
+		 * \param path The path of the golden round file.
+		 * \return true, if the round was mined and saved, false otherwise.
+		 */
+		static bool record(const std::string& path);
+
+		/**
+		 * \brief Replays a golden round with every compiled and supported verifier.
+		 * When the config uses OPENCL or HYBRID, the OpenCL device has to be available.
+		 * \param path The path of the golden round file.
+		 * \return true, if all verifiers found the recorded deadlines in time, false otherwise.
+		 */
+		static bool replay(const std::string& path);
+
+	private:
+		struct Variant
+		{
+			std::string processorType;
+			std::string instructionSet;
+			bool progressiveReading;
+
+			std::string getName() const;
+		};
+
+		/**
+		 * \brief Mines one offline round with a new miner.
+		 * \param round The results of the round.
+		 * \return true, if the round was processed, false otherwise.
+		 */
+		static bool mine(Benchmark::Round& round);
+
+		/**
+		 * \brief Returns all verifiers and reading modes, that are available in this build and on this computer.
+		 * \return The variants.
+		 */
+		static std::vector<Variant> getVariants();
+
+		/**
+		 * \brief Creates a line for every plot file, that describes the nonces inside it.
+		 * \return The sorted catalog.
+		 */
+		static std::vector<std::string> createPlotCatalog();
+	};
+}
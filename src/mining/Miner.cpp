@@ -23,6 +23,12 @@
 #include "logging/MinerLogger.hpp"
 #include "MinerConfig.hpp"
 #include "plots/PlotReader.hpp"
+#include "plots/PlotReadScheduler.hpp"
+#include "plots/IoScheduler.hpp"
+#include "plots/PlotChecksum.hpp"
+#include "plots/PlotHealth.hpp"
+#include "plots/CpuBudget.hpp"
+#include "plots/WakeUpScheduler.hpp"
 #include "MinerUtil.hpp"
 #include "network/Request.hpp"
 #include <Poco/Net/HTTPRequest.h>
@@ -32,9 +38,11 @@
 #include "logging/Performance.hpp"
 #include <Poco/FileStream.h>
 #include <fstream>
+#include <algorithm>
 #include <Poco/File.h>
 #include <Poco/Delegate.h>
 #include "plots/PlotVerifier.hpp"
+#include "plots/VerifierBalance.hpp"
 #include "MinerCL.hpp"
 
 namespace Burst
@@ -52,7 +60,12 @@ namespace Burst
 			                               Poco::UInt64 blockheight, const std::string& plotFile,
 			                               bool ownAccount)
 			{
-				miner.submitNonceAsync(make_tuple(nonce, accountId, deadline, blockheight, plotFile, ownAccount));
+				// offline, the deadline is added before the verifier reports its progress,
+				// so that it is part of the round, when the round is processed
+				if (miner.isOffline())
+					miner.submitNonce(nonce, accountId, deadline, blockheight, plotFile, ownAccount);
+				else
+					miner.submitNonceAsync(make_tuple(nonce, accountId, deadline, blockheight, plotFile, ownAccount));
 			};
 
 			for (size_t i = 0; i < size; ++i)
@@ -73,7 +86,8 @@ namespace Burst
 }
 
 Burst::Miner::Miner()
-	: submitNonceAsync{this, &Miner::submitNonceAsyncImpl}
+	: submitNonceAsync{this, &Miner::submitNonceAsyncImpl},
+	  roundBookkeeper_{std::make_unique<RoundBookkeeper>(*this)}
 {}
 
 Burst::Miner::~Miner() = default;
@@ -81,12 +95,6 @@ Burst::Miner::~Miner() = default;
 void Burst::Miner::run()
 {
 	poco_ndc(Miner::run);
-	running_ = true;
-	progressRead_ = std::make_shared<PlotReadProgress>();
-	progressVerify_ = std::make_shared<PlotReadProgress>();
-
-	progressRead_->progressChanged.add(Poco::delegate(this, &Miner::progressChanged));
-	progressVerify_->progressChanged.add(Poco::delegate(this, &Miner::progressChanged));
 
 	auto& config = MinerConfig::getConfig();
 	auto errors = 0u;
@@ -99,39 +107,22 @@ void Burst::Miner::run()
 		return;
 	}
 
-	Poco::ThreadPool::defaultPool().addCapacity(128);
-
-	MinerConfig::getConfig().printConsole();
-
-	// only create the thread pools and manager for mining if there is work to do (plot files)
-	if (!config.getPlotFiles().empty())
-	{
-		// manager
-		nonceSubmitterManager_ = std::make_unique<Poco::TaskManager>();
-
-		// create the plot readers
-		MinerHelper::create_worker<PlotReader>(plot_reader_pool_, plot_reader_, MinerConfig::getConfig().getMaxPlotReaders(),
-			data_, progressRead_, verificationQueue_, plotReadQueue_);
-
-		// create the plot verifiers
-		createPlotVerifiers();
-
-#ifndef USE_CUDA
-		if (config.getProcessorType() == "CUDA")
-			log_error(MinerLogger::miner, "You are mining with your CUDA GPU, but the miner is compiled without the CUDA SDK!\n"
-				"You will not see any deadline coming from this miner!");
-#endif
-	}
+	startWorkers();
 
 	wallet_ = MinerConfig::getConfig().getWalletUrl();
 
+	if (wallet_.isActive())
+		accounts_.openCache(config.getDatabasePath());
+
 	const auto wakeUpTime = static_cast<long>(config.getWakeUpTime());
+	const auto wakeUp = wakeUpTime > 0 || config.isSmartWakeUp();
 
-	if (wakeUpTime > 0)
+	if (wakeUp)
 	{
 		const Poco::TimerCallback<Miner> callback(*this, &Miner::on_wake_up);
 
-		wake_up_timer_.setPeriodicInterval(wakeUpTime * 1000);
+		// the smart wake up decides every second, which disks need to be woken up
+		wake_up_timer_.setPeriodicInterval(config.isSmartWakeUp() ? 1000 : wakeUpTime * 1000);
 		wake_up_timer_.start(callback);
 	}
 
@@ -145,6 +136,15 @@ void Burst::Miner::run()
 		benchmark_timer_.start(callback);
 	}
 
+	const auto checkpointInterval = config.getCheckpointInterval();
+
+	if (checkpointInterval > 0)
+	{
+		const Poco::TimerCallback<Miner> callback(*this, &Miner::onCheckpoint);
+		checkpoint_timer_.setPeriodicInterval(checkpointInterval * 1000u);
+		checkpoint_timer_.start(callback);
+	}
+
 	running_ = true;
 
 	miningInfoSession_ = MinerConfig::getConfig().createSession(HostType::MiningInfo);
@@ -176,12 +176,71 @@ void Burst::Miner::run()
 		std::this_thread::sleep_for(std::chrono::seconds(MinerConfig::getConfig().getMiningInfoInterval()));
 	}
 
-	if (wakeUpTime > 0)
+	if (wakeUp)
 		wake_up_timer_.stop();
 
+	if (checkpointInterval > 0)
+	{
+		checkpoint_timer_.stop();
+
+		// the readers and verifiers are stopped, the checkpoint is complete
+		const auto block = data_.getBlockData();
+
+		if (block != nullptr)
+			data_.getCheckpoint().save(*block);
+	}
+
 	running_ = false;
 }
 
+void Burst::Miner::runOffline()
+{
+	poco_ndc(Miner::runOffline);
+
+	offline_ = true;
+	startWorkers();
+}
+
+void Burst::Miner::startWorkers()
+{
+	running_ = true;
+	progressRead_ = std::make_shared<PlotReadProgress>();
+	progressVerify_ = std::make_shared<PlotReadProgress>();
+
+	progressRead_->progressChanged.add(Poco::delegate(this, &Miner::progressChanged));
+	progressVerify_->progressChanged.add(Poco::delegate(this, &Miner::progressChanged));
+
+	auto& config = MinerConfig::getConfig();
+
+	Poco::ThreadPool::defaultPool().addCapacity(128);
+
+	MinerConfig::getConfig().printConsole();
+
+	// only create the thread pools and manager for mining if there is work to do (plot files)
+	if (!config.getPlotFiles().empty())
+	{
+		// manager
+		nonceSubmitterManager_ = std::make_unique<Poco::TaskManager>();
+
+		// create the plot readers
+		MinerHelper::create_worker<PlotReader>(plot_reader_pool_, plot_reader_, MinerConfig::getConfig().getMaxPlotReaders(),
+			data_, progressRead_, progressVerify_, verificationQueue_, gpuVerificationQueue_, plotReadQueue_);
+
+		// create the plot verifiers
+		createPlotVerifiers();
+
+		// write the missing checksum sidecars in the background
+		if (config.isPlotChecksums())
+			MinerHelper::create_worker<PlotChecksumBuilder>(checksum_builder_pool_, checksum_builder_, 1);
+
+#ifndef USE_CUDA
+		if (config.getProcessorType() == "CUDA")
+			log_error(MinerLogger::miner, "You are mining with your CUDA GPU, but the miner is compiled without the CUDA SDK!\n"
+				"You will not see any deadline coming from this miner!");
+#endif
+	}
+}
+
 void Burst::Miner::stop()
 {
 	poco_ndc(Miner::stop);
@@ -193,6 +252,16 @@ void Burst::Miner::stop()
 	// stop verifier
 	if (verifier_ != nullptr)
 		shut_down_worker(*verifier_pool_, *verifier_, verificationQueue_);
+
+	if (gpu_verifier_ != nullptr)
+		shut_down_worker(*gpu_verifier_pool_, *gpu_verifier_, gpuVerificationQueue_);
+
+	// stop the checksum builder
+	if (checksum_builder_ != nullptr)
+	{
+		checksum_builder_->cancelAll();
+		checksum_builder_pool_->joinAll();
+	}
 	
 	running_ = false;
 }
@@ -203,11 +272,13 @@ void Burst::Miner::restart()
 	stop();
 }
 
-void Burst::Miner::addPlotReadNotifications(bool wakeUpCall)
+void Burst::Miner::addPlotReadNotifications(bool wakeUpCall, const std::function<bool(const PlotDir&)>& filter)
 {
+	std::vector<PlotReadNotification::Ptr> notifications;
+
 	const auto initPlotReadNotification = [this, wakeUpCall](PlotDir& plotDir)
 	{
-		auto notification = new PlotReadNotification;
+		PlotReadNotification::Ptr notification = new PlotReadNotification;
 		notification->dir = plotDir.getPath();
 		notification->gensig = getGensig();
 		notification->scoopNum = getScoopNum();
@@ -215,6 +286,8 @@ void Burst::Miner::addPlotReadNotifications(bool wakeUpCall)
 		notification->baseTarget = getBaseTarget();
 		notification->type = plotDir.getType();
 		notification->wakeUpCall = wakeUpCall;
+		notification->deviceId = plotDir.getDeviceId();
+		notification->epoch = PlotReader::roundEpoch.get();
 
 		for (const auto& plotFile : plotDir.getPlotfiles(true))
 			accounts_.getAccount(plotFile->getAccountId(), wallet_, true);
@@ -222,15 +295,18 @@ void Burst::Miner::addPlotReadNotifications(bool wakeUpCall)
 		return notification;
 	};
 
-	const auto addParallel = [this, &initPlotReadNotification](PlotDir& plotDir, std::shared_ptr<PlotFile> plotFile)
+	const auto addParallel = [&notifications, &initPlotReadNotification](PlotDir& plotDir, std::shared_ptr<PlotFile> plotFile)
 	{
 		auto plotRead = initPlotReadNotification(plotDir);
 		plotRead->plotList.emplace_back(plotFile);
-		plotReadQueue_.enqueueNotification(plotRead);
+		notifications.emplace_back(plotRead);
 	};
 
-	MinerConfig::getConfig().forPlotDirs([this, &addParallel, &initPlotReadNotification](PlotDir& plotDir)
+	MinerConfig::getConfig().forPlotDirs([&notifications, &addParallel, &initPlotReadNotification, &filter](PlotDir& plotDir)
 	{
+		if (filter && !filter(plotDir))
+			return true;
+
 		if (plotDir.getType() == PlotDir::Type::Parallel)
 		{
 			for (const auto& plotFile : plotDir.getPlotfiles())
@@ -244,15 +320,44 @@ void Burst::Miner::addPlotReadNotifications(bool wakeUpCall)
 		{
 			auto plotRead = initPlotReadNotification(plotDir);
 			plotRead->plotList = plotDir.getPlotfiles();
+			PlotReadScheduler::sortByPhysicalOffset(plotRead->plotList);
 
 			for (const auto& relatedPlotDir : plotDir.getRelatedDirs())
-				plotRead->relatedPlotLists.emplace_back(relatedPlotDir->getPath(), relatedPlotDir->getPlotfiles());
+			{
+				auto relatedPlotList = relatedPlotDir->getPlotfiles();
+				PlotReadScheduler::sortByPhysicalOffset(relatedPlotList);
+				plotRead->relatedPlotLists.emplace_back(relatedPlotDir->getPath(), relatedPlotList);
+			}
 
-			plotReadQueue_.enqueueNotification(plotRead);
+			notifications.emplace_back(plotRead);
 		}
 
 		return true;
 	});
+
+	// the quarantine of a device is counted in rounds
+	if (!wakeUpCall)
+		PlotHealth::beginRound(getBlockheight());
+
+	// the slowest devices need to start first, so that all devices finish at about the same time
+	PlotReadScheduler::schedule(notifications);
+
+	// the background work has to give way to the round
+	if (!wakeUpCall)
+	{
+		std::vector<Poco::UInt64> devices;
+
+		for (const auto& notification : notifications)
+			devices.emplace_back(notification->deviceId);
+
+		IoScheduler::beginRound(devices);
+	}
+
+	for (auto& notification : notifications)
+	{
+		notification->enqueued.update();
+		plotReadQueue_.enqueueNotification(notification);
+	}
 }
 
 bool Burst::Miner::wantRestart() const
@@ -260,6 +365,27 @@ bool Burst::Miner::wantRestart() const
 	return restart_;
 }
 
+Poco::UInt64 Burst::Miner::getRoundBudget() const
+{
+	const Poco::UInt64 roundBudget = MinerConfig::getConfig().getRoundBudget();
+
+	if (!MinerConfig::getConfig().isRoundBudgetAuto())
+		return roundBudget;
+
+	// the expected block time is the mean of the last block times
+	const auto blockTimes = data_.getBlockTimes(360);
+
+	if (blockTimes.empty())
+		return roundBudget;
+
+	Poco::UInt64 sum = 0;
+
+	for (const auto blockTime : blockTimes)
+		sum += blockTime;
+
+	return std::max<Poco::UInt64>(sum / blockTimes.size(), 1);
+}
+
 void Burst::Miner::updateGensig(const std::string& gensigStr, Poco::UInt64 blockHeight, Poco::UInt64 baseTarget)
 {
 	poco_ndc(Miner::updateGensig);
@@ -267,11 +393,23 @@ void Burst::Miner::updateGensig(const std::string& gensigStr, Poco::UInt64 block
 	CLEAR_PROBES()
 	START_PROBE("Miner.StartNewBlock")
 
+	// all queued and running work of the old round is stale from now on
+	PlotReader::roundEpoch.next();
+	PlotReader::roundEpoch.setBudget(getRoundBudget());
+	CpuBudget::resetUtilization();
+
 	// stop all reading processes if any
 	if (!MinerConfig::getConfig().getPlotFiles().empty())
 	{
 		log_debug(MinerLogger::miner, "Plot-read-queue: %d (%d reader), verification-queue: %d (%d verifier)",
 			plotReadQueue_.size(), plot_reader_->count(), verificationQueue_.size(), verifier_->count());
+
+		if (VerifierBalance::isActive())
+			log_debug(MinerLogger::miner, "Gpu-verification-queue: %d (%d verifier), gpu share: %.1f%%, "
+				"throughput cpu: %.0f, gpu: %.0f nonces/s", gpuVerificationQueue_.size(), gpu_verifier_->count(),
+				VerifierBalance::getGpuShare() * 100, VerifierBalance::getThroughput(VerifierBackend::Cpu),
+				VerifierBalance::getThroughput(VerifierBackend::Gpu));
+
 		log_debug(MinerLogger::miner, "Allocated memory: %s", memToString(PlotReader::globalBufferSize.getSize(), 1));
 	
 		START_PROBE("Miner.SetBuffersize")
@@ -279,8 +417,12 @@ void Burst::Miner::updateGensig(const std::string& gensigStr, Poco::UInt64 block
 		TAKE_PROBE("Miner.SetBuffersize")
 	}
 	
-	// clear the plot read queue
+	// clear the plot read queue and drop all unverified chunks,
+	// their buffers are given free when the notifications are destroyed
 	plotReadQueue_.clear();
+	verificationQueue_.clear();
+	gpuVerificationQueue_.clear();
+	VerifierBalance::beginRound();
 
 	// Set dynamic targetDL for this round if a submitProbability is given
 	if (MinerConfig::getConfig().getSubmitProbability() > 0.)
@@ -300,21 +442,57 @@ void Burst::Miner::updateGensig(const std::string& gensigStr, Poco::UInt64 block
 			MinerConfig::getConfig().setTargetDeadline(poolDeadline, TargetDeadlineType::Local);
 	}
 
+	RoundStart roundStart;
+
 	// Set total run time of previous block
 	if (startPoint_.time_since_epoch().count() > 0)
 	{
 		const auto timeDiff = std::chrono::high_resolution_clock::now() - startPoint_;
-		const auto timeDiffSeconds = std::chrono::duration_cast<std::chrono::seconds>(timeDiff);
-		log_unimportant(MinerLogger::miner, "Block %s ended in %s", numberToString(blockHeight - 1),
-			deadlineFormat(timeDiffSeconds.count()));
-		data_.getBlockData()->setBlockTime(timeDiffSeconds.count());
+		roundStart.previousBlockTime = std::chrono::duration_cast<std::chrono::seconds>(timeDiff).count();
+		roundStart.previousBlock = data_.getBlockData();
+
+		if (roundStart.previousBlock != nullptr)
+			roundStart.previousBlock->setBlockTime(roundStart.previousBlockTime);
 	}
 
-	// setup new block-data
-	auto block = data_.startNewBlock(blockHeight, baseTarget, gensigStr, MinerConfig::getConfig().getTargetDeadline(TargetDeadlineType::Local));
-	block->refreshBlockEntry();
+	// setup new block-data, the database is written in the background
+	roundStart.block = data_.startNewBlock(blockHeight, baseTarget, gensigStr, MinerConfig::getConfig().getTargetDeadline(TargetDeadlineType::Local));
+	roundStart.previousRoundInterrupted = isProcessing();
 	setIsProcessing(true);
 
+	progressRead_->reset(blockHeight, MinerConfig::getConfig().getTotalPlotsize());
+	progressVerify_->reset(blockHeight, MinerConfig::getConfig().getTotalPlotsize());
+	startPoint_ = std::chrono::high_resolution_clock::now();
+
+	// a restarted miner continues the round, where the last run stopped
+	if (!offline_)
+		restoreCheckpoint(data_.getCheckpoint().start(blockHeight, gensigStr));
+
+	// every millisecond before the readers start is lost,
+	// so they get the new gensig and scoop before anything else is done
+	addPlotReadNotifications();
+
+	TAKE_PROBE("Miner.StartNewBlock")
+
+	roundBookkeeper_->finishRoundStart(roundStart);
+}
+
+void Burst::Miner::finishRoundStart(const RoundStart& roundStart)
+{
+	poco_ndc(Miner::finishRoundStart);
+
+	const auto& block = roundStart.block;
+	const auto blockHeight = block->getBlockheight();
+
+	if (roundStart.previousBlock != nullptr)
+	{
+		log_unimportant(MinerLogger::miner, "Block %s ended in %s", numberToString(roundStart.previousBlock->getBlockheight()),
+			deadlineFormat(roundStart.previousBlockTime));
+		data_.saveBlock(*roundStart.previousBlock);
+	}
+
+	block->refreshBlockEntry();
+
 	// printing block info and transfer it to local server
 	{
 		const auto difficulty = block->getDifficulty();
@@ -336,36 +514,36 @@ void Burst::Miner::updateGensig(const std::string& gensigStr, Poco::UInt64 block
 			"difficulty \t%s (%s)\n"
 			"targetDL \t%s\n" +
 			std::string(50, '-'),
-			numberToString(blockHeight), block->getScoop(), numberToString(baseTarget), createTruncatedString(getGensigStr(), 14, 32),
+			numberToString(blockHeight), block->getScoop(), numberToString(block->getBasetarget()),
+			createTruncatedString(block->getGensigStr(), 14, 32),
 			numberToString(difficulty),
 			diffiultyDifferenceToString,
 			deadlineFormat(MinerConfig::getConfig().getTargetDeadline())
 		);
 
-		data_.getBlockData()->refreshBlockEntry();
+		block->refreshBlockEntry();
 	}
 
+	if (MinerConfig::getConfig().isSmartWakeUp())
+		WakeUpScheduler::setBlockTimes(data_.getBlockTimes(360));
+
+	// a changed plot list is read from the next round on
 	if (MinerConfig::getConfig().isRescanningEveryBlock())
 		MinerConfig::getConfig().rescanPlotfiles();
 
-	progressRead_->reset(blockHeight, MinerConfig::getConfig().getTotalPlotsize());
-	progressVerify_->reset(blockHeight, MinerConfig::getConfig().getTotalPlotsize());
-
 	PlotSizes::nextRound();
 	PlotSizes::refresh(Poco::Net::IPAddress{"127.0.0.1"});
-	startPoint_ = std::chrono::high_resolution_clock::now();
 
-	addPlotReadNotifications();
-
-	data_.getWonBlocksAsync(wallet_, accounts_);
+	// the won blocks are refreshed when the disks are idle,
+	// only if the rounds never finish we have to do it here
+	if (roundStart.previousRoundInterrupted && !offline_)
+		data_.getWonBlocksAsync(wallet_, accounts_);
 
 	// why we start a new thread to gather the last winner:
 	// it could be slow and is not necessary for the whole process
 	// so show it when it's done
 	if (blockHeight > 0 && wallet_.isActive())
 		block->getLastWinnerAsync(wallet_, accounts_);
-
-	TAKE_PROBE("Miner.StartNewBlock")
 }
 
 const Burst::GensigData& Burst::Miner::getGensig() const
@@ -414,6 +592,11 @@ Poco::UInt64 Burst::Miner::getScoopNum() const
 	return data_.getCurrentScoopNum();
 }
 
+bool Burst::Miner::isOffline() const
+{
+	return offline_;
+}
+
 bool Burst::Miner::isProcessing() const
 {
 	return isProcessing_;
@@ -484,6 +667,22 @@ Burst::NonceConfirmation Burst::Miner::submitNonce(Poco::UInt64 nonce, Poco::UIn
 			newDeadline->setTotalPlotsize(plotsize);
 
 		newDeadline->onTheWay();
+
+		// without a pool, the deadline is accepted right away
+		if (offline_)
+		{
+			newDeadline->send();
+			newDeadline->confirm();
+
+			NonceConfirmation nonceConfirmation;
+			nonceConfirmation.deadline = deadline;
+			nonceConfirmation.json = Poco::format(
+				R"({ "result" : "success", "deadline" : %Lu, "deadlineText" : "%s", "deadlineString" : "%s" })", deadline,
+				deadlineFormat(deadline), deadlineFormat(deadline));
+			nonceConfirmation.errorCode = SubmitResponse::Confirmed;
+			return nonceConfirmation;
+		}
+
 		return NonceSubmitter{ *this, newDeadline }.submit();
 	}
 
@@ -672,7 +871,62 @@ void Burst::Miner::progressChanged(float &progress)
 
 void Burst::Miner::on_wake_up(Poco::Timer& timer)
 {
-	addPlotReadNotifications(true);
+	if (!MinerConfig::getConfig().isSmartWakeUp())
+	{
+		addPlotReadNotifications(true);
+		return;
+	}
+
+	// the disks are awake anyway, while they are read
+	if (isProcessing() || !hasBlockData())
+		return;
+
+	const auto elapsed = PlotReader::roundEpoch.getElapsed() / 1000000.;
+
+	addPlotReadNotifications(true, [elapsed](const PlotDir& plotDir)
+	{
+		return WakeUpScheduler::shouldWakeUp(plotDir.getPath(), elapsed);
+	});
+}
+
+void Burst::Miner::onCheckpoint(Poco::Timer& timer)
+{
+	const auto block = data_.getBlockData();
+
+	if (block != nullptr)
+		data_.getCheckpoint().save(*block);
+}
+
+void Burst::Miner::restoreCheckpoint(const std::vector<RoundCheckpoint::SavedDeadline>& deadlines)
+{
+	const auto block = data_.getBlockData();
+
+	for (const auto& saved : deadlines)
+	{
+		// a deadline, that was never put on its way to the pool, is submitted again
+		if (saved.status == DeadlineStatus::Found)
+		{
+			submitNonceAsync(std::make_tuple(saved.nonce, saved.accountId, saved.deadline, block->getBlockheight(),
+				saved.plotFile, true));
+			continue;
+		}
+
+		// all others may have reached the pool already and are only restored
+		const auto deadline = block->addDeadlineIfBest(saved.nonce, saved.deadline, getAccount(saved.accountId, true),
+			block->getBlockheight(), saved.plotFile);
+
+		if (deadline == nullptr)
+			continue;
+
+		// the status is restored step by step, as the deadline reached it
+		deadline->onTheWay();
+
+		if (saved.status >= DeadlineStatus::Sent)
+			deadline->send();
+
+		if (saved.status == DeadlineStatus::Confirmed)
+			deadline->confirm();
+	}
 }
 
 void Burst::Miner::onBenchmark(Poco::Timer& timer)
@@ -693,6 +947,7 @@ void Burst::Miner::onRoundProcessed(Poco::UInt64 blockHeight, double roundTime)
 {
 	const auto block = data_.getBlockData();
 	setIsProcessing(false);
+	IoScheduler::endRound();
 
 	if (block == nullptr || block->getBlockheight() != blockHeight)
 		return;
@@ -706,6 +961,33 @@ void Burst::Miner::onRoundProcessed(Poco::UInt64 blockHeight, double roundTime)
 		numberToString(block->getBlockheight()),
 		Poco::NumberFormatter::format(roundTime, 3),
 		bestDeadline == nullptr ? "none" : deadlineFormat(bestDeadline->getDeadline()));
+
+	if (PlotReader::roundEpoch.getSkipped() > 0)
+		log_information(MinerLogger::miner, "Round budget exceeded, devices quarantined or read errors, %s were not read",
+			memToString(PlotReader::roundEpoch.getSkipped(), 2));
+
+	block->refreshHealth();
+
+	log_debug(MinerLogger::miner, "Abort latency of the previous round: %sms",
+		Poco::NumberFormatter::format(PlotReader::roundEpoch.getAbortLatency() / 1000.0, 3));
+
+	if (CpuBudget::isActive())
+		log_information(MinerLogger::miner, "Verifier cpu usage: %s%% (budget %u%%)",
+			Poco::NumberFormatter::format(CpuBudget::getUtilization() * 100, 1), CpuBudget::getShare());
+
+	log_debug(MinerLogger::miner, "First read latency: %sms",
+		Poco::NumberFormatter::format(PlotReader::roundEpoch.getFirstReadLatency() / 1000.0, 3));
+
+	if (HugePages::getMode() != HugePageMode::Off)
+		log_debug(MinerLogger::miner, "Hugepages: %Lu of %Lu buffers reserved (%s%%), %Lu advised, %s transparent",
+			HugePages::getHugeTlbAllocations(), HugePages::getAllocations(),
+			Poco::NumberFormatter::format(HugePages::getHitRate() * 100, 1), HugePages::getAdvisedAllocations(),
+			memToString(HugePages::getTransparentBytes(), 2));
+
+	if (!offline_)
+		data_.getWonBlocksAsync(wallet_, accounts_);
+
+	roundProcessed.notify(this, blockHeight);
 }
 
 Burst::NonceConfirmation Burst::Miner::submitNonceAsyncImpl(const std::tuple<Poco::UInt64, Poco::UInt64, Poco::UInt64, Poco::UInt64, std::string, bool>& data)
@@ -760,7 +1042,7 @@ void Burst::Miner::createPlotVerifiers()
 {
 	const auto& processorType = MinerConfig::getConfig().getProcessorType();
 	auto cpuInstructionSet = MinerConfig::getConfig().getCpuInstructionSet();
-	auto forceCpu = false, fallback = false;
+	auto forceCpu = false, fallback = false, hybrid = false;
 	auto createWorker = [this](std::function<void(std::unique_ptr<Poco::ThreadPool>&, std::unique_ptr<Poco::TaskManager>&,
 	                                              size_t, Miner&, Poco::NotificationQueue&,
 	                                              std::shared_ptr<PlotReadProgress>)> function) {
@@ -782,8 +1064,22 @@ void Burst::Miner::createPlotVerifiers()
 		else
 			forceCpu = true;
 	}
+	else if (processorType == "HYBRID")
+	{
+		// the gpu verifiers get their own queue, the cpu verifiers are created below
+		if (Settings::OpenCl)
+		{
+			MinerHelper::create_worker_default<PlotVerifier_opencl>(gpu_verifier_pool_, gpu_verifier_,
+				MinerConfig::getConfig().getGpuVerifiers(), *this, gpuVerificationQueue_, progressVerify_);
+			hybrid = true;
+		}
+		else
+			forceCpu = true;
+	}
+
+	VerifierBalance::setActive(hybrid);
 
-	if (processorType == "CPU" || forceCpu)
+	if (processorType == "CPU" || hybrid || forceCpu)
 	{
 		if (cpuInstructionSet == "SSE4" && Settings::Sse4)
 			createWorker(MinerHelper::create_worker_default<PlotVerifier_sse4>);
@@ -821,6 +1117,14 @@ void Burst::Miner::setMiningIntensity(unsigned intensity)
 		return;
 
 	shut_down_worker(*verifier_pool_, *verifier_, verificationQueue_);
+
+	if (gpu_verifier_ != nullptr)
+	{
+		shut_down_worker(*gpu_verifier_pool_, *gpu_verifier_, gpuVerificationQueue_);
+		gpu_verifier_.reset();
+		gpu_verifier_pool_.reset();
+	}
+
 	MinerConfig::getConfig().setMininigIntensity(intensity);
 	createPlotVerifiers();
 }
@@ -837,7 +1141,7 @@ void Burst::Miner::setMaxPlotReader(unsigned max_reader)
 	shut_down_worker(*plot_reader_pool_, *plot_reader_, plotReadQueue_);
 	MinerConfig::getConfig().setMaxPlotReaders(max_reader);
 	MinerHelper::create_worker<PlotReader>(plot_reader_pool_, plot_reader_, MinerConfig::getConfig().getMaxPlotReaders(),
-		data_, progressRead_, verificationQueue_, plotReadQueue_);
+		data_, progressRead_, progressVerify_, verificationQueue_, gpuVerificationQueue_, plotReadQueue_);
 }
 
 void Burst::Miner::setMaxBufferSize(Poco::UInt64 size)
@@ -872,3 +1176,15 @@ bool Burst::Miner::isPoC2() const
 	poco_check_ptr(block);
 	return block->getBlockheight() >= MinerConfig::getConfig().getPoc2StartBlock();
 }
+
+Burst::Miner::RoundBookkeeper::RoundBookkeeper(Miner& miner)
+	: finishRoundStart{this, &RoundBookkeeper::runFinishRoundStart},
+	  miner_{miner}
+{}
+
+Burst::Miner::RoundBookkeeper::~RoundBookkeeper() = default;
+
+void Burst::Miner::RoundBookkeeper::runFinishRoundStart(const RoundStart& roundStart)
+{
+	miner_.finishRoundStart(roundStart);
+}
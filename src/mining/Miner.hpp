@@ -24,6 +24,7 @@
 #include "Declarations.hpp"
 #include "Deadline.hpp"
 #include <memory>
+#include <functional>
 #include "wallet/Account.hpp"
 #include "wallet/Wallet.hpp"
 #include <Poco/TaskManager.h>
@@ -32,6 +33,7 @@
 #include "WorkerList.hpp"
 #include "network/Response.hpp"
 #include <Poco/Timer.h>
+#include <Poco/ActiveDispatcher.h>
 
 namespace Poco
 {
@@ -46,6 +48,7 @@ namespace Burst
 	class MinerConfig;
 	class PlotReadProgress;
 	class Deadline;
+	class PlotDir;
 
 	class Miner
 	{
@@ -54,12 +57,26 @@ namespace Burst
 		~Miner();
 
 		void run();
+
+		/**
+		 * \brief Starts the plot readers and verifiers without connecting to a pool or a wallet.
+		 * New rounds are only started by \see updateGensig and every found deadline is accepted locally.
+		 */
+		void runOffline();
+
 		void stop();
 		void restart();
-		void addPlotReadNotifications(bool wakeUpCall = false);
+		void addPlotReadNotifications(bool wakeUpCall = false, const std::function<bool(const PlotDir&)>& filter = {});
 		bool wantRestart() const;
 
 		bool hasBlockData() const;
+
+		/**
+		 * \brief Checks, if the miner was started by \see runOffline.
+		 * \return true, if the miner works without pool and wallet, false otherwise.
+		 */
+		bool isOffline() const;
+
 		bool isProcessing() const;
 		Poco::UInt64 getScoopNum() const;
 		Poco::UInt64 getBaseTarget() const;
@@ -91,7 +108,41 @@ namespace Burst
 
 		bool isPoC2() const;
 
+		/**
+		 * \brief Fired, when all plot files of a round were read and verified.
+		 * The argument is the height of the processed block.
+		 */
+		Poco::BasicEvent<Poco::UInt64> roundProcessed;
+
 	private:
+		/**
+		 * \brief Everything of a new round, that is not needed to start reading the plot files.
+		 */
+		struct RoundStart
+		{
+			std::shared_ptr<BlockData> block;
+			std::shared_ptr<BlockData> previousBlock;
+			Poco::UInt64 previousBlockTime = 0;
+			bool previousRoundInterrupted = false;
+		};
+
+		/**
+		 * \brief Finishes the started rounds one after another in the background.
+		 */
+		class RoundBookkeeper : public Poco::ActiveDispatcher
+		{
+		public:
+			explicit RoundBookkeeper(Miner& miner);
+			~RoundBookkeeper() override;
+
+			Poco::ActiveMethod<void, RoundStart, RoundBookkeeper, Poco::ActiveStarter<ActiveDispatcher>> finishRoundStart;
+
+		private:
+			void runFinishRoundStart(const RoundStart& roundStart);
+			Miner& miner_;
+		};
+
+		void startWorkers();
 		bool getMiningInfo();
 		NonceConfirmation submitNonceAsyncImpl(
 			const std::tuple<Poco::UInt64, Poco::UInt64, Poco::UInt64, Poco::UInt64, std::string, bool>& data);
@@ -103,20 +154,26 @@ namespace Burst
 		void progressChanged(float& progress);
 		void on_wake_up(Poco::Timer& timer);
 		void onBenchmark(Poco::Timer& timer);
+		void onCheckpoint(Poco::Timer& timer);
+		void restoreCheckpoint(const std::vector<RoundCheckpoint::SavedDeadline>& deadlines);
 		void onRoundProcessed(Poco::UInt64 blockHeight, double roundTime);
+		void finishRoundStart(const RoundStart& roundStart);
+		Poco::UInt64 getRoundBudget() const;
 
-		bool running_ = false, restart_ = false, isProcessing_ = false;
+		bool running_ = false, restart_ = false, isProcessing_ = false, offline_ = false;
 		MinerData data_;
 		std::shared_ptr<PlotReadProgress> progressRead_, progressVerify_;
 		std::unique_ptr<Poco::Net::HTTPClientSession> miningInfoSession_;
 		Accounts accounts_;
 		Wallet wallet_;
-		std::unique_ptr<Poco::TaskManager> nonceSubmitterManager_, plot_reader_, verifier_;
+		std::unique_ptr<Poco::TaskManager> nonceSubmitterManager_, plot_reader_, verifier_, gpu_verifier_, checksum_builder_;
 		Poco::NotificationQueue plotReadQueue_;
-		Poco::NotificationQueue verificationQueue_;
-		std::unique_ptr<Poco::ThreadPool> verifier_pool_, plot_reader_pool_;
-		Poco::Timer wake_up_timer_, benchmark_timer_;
+		Poco::NotificationQueue verificationQueue_, gpuVerificationQueue_;
+		std::unique_ptr<Poco::ThreadPool> verifier_pool_, gpu_verifier_pool_, plot_reader_pool_, checksum_builder_pool_;
+		Poco::Timer wake_up_timer_, benchmark_timer_, checkpoint_timer_;
 		mutable Poco::Mutex worker_mutex_;
 		std::chrono::high_resolution_clock::time_point startPoint_;
+		// declared last, so that it is stopped before the data it works on is destroyed
+		std::unique_ptr<RoundBookkeeper> roundBookkeeper_;
 	};
 }
@@ -171,9 +171,6 @@ Burst::MinerCL::~MinerCL()
 		}
 	}
 
-	if (kernel_calculate_deadlines_ != nullptr)
-		clReleaseKernel(kernel_calculate_deadlines_);
-
 	if (program_ != nullptr)
 		clReleaseProgram(program_);
 
@@ -301,63 +298,6 @@ bool Burst::MinerCL::create(unsigned platformIdx, unsigned deviceIdx)
 		}
 	}
 
-	// create kernel
-	{
-		cl_int ret;
-		kernel_calculate_deadlines_ = clCreateKernel(program_, "calculate_deadlines", &ret);
-
-		if (ret != CL_SUCCESS)
-		{
-			log_fatal(MinerLogger::miner, "Could not create the OpenCL kernel 'calculate_deadlines'!\n\tError-code:\t%d", ret);
-			return false;
-		}
-
-		kernel_best_deadline_ = clCreateKernel(program_, "reduce_best", &ret);
-
-		if (ret != CL_SUCCESS)
-		{
-			log_fatal(MinerLogger::miner, "Could not create the OpenCL kernel 'reduce_best'!\n\tError-code:\t%d", ret);
-			return false;
-		}
-	}
-
-	// get work group size
-	{
-		auto ret = clGetKernelWorkGroupInfo(kernel_calculate_deadlines_, *getDeviceId(),
-		                                    CL_KERNEL_WORK_GROUP_SIZE,
-		                                    sizeof(kernel_Calculate_WorkGroupSize_), &kernel_Calculate_WorkGroupSize_,
-		                                    nullptr);
-
-		if (ret == CL_SUCCESS)
-			ret = clGetKernelWorkGroupInfo(kernel_calculate_deadlines_, *getDeviceId(),
-			                               CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE,
-			                               sizeof(kernel_Calculate_PrefferedWorkGroupSize_), &kernel_Calculate_PrefferedWorkGroupSize_,
-			                               nullptr);
-
-		if (ret != CL_SUCCESS)
-		{
-			log_fatal(MinerLogger::miner, "Could not get the maximum work group size for the kernel calculate deadlines!");
-			return false;
-		}
-
-		ret = clGetKernelWorkGroupInfo(kernel_best_deadline_, *getDeviceId(),
-		                               CL_KERNEL_WORK_GROUP_SIZE,
-		                               sizeof(kernel_FindBest_WorkGroupSize_), &kernel_FindBest_WorkGroupSize_,
-		                               nullptr);
-
-		if (ret == CL_SUCCESS)
-			ret = clGetKernelWorkGroupInfo(kernel_best_deadline_, *getDeviceId(),
-			                               CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE,
-			                               sizeof(kernel_FindBest_PrefferedWorkGroupSize_), &kernel_FindBest_PrefferedWorkGroupSize_,
-			                               nullptr);
-
-		if (ret != CL_SUCCESS)
-		{
-			log_fatal(MinerLogger::miner, "Could not get the maximum work group size for the kernel find best deadline!");
-			return false;
-		}
-	}
-
 	// compute units
 	{
 		const auto ret = clGetDeviceInfo(*getDeviceId(), CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(size_t), &compute_units_, nullptr);
@@ -401,26 +341,6 @@ cl_context Burst::MinerCL::getContext() const
 	return context_;
 }
 
-cl_kernel Burst::MinerCL::getKernel_Calculate() const
-{
-	return kernel_calculate_deadlines_;
-}
-
-cl_kernel Burst::MinerCL::getKernel_GetMin() const
-{
-	return kernel_best_deadline_;
-}
-
-size_t Burst::MinerCL::getKernelCalculateWorkGroupSize(const bool preferred) const
-{
-	return preferred ? kernel_Calculate_PrefferedWorkGroupSize_ : kernel_Calculate_WorkGroupSize_;
-}
-
-size_t Burst::MinerCL::getKernelFindBestWorkGroupSize(const bool preferred) const
-{
-	return preferred ? kernel_FindBest_PrefferedWorkGroupSize_ : kernel_FindBest_WorkGroupSize_;
-}
-
 size_t Burst::MinerCL::getComputeUnits() const
 {
 	return compute_units_;
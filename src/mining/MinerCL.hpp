@@ -76,10 +76,6 @@ namespace Burst
 
 		cl_context getContext() const;
 		cl_program getProgram() const;
-		cl_kernel getKernel_Calculate() const;
-		cl_kernel getKernel_GetMin() const;
-		size_t getKernelCalculateWorkGroupSize(bool preferred = false) const;
-		size_t getKernelFindBestWorkGroupSize(bool preferred = false) const;
 		size_t getComputeUnits() const;
 		const ClPlatform* getPlatform() const;
 		const cl_device_id* getDeviceId() const;
@@ -94,15 +90,9 @@ namespace Burst
 		cl_context context_ = nullptr;
 		cl_program program_ = nullptr;
 		std::vector<cl_command_queue> command_queues_;
-		cl_kernel kernel_calculate_deadlines_ = nullptr,
-			kernel_best_deadline_ = nullptr;
 		bool initialized_ = false;
 		std::vector<ClPlatform> platforms_;
 		unsigned platformIdx_ = 0, deviceIdx_ = 0;
-		size_t kernel_Calculate_WorkGroupSize_ = 0;
-		size_t kernel_FindBest_WorkGroupSize_ = 0;
-		size_t kernel_Calculate_PrefferedWorkGroupSize_ = 0;
-		size_t kernel_FindBest_PrefferedWorkGroupSize_ = 0;
 		size_t compute_units_ = 0;
 	};
 }
@@ -37,6 +37,8 @@
 #include "logging/Output.hpp"
 #include "plots/PlotReader.hpp"
 #include "plots/Plot.hpp"
+#include "plots/IoScheduler.hpp"
+#include "plots/CpuBudget.hpp"
 #include <Poco/FileStream.h>
 #include <Poco/JSON/PrintHandler.h>
 #include <Poco/StringTokenizer.h>
@@ -153,8 +155,36 @@ void Burst::MinerConfig::printConsole() const
 
 	log_system(MinerLogger::config, "Processor type : %s", getConfig().getProcessorType());
 
-	if (getConfig().getProcessorType() == "CPU")
+	if (getConfig().getProcessorType() == "CPU" || getConfig().getProcessorType() == "HYBRID")
 		log_system(MinerLogger::config, "CPU instruction set : %s", getConfig().getCpuInstructionSet());
+
+	if (getConfig().getProcessorType() == "HYBRID")
+		log_system(MinerLogger::config, "GPU verifiers : %u", getConfig().getGpuVerifiers());
+
+	const auto printCpus = [](const std::string& name, const std::vector<unsigned>& cpus)
+	{
+		if (cpus.empty())
+			return;
+
+		std::stringstream sstream;
+
+		for (size_t i = 0; i < cpus.size(); ++i)
+			sstream << (i > 0 ? "," : "") << cpus[i];
+
+		log_system(MinerLogger::config, "%s cpus : %s", name, sstream.str());
+	};
+
+	if (getHugePageMode() != HugePageMode::Off)
+		log_system(MinerLogger::config, "Hugepages : %s", HugePages::toString(getHugePageMode()));
+
+	if (getCpuBudget() > 0)
+		log_system(MinerLogger::config, "Cpu budget : %u%%", getCpuBudget());
+
+	if (isPlotChecksums())
+		log_system(MinerLogger::config, "Plot checksums : on");
+
+	printCpus("Plot reader", getReaderCpus());
+	printCpus("Plot verifier", getVerifierCpus());
 	
 	if (getConfig().isBenchmark())
 		log_warning(MinerLogger::config, "Benchmark mode activated!");
@@ -485,6 +515,23 @@ Burst::ReadConfigFileResult Burst::MinerConfig::readConfigFile(const std::string
 		bufferChunkCount_ = getOrAdd(miningObj, "bufferChunkCount", 8);
 		wakeUpTime_ = getOrAdd(miningObj, "wakeUpTime", 0);
 
+		// smart wake up
+		{
+			Poco::JSON::Object::Ptr smartWakeUpObj;
+
+			if (miningObj->has("smartWakeUp"))
+				smartWakeUpObj = miningObj->get("smartWakeUp").extract<Poco::JSON::Object::Ptr>();
+			else
+				smartWakeUpObj = new Poco::JSON::Object;
+
+			smartWakeUp_ = getOrAdd(smartWakeUpObj, "enabled", false);
+			wakeUpProbability_ = getOrAdd(smartWakeUpObj, "probability", 0.3);
+			wakeUpMargin_ = getOrAdd(smartWakeUpObj, "margin", 5.);
+
+			miningObj->set("smartWakeUp", smartWakeUpObj);
+		}
+		checkpointInterval_ = getOrAdd(miningObj, "checkpointInterval", 30);
+
 		cpuInstructionSet_ = Poco::toUpper(getOrAdd(miningObj, "cpuInstructionSet", std::string("SSE2")));
 		cpuInstructionSet_ = Poco::trim(cpuInstructionSet_);
 
@@ -506,10 +553,52 @@ Burst::ReadConfigFileResult Burst::MinerConfig::readConfigFile(const std::string
 
 		Settings::setCpuInstructionSet(cpuInstructionSet_);
 
+		// the chunk buffers can be backed by hugepages
+		hugePageMode_ = HugePages::fromString(getOrAdd(miningObj, "hugePages", std::string("off")));
+		HugePages::setMode(hugePageMode_);
+
+		// the background work on the plot devices
+		{
+			Poco::JSON::Object::Ptr ioSchedulerObj;
+
+			if (miningObj->has("ioScheduler"))
+				ioSchedulerObj = miningObj->get("ioScheduler").extract<Poco::JSON::Object::Ptr>();
+			else
+				ioSchedulerObj = new Poco::JSON::Object;
+
+			integrityCheckRate_ = getOrAdd(ioSchedulerObj, "integrityRate", 0);
+			plottingRate_ = getOrAdd(ioSchedulerObj, "plottingRate", 0);
+
+			IoScheduler::setRate(IoPriority::Integrity, integrityCheckRate_ * 1024 * 1024);
+			IoScheduler::setRate(IoPriority::Plotting, plottingRate_ * 1024 * 1024);
+
+			miningObj->set("ioScheduler", ioSchedulerObj);
+		}
+
+		// the health of the plot devices
+		{
+			Poco::JSON::Object::Ptr healthObj;
+
+			if (miningObj->has("health"))
+				healthObj = miningObj->get("health").extract<Poco::JSON::Object::Ptr>();
+			else
+				healthObj = new Poco::JSON::Object;
+
+			healthPolicy_ = PlotHealth::fromString(getOrAdd(healthObj, "policy", std::string("deprioritize")));
+			slowRead_ = getOrAdd(healthObj, "slowRead", 1000u);
+			quarantineRounds_ = getOrAdd(healthObj, "quarantineRounds", 10u);
+
+			PlotHealth::setPolicy(healthPolicy_, slowRead_ / 1000., quarantineRounds_);
+
+			miningObj->set("health", healthObj);
+		}
+
 		processorType_ = getOrAdd(miningObj, "processorType", std::string("CPU"));
 
 		gpuPlatform_ = getOrAdd(miningObj, "gpuPlatform", 0u);
 		gpuDevice_ = getOrAdd(miningObj, "gpuDevice", 0u);
+		gpuBuffers_ = std::max(2u, getOrAdd(miningObj, "gpuBuffers", 2u));
+		gpuVerifiers_ = std::max(1u, getOrAdd(miningObj, "gpuVerifiers", 2u));
 
 		// benchmark
 		{
@@ -520,12 +609,110 @@ Burst::ReadConfigFileResult Burst::MinerConfig::readConfigFile(const std::string
 			else
 				benchmarkObj = new Poco::JSON::Object;
 
+			const std::string defaultBenchmarkGensig = "5a2c1d9e6b3f8a7c4e0d2b9f1a6c3e8d7b4f0a5c2e9d1b6f3a8c7e4d0b2f9a1c";
+
 			benchmark_ = getOrAdd(benchmarkObj, "active", false);
 			benchmarkInterval_ = getOrAdd(benchmarkObj, "interval", 60l);
+			benchmarkRounds_ = getOrAdd(benchmarkObj, "rounds", 5u);
+			benchmarkHeight_ = getOrAdd(benchmarkObj, "height", Poco::UInt64{500000});
+			benchmarkBaseTarget_ = getOrAdd(benchmarkObj, "baseTarget", Poco::UInt64{50000});
+			benchmarkGensig_ = getOrAdd(benchmarkObj, "gensig", defaultBenchmarkGensig);
+			benchmarkReportPath_ = getOrAdd(benchmarkObj, "report", std::string("benchmark.json"));
+
+			if (benchmarkGensig_.size() != Settings::HashSize * 2)
+			{
+				log_warning(MinerLogger::config, "The benchmark gensig needs to have %u hex characters, using the default one",
+					static_cast<unsigned>(Settings::HashSize * 2));
+				benchmarkGensig_ = defaultBenchmarkGensig;
+			}
 
 			miningObj->set("benchmark", benchmarkObj);
 		}
 
+		roundBudget_ = getOrAdd(miningObj, "roundBudget", 0u);
+		roundBudgetAuto_ = getOrAdd(miningObj, "roundBudgetAuto", false);
+		cpuBudget_ = getOrAdd(miningObj, "cpuBudget", 0u);
+		CpuBudget::setShare(cpuBudget_);
+		plotChecksums_ = getOrAdd(miningObj, "plotChecksums", false);
+		topDeadlines_ = getOrAdd(miningObj, "topDeadlines", 0u);
+
+		// progressive reading
+		{
+			Poco::JSON::Object::Ptr progressiveObj;
+
+			if (miningObj->has("progressiveReading"))
+				progressiveObj = miningObj->get("progressiveReading").extract<Poco::JSON::Object::Ptr>();
+			else
+				progressiveObj = new Poco::JSON::Object;
+
+			progressiveReading_ = getOrAdd(progressiveObj, "active", false);
+			progressiveStripes_ = getOrAdd(progressiveObj, "stripes", 16u);
+
+			if (progressiveStripes_ == 0)
+				progressiveStripes_ = 1;
+
+			miningObj->set("progressiveReading", progressiveObj);
+		}
+
+		// cpu affinity
+		{
+			Poco::JSON::Object::Ptr affinityObj;
+
+			if (miningObj->has("affinity"))
+				affinityObj = miningObj->get("affinity").extract<Poco::JSON::Object::Ptr>();
+			else
+				affinityObj = new Poco::JSON::Object;
+
+			readerCpuList_ = getOrAdd(affinityObj, "readerCpus", std::string(""));
+			verifierCpuList_ = getOrAdd(affinityObj, "verifierCpus", std::string(""));
+			readerNumaNode_ = getOrAdd(affinityObj, "readerNode", -1);
+			verifierNumaNode_ = getOrAdd(affinityObj, "verifierNode", -1);
+
+			// an explicit list of cpus wins over the cpus of a NUMA node
+			const auto resolveCpus = [](const std::string& cpuList, const int numaNode, const std::string& name)
+			{
+				std::vector<unsigned> cpus;
+
+				if (!cpuList.empty())
+				{
+					cpus = parseCpuList(cpuList);
+
+					if (cpus.empty())
+						log_warning(MinerLogger::config, "Invalid %s cpus '%s', the threads are not pinned", name, cpuList);
+				}
+				else if (numaNode >= 0)
+				{
+					cpus = getNumaNodeCpus(static_cast<unsigned>(numaNode));
+
+					if (cpus.empty())
+						log_warning(MinerLogger::config, "Could not determine the cpus of NUMA node %d, the %s threads are not pinned",
+							numaNode, name);
+				}
+
+				return cpus;
+			};
+
+			readerCpus_ = resolveCpus(readerCpuList_, readerNumaNode_, "reader");
+			verifierCpus_ = resolveCpus(verifierCpuList_, verifierNumaNode_, "verifier");
+
+			miningObj->set("affinity", affinityObj);
+		}
+
+		// account cache
+		{
+			Poco::JSON::Object::Ptr accountCacheObj;
+
+			if (miningObj->has("accountCache"))
+				accountCacheObj = miningObj->get("accountCache").extract<Poco::JSON::Object::Ptr>();
+			else
+				accountCacheObj = new Poco::JSON::Object;
+
+			accountMetadataTtl_ = getOrAdd(accountCacheObj, "metadataTtl", 86400);
+			wonBlocksTtl_ = getOrAdd(accountCacheObj, "wonBlocksTtl", 600);
+
+			miningObj->set("accountCache", accountCacheObj);
+		}
+
 		// urls
 		{
 			Poco::JSON::Object::Ptr urlsObj;
@@ -571,6 +758,7 @@ Burst::ReadConfigFileResult Burst::MinerConfig::readConfigFile(const std::string
 						{
 							const auto sequential = "sequential";
 							const auto parallel = "parallel";
+							const auto virtualDir = "virtual";
 
 							auto plotJson = plot.extract<Poco::JSON::Object::Ptr>();
 							auto type = PlotDir::Type::Sequential;
@@ -581,6 +769,23 @@ Burst::ReadConfigFileResult Burst::MinerConfig::readConfigFile(const std::string
 							
 							if (path.isEmpty())
 								log_error(MinerLogger::config, "Empty dir given as plot dir/file! Skipping it...");
+							// virtual plot dir, the plot files are generated while reading
+							else if (typeStr == virtualDir)
+							{
+								VirtualPlotSettings virtualSettings;
+								virtualSettings.account = plotJson->optValue<Poco::UInt64>("account", 0);
+								virtualSettings.startNonce = plotJson->optValue<Poco::UInt64>("startNonce", 0);
+								virtualSettings.nonces = plotJson->optValue<Poco::UInt64>("nonces", 8192);
+								virtualSettings.files = plotJson->optValue<unsigned>("files", 1);
+								virtualSettings.realNonces = plotJson->optValue<bool>("realNonces", false);
+								virtualSettings.seekLatency = plotJson->optValue<double>("seekLatency", 0.);
+								virtualSettings.throughput = plotJson->optValue<double>("throughput", 0.);
+
+								if (virtualSettings.nonces == 0 || virtualSettings.files == 0)
+									log_error(MinerLogger::config, "Virtual plot dir %s has no nonces! Skipping it...", path.toString());
+								else
+									plotDirs_.emplace_back(new PlotDir{ path.toString(), virtualSettings });
+							}
 							else if (typeStr.empty())
 								log_error(MinerLogger::config, "Invalid type of plot dir/file %s! Skipping it...", path.toString());
 							else if (typeStr != sequential && typeStr != parallel)
@@ -1363,6 +1568,36 @@ unsigned Burst::MinerConfig::getWalletRequestRetryWaitTime() const
 	return walletRequestRetryWaitTime_;
 }
 
+bool Burst::MinerConfig::isSmartWakeUp() const
+{
+	return smartWakeUp_;
+}
+
+double Burst::MinerConfig::getWakeUpProbability() const
+{
+	return wakeUpProbability_;
+}
+
+double Burst::MinerConfig::getWakeUpMargin() const
+{
+	return wakeUpMargin_;
+}
+
+unsigned Burst::MinerConfig::getCheckpointInterval() const
+{
+	return checkpointInterval_;
+}
+
+unsigned Burst::MinerConfig::getAccountMetadataTtl() const
+{
+	return accountMetadataTtl_;
+}
+
+unsigned Burst::MinerConfig::getWonBlocksTtl() const
+{
+	return wonBlocksTtl_;
+}
+
 unsigned Burst::MinerConfig::getWakeUpTime() const
 {
 	return wakeUpTime_;
@@ -1388,6 +1623,81 @@ long Burst::MinerConfig::getBenchmarkInterval() const
 	return benchmarkInterval_;
 }
 
+unsigned Burst::MinerConfig::getBenchmarkRounds() const
+{
+	return benchmarkRounds_;
+}
+
+Poco::UInt64 Burst::MinerConfig::getBenchmarkHeight() const
+{
+	return benchmarkHeight_;
+}
+
+Poco::UInt64 Burst::MinerConfig::getBenchmarkBaseTarget() const
+{
+	return benchmarkBaseTarget_;
+}
+
+const std::string& Burst::MinerConfig::getBenchmarkGensig() const
+{
+	return benchmarkGensig_;
+}
+
+const std::string& Burst::MinerConfig::getBenchmarkReportPath() const
+{
+	return benchmarkReportPath_;
+}
+
+unsigned Burst::MinerConfig::getRoundBudget() const
+{
+	return roundBudget_;
+}
+
+bool Burst::MinerConfig::isRoundBudgetAuto() const
+{
+	return roundBudgetAuto_;
+}
+
+unsigned Burst::MinerConfig::getCpuBudget() const
+{
+	return cpuBudget_;
+}
+
+bool Burst::MinerConfig::isPlotChecksums() const
+{
+	return plotChecksums_;
+}
+
+unsigned Burst::MinerConfig::getTopDeadlines() const
+{
+	return topDeadlines_;
+}
+
+bool Burst::MinerConfig::isProgressiveReading() const
+{
+	return progressiveReading_;
+}
+
+unsigned Burst::MinerConfig::getProgressiveStripes() const
+{
+	return progressiveStripes_;
+}
+
+Burst::HugePageMode Burst::MinerConfig::getHugePageMode() const
+{
+	return hugePageMode_;
+}
+
+const std::vector<unsigned>& Burst::MinerConfig::getReaderCpus() const
+{
+	return readerCpus_;
+}
+
+const std::vector<unsigned>& Burst::MinerConfig::getVerifierCpus() const
+{
+	return verifierCpus_;
+}
+
 unsigned Burst::MinerConfig::getGpuPlatform() const
 {
 	return gpuPlatform_;
@@ -1398,6 +1708,16 @@ unsigned Burst::MinerConfig::getGpuDevice() const
 	return gpuDevice_;
 }
 
+unsigned Burst::MinerConfig::getGpuBuffers() const
+{
+	return gpuBuffers_;
+}
+
+unsigned Burst::MinerConfig::getGpuVerifiers() const
+{
+	return gpuVerifiers_;
+}
+
 void Burst::MinerConfig::printTargetDeadline() const
 {
 	if (getTargetDeadline() > 0)
@@ -1479,10 +1799,22 @@ bool Burst::MinerConfig::save(const std::string& path) const
 		mining.set("rescanEveryBlock", isRescanningEveryBlock());
 		mining.set("bufferChunkCount", getBufferChunkCount());
 		mining.set("wakeUpTime", getWakeUpTime());
+
+		// smart wake up
+		{
+			Poco::JSON::Object smartWakeUp;
+			smartWakeUp.set("enabled", isSmartWakeUp());
+			smartWakeUp.set("probability", getWakeUpProbability());
+			smartWakeUp.set("margin", getWakeUpMargin());
+			mining.set("smartWakeUp", smartWakeUp);
+		}
+		mining.set("checkpointInterval", getCheckpointInterval());
 		mining.set("cpuInstructionSet", getCpuInstructionSet());
 		mining.set("processorType", getProcessorType());
 		mining.set("gpuDevice", getGpuDevice());
 		mining.set("gpuPlatform", getGpuPlatform());
+		mining.set("gpuBuffers", getGpuBuffers());
+		mining.set("gpuVerifiers", getGpuVerifiers());
 		mining.set("databasePath", getDatabasePath());
 
 		// benchmark
@@ -1490,9 +1822,64 @@ bool Burst::MinerConfig::save(const std::string& path) const
 			Poco::JSON::Object benchmark;
 			benchmark.set("active", isBenchmark());
 			benchmark.set("interval", getBenchmarkInterval());
+			benchmark.set("rounds", getBenchmarkRounds());
+			benchmark.set("height", getBenchmarkHeight());
+			benchmark.set("baseTarget", getBenchmarkBaseTarget());
+			benchmark.set("gensig", getBenchmarkGensig());
+			benchmark.set("report", getBenchmarkReportPath());
 			mining.set("benchmark", benchmark);
 		}
 
+		mining.set("roundBudget", getRoundBudget());
+		mining.set("roundBudgetAuto", isRoundBudgetAuto());
+		mining.set("cpuBudget", getCpuBudget());
+		mining.set("plotChecksums", isPlotChecksums());
+		mining.set("topDeadlines", getTopDeadlines());
+		mining.set("hugePages", HugePages::toString(getHugePageMode()));
+
+		// the background work on the plot devices
+		{
+			Poco::JSON::Object ioScheduler;
+			ioScheduler.set("integrityRate", integrityCheckRate_);
+			ioScheduler.set("plottingRate", plottingRate_);
+			mining.set("ioScheduler", ioScheduler);
+		}
+
+		// the health of the plot devices
+		{
+			Poco::JSON::Object health;
+			health.set("policy", PlotHealth::toString(healthPolicy_));
+			health.set("slowRead", slowRead_);
+			health.set("quarantineRounds", quarantineRounds_);
+			mining.set("health", health);
+		}
+
+		// progressive reading
+		{
+			Poco::JSON::Object progressive;
+			progressive.set("active", isProgressiveReading());
+			progressive.set("stripes", getProgressiveStripes());
+			mining.set("progressiveReading", progressive);
+		}
+
+		// cpu affinity
+		{
+			Poco::JSON::Object affinity;
+			affinity.set("readerCpus", readerCpuList_);
+			affinity.set("verifierCpus", verifierCpuList_);
+			affinity.set("readerNode", readerNumaNode_);
+			affinity.set("verifierNode", verifierNumaNode_);
+			mining.set("affinity", affinity);
+		}
+
+		// account cache
+		{
+			Poco::JSON::Object accountCache;
+			accountCache.set("metadataTtl", accountMetadataTtl_);
+			accountCache.set("wonBlocksTtl", wonBlocksTtl_);
+			mining.set("accountCache", accountCache);
+		}
+
 		// passphrase
 		{
 			Poco::JSON::Object passphrase;
@@ -1511,7 +1898,27 @@ bool Burst::MinerConfig::save(const std::string& path) const
 		{
 			Poco::JSON::Array plots;
 			for (auto& plot_dir : plotDirs_)
-				plots.add(plot_dir->getPath());
+			{
+				const auto& virtualSettings = plot_dir->getVirtualSettings();
+
+				if (virtualSettings == nullptr)
+				{
+					plots.add(plot_dir->getPath());
+					continue;
+				}
+
+				Poco::JSON::Object virtualDir;
+				virtualDir.set("type", "virtual");
+				virtualDir.set("path", plot_dir->getPath());
+				virtualDir.set("account", virtualSettings->account);
+				virtualDir.set("startNonce", virtualSettings->startNonce);
+				virtualDir.set("nonces", virtualSettings->nonces);
+				virtualDir.set("files", virtualSettings->files);
+				virtualDir.set("realNonces", virtualSettings->realNonces);
+				virtualDir.set("seekLatency", virtualSettings->seekLatency);
+				virtualDir.set("throughput", virtualSettings->throughput);
+				plots.add(virtualDir);
+			}
 			mining.set("plots", plots);
 		}
 
@@ -1771,6 +2178,26 @@ void Burst::MinerConfig::setDatabasePath(std::string databasePath)
 	databasePath_ = std::move(databasePath);
 }
 
+void Burst::MinerConfig::setBenchmarkRounds(const unsigned rounds)
+{
+	Poco::Mutex::ScopedLock lock(mutex_);
+	benchmarkRounds_ = rounds;
+}
+
+void Burst::MinerConfig::setBenchmarkBlock(const std::string& gensig, const Poco::UInt64 height, const Poco::UInt64 baseTarget)
+{
+	Poco::Mutex::ScopedLock lock(mutex_);
+	benchmarkGensig_ = gensig;
+	benchmarkHeight_ = height;
+	benchmarkBaseTarget_ = baseTarget;
+}
+
+void Burst::MinerConfig::setProgressiveReading(const bool progressiveReading)
+{
+	Poco::Mutex::ScopedLock lock(mutex_);
+	progressiveReading_ = progressiveReading;
+}
+
 bool Burst::MinerConfig::addPlotDir(const std::string& dir)
 {
 	return addPlotDir(std::make_shared<PlotDir>(Poco::replace(dir, "\\", "/"), PlotDir::Type::Sequential));
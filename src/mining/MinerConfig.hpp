@@ -29,6 +29,8 @@
 #include <Poco/JSON/Object.h>
 #include <functional>
 #include "Declarations.hpp"
+#include "HugePages.hpp"
+#include "plots/PlotHealth.hpp"
 #include <chrono>
 
 namespace Poco
@@ -199,13 +201,88 @@ namespace Burst
 		std::string getServerPass() const;
 		unsigned getWalletRequestTries() const;
 		unsigned getWalletRequestRetryWaitTime() const;
+
+		/**
+		 * \brief Returns the time in seconds, after which the name and the reward recipient
+		 * of an account are fetched from the wallet again.
+		 */
+		unsigned getAccountMetadataTtl() const;
+
+		/**
+		 * \brief Returns the time in seconds, after which the won blocks
+		 * of an account are fetched from the wallet again.
+		 */
+		unsigned getWonBlocksTtl() const;
 		unsigned getWakeUpTime() const;
+
+		/**
+		 * \brief Returns, if the disks are only woken up, when the next block is expected.
+		 * The wake up time is then the interval for disks, that do not report their power state.
+		 */
+		bool isSmartWakeUp() const;
+
+		/**
+		 * \brief Returns the probability of the next block, from which on a disk is woken up.
+		 */
+		double getWakeUpProbability() const;
+
+		/**
+		 * \brief Returns the seconds, that a disk is woken up earlier than its spin-up time.
+		 */
+		double getWakeUpMargin() const;
+
+		/**
+		 * \brief Returns the interval in seconds, in which the progress of the round is saved.
+		 * A value of 0 disables the checkpoints.
+		 */
+		unsigned getCheckpointInterval() const;
 		const std::string& getCpuInstructionSet() const;
 		const std::string& getProcessorType() const;
 		bool isBenchmark() const;
 		long getBenchmarkInterval() const;
+
+		/**
+		 * \brief Returns the number of rounds of an offline benchmark.
+		 * \return The number of rounds.
+		 */
+		unsigned getBenchmarkRounds() const;
+
+		/**
+		 * \brief Returns the block height of the first round of an offline benchmark.
+		 * Every following round increases the height by one.
+		 * \return The block height.
+		 */
+		Poco::UInt64 getBenchmarkHeight() const;
+
+		/**
+		 * \brief Returns the base target of all rounds of an offline benchmark.
+		 * \return The base target.
+		 */
+		Poco::UInt64 getBenchmarkBaseTarget() const;
+
+		/**
+		 * \brief Returns the generation signature of all rounds of an offline benchmark.
+		 * \return The generation signature as a hex string.
+		 */
+		const std::string& getBenchmarkGensig() const;
+
+		/**
+		 * \brief Returns the path of the report of an offline benchmark.
+		 * \return The path of the JSON report.
+		 */
+		const std::string& getBenchmarkReportPath() const;
 		unsigned getGpuPlatform() const;
 		unsigned getGpuDevice() const;
+		/**
+		 * \brief Returns the number of buffer sets a gpu verifier keeps in flight.
+		 * \return The number of buffer sets, at least 2.
+		 */
+		unsigned getGpuBuffers() const;
+		/**
+		 * \brief Returns the number of gpu verifiers, that run beside the cpu verifiers in hybrid mode.
+		 * \return The number of gpu verifiers.
+		 */
+		unsigned getGpuVerifiers() const;
 		unsigned getMaxConnectionsQueued() const;
 		unsigned getMaxConnectionsActive() const;
 		bool isForwardingEverything() const;
@@ -214,6 +291,77 @@ namespace Burst
 		bool isForwardingMinerName() const;
 		Poco::UInt64 getPoc2StartBlock() const;
 
+		/**
+		 * \brief Returns the time budget of a round.
+		 * When the budget is exceeded, the remaining plots of the round are not read anymore.
+		 * \return The budget in seconds, 0 if unlimited.
+		 */
+		unsigned getRoundBudget() const;
+
+		/**
+		 * \brief Returns, if the time budget of a round is the expected block time.
+		 * The expected block time is the mean of the last block times, the round budget is
+		 * only used as long as there is no block time history.
+		 * \return true, if the budget is derived from the block times, false otherwise.
+		 */
+		bool isRoundBudgetAuto() const;
+
+		/**
+		 * \brief Returns the share of all cpus, that the plot verifiers may use.
+		 * \return The share in percent, 0 if unlimited.
+		 */
+		unsigned getCpuBudget() const;
+
+		/**
+		 * \brief Returns, if the plotfiles get a checksum sidecar, that is checked while reading.
+		 * The missing sidecars are written in the background.
+		 */
+		bool isPlotChecksums() const;
+
+		/**
+		 * \brief Returns the number of the best deadlines per account and round, that are stored in the database.
+		 * \return The number of deadlines, 0 if they are not collected.
+		 */
+		unsigned getTopDeadlines() const;
+
+		/**
+		 * \brief Returns, if the plot files of a plot directory are read progressively.
+		 * Instead of reading file by file, stripes across all files are read, so that the
+		 * whole capacity is sampled early in a round.
+		 * The stripes are read per notification, so parallel plot directories, that are read file by file,
+		 * are not striped across their files.
+		 * \return true, if the plot files are read progressively, false otherwise.
+		 */
+		bool isProgressiveReading() const;
+
+		/**
+		 * \brief Returns the number of stripes, in which the plot files are read progressively.
+		 * \return The number of stripes.
+		 */
+		unsigned getProgressiveStripes() const;
+
+		/**
+		 * \brief Returns, how the chunk buffers are backed by hugepages.
+		 * \return The hugepage mode.
+		 */
+		HugePageMode getHugePageMode() const;
+
+		/**
+		 * \brief Returns the cpus, to which the plot reader threads are pinned.
+		 * Either the configured cpu list or the cpus of the configured NUMA node.
+		 * Pinning the readers next to the storage controller also places the chunk buffers
+		 * on that node, because they are first touched by the reader.
+		 * \return The cpu indices, empty if the readers are not pinned.
+		 */
+		const std::vector<unsigned>& getReaderCpus() const;
+
+		/**
+		 * \brief Returns the cpus, to which the plot verifier threads are pinned.
+		 * Every verifier is pinned to one of the cpus, round robin.
+		 * \return The cpu indices, empty if the verifiers are not pinned.
+		 */
+		const std::vector<unsigned>& getVerifierCpus() const;
+
 		void setUrl(std::string url, HostType hostType);
 		void setBufferSize(Poco::UInt64 bufferSize);
 		void setMaxHistoricalBlocks(Poco::UInt64 maxHistData);
@@ -239,6 +387,9 @@ namespace Burst
 		void setWebserverCredentials(const std::string& user, const std::string& pass);
 		void setStartWebserver(bool start);
 		void setDatabasePath(std::string databasePath);
+		void setBenchmarkRounds(unsigned rounds);
+		void setBenchmarkBlock(const std::string& gensig, Poco::UInt64 height, Poco::UInt64 baseTarget);
+		void setProgressiveReading(bool progressiveReading);
 
 		/**
 		 * \brief Instructs the miner wether he should use a logfile.
@@ -305,6 +456,8 @@ namespace Burst
 		unsigned bufferChunkCount_ = 16;
 		unsigned walletRequestTries_ = 3;
 		unsigned walletRequestRetryWaitTime_ = 3;
+		unsigned accountMetadataTtl_ = 86400;
+		unsigned wonBlocksTtl_ = 600;
 		Passphrase passphrase_ = {};
 		bool useInsecurePlotfiles_ = false;
 		bool logfile_ = false;
@@ -315,11 +468,22 @@ namespace Burst
 		bool steadyProgressBar_ = true;
 		bool fancyProgressBar_ = true;
 		unsigned wakeUpTime_ = 0;
+		bool smartWakeUp_ = false;
+		double wakeUpProbability_ = 0.3;
+		double wakeUpMargin_ = 5.;
+		unsigned checkpointInterval_ = 30;
 		std::string cpuInstructionSet_ = "AUTO";
 		std::string processorType_ = "CPU";
 		bool benchmark_ = false;
 		long benchmarkInterval_ = 60;
+		unsigned benchmarkRounds_ = 5;
+		Poco::UInt64 benchmarkHeight_ = 500000;
+		Poco::UInt64 benchmarkBaseTarget_ = 50000;
+		std::string benchmarkGensig_;
+		std::string benchmarkReportPath_ = "benchmark.json";
 		unsigned gpuPlatform_ = 0, gpuDevice_ = 0;
+		unsigned gpuBuffers_ = 2;
+		unsigned gpuVerifiers_ = 2;
 		unsigned maxConnectionsQueued_ = 64, maxConnectionsActive_ = 32;
 		std::vector<std::string> forwardingWhitelist_;
 		bool cumulatePlotsizes_ = true;
@@ -329,6 +493,23 @@ namespace Burst
 		std::string serverCertificatePass_;
 		std::string databasePath_;
 		Poco::UInt64 poc2StartBlock_ = 0;
+		unsigned roundBudget_ = 0;
+		bool roundBudgetAuto_ = false;
+		unsigned cpuBudget_ = 0;
+		bool plotChecksums_ = false;
+		unsigned topDeadlines_ = 0;
+		bool progressiveReading_ = false;
+		unsigned progressiveStripes_ = 16;
+		HugePageMode hugePageMode_ = HugePageMode::Off;
+		// MB/s, 0 for no limit
+		Poco::UInt64 integrityCheckRate_ = 0;
+		Poco::UInt64 plottingRate_ = 0;
+		HealthPolicy healthPolicy_ = HealthPolicy::Deprioritize;
+		unsigned slowRead_ = 1000;
+		unsigned quarantineRounds_ = 10;
+		std::string readerCpuList_, verifierCpuList_;
+		int readerNumaNode_ = -1, verifierNumaNode_ = -1;
+		std::vector<unsigned> readerCpus_, verifierCpus_;
 		mutable Poco::Mutex mutex_;
 	};
 }
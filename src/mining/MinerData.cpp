@@ -27,6 +27,8 @@
 #include "MinerUtil.hpp"
 #include "wallet/Wallet.hpp"
 #include "wallet/Account.hpp"
+#include "plots/PlotHealth.hpp"
+#include <sstream>
 
 using namespace Poco::Data::Keywords;
 
@@ -39,6 +41,10 @@ Burst::BlockData::BlockData(const Poco::UInt64 blockHeight, const Poco::UInt64 b
 	  parent_{parent}
 {
 	entries_ = std::make_shared<std::vector<Poco::JSON::Object>>();
+
+	if (MinerConfig::getConfig().getTopDeadlines() > 0)
+		topDeadlines_ = std::make_shared<TopDeadlines>(MinerConfig::getConfig().getTopDeadlines());
+
 	//deadlines_ = std::make_shared<std::unordered_map<AccountId, Deadlines>>();
 
 	for (auto i = 0; i < 32; ++i)
@@ -192,12 +198,28 @@ void Burst::BlockData::refreshBlockEntry() const
 
 void Burst::BlockData::refreshConfig() const
 {
-	addBlockEntry(createJsonConfig());
+	addBlockEntryIfChanged(createJsonConfig(), jsonConfig_);
 }
 
 void Burst::BlockData::refreshPlotDirs() const
 {
-	addBlockEntry(createJsonPlotDirsRescan());
+	addBlockEntryIfChanged(createJsonPlotDirsRescan(), jsonPlotDirs_);
+}
+
+void Burst::BlockData::refreshHealth() const
+{
+	addBlockEntry(PlotHealth::toJSON());
+}
+
+void Burst::BlockData::addCorruptedRegion(const std::string& plotFile, const CorruptedRegion& region) const
+{
+	Poco::JSON::Object json;
+	json.set("type", "plot-corrupted");
+	json.set("plotfile", plotFile);
+	json.set("scoop", region.scoop);
+	json.set("startNonce", region.startNonce);
+	json.set("nonces", region.nonces);
+	addBlockEntry(json);
 }
 
 void Burst::BlockData::setProgress(float progressRead, float progressVerification, Poco::UInt64 blockheight)
@@ -205,10 +227,8 @@ void Burst::BlockData::setProgress(float progressRead, float progressVerificatio
 	if (blockheight != getBlockheight())
 		return;
 
-	{
-		std::lock_guard<std::mutex> lock{ mutex_ };
-		jsonProgress_ = new Poco::JSON::Object{createJsonProgress(progressRead, progressVerification)};
-	}
+	std::lock_guard<std::mutex> lock{ mutex_ };
+	jsonProgress_ = new Poco::JSON::Object{createJsonProgress(progressRead, progressVerification)};
 
 	if (parent_ != nullptr)
 		parent_->blockDataChangedEvent.notify(this, *jsonProgress_);
@@ -237,15 +257,33 @@ void Burst::BlockData::setRoundTime(double rTime)
 
 void Burst::BlockData::addBlockEntry(Poco::JSON::Object entry) const
 {
-	{
-		std::lock_guard<std::mutex> lock{ mutex_ };
-		entries_->emplace_back(entry);	
-	}
+	// the entry gets its sequence number for the websockets under the same lock,
+	// so a snapshot of the entries knows, which changes it contains
+	std::lock_guard<std::mutex> lock{ mutex_ };
+	entries_->emplace_back(entry);
 	
 	if (parent_ != nullptr)
 		parent_->blockDataChangedEvent.notify(this, entry);
 }
 
+void Burst::BlockData::addBlockEntryIfChanged(Poco::JSON::Object entry, std::string& last) const
+{
+	std::stringstream sstream;
+	entry.stringify(sstream);
+
+	{
+		std::lock_guard<std::mutex> lock{ mutex_ };
+
+		// the clients already know this state
+		if (sstream.str() == last)
+			return;
+
+		last = sstream.str();
+	}
+
+	addBlockEntry(entry);
+}
+
 Poco::UInt64 Burst::BlockData::getBlockheight() const
 {
 	return blockHeight_.load();
@@ -326,7 +364,8 @@ std::shared_ptr<Burst::Deadline> Burst::BlockData::getBestDeadline(const Deadlin
 	return bestDeadline;
 }
 
-bool Burst::BlockData::forEntries(std::function<bool(const Poco::JSON::Object&)> traverseFunction) const
+bool Burst::BlockData::forEntries(std::function<bool(const Poco::JSON::Object&)> traverseFunction,
+	std::function<void()> finishFunction) const
 {
 	std::lock_guard<std::mutex> lock{mutex_};
 
@@ -347,6 +386,9 @@ bool Burst::BlockData::forEntries(std::function<bool(const Poco::JSON::Object&)>
 		for (auto iter = jsonDirProgress_.begin(); !error && iter != jsonDirProgress_.end(); ++iter)
 			error = !traverseFunction(*iter->second);
 
+	if (finishFunction)
+		finishFunction();
+
 	return error;
 }
 
@@ -388,6 +430,12 @@ std::shared_ptr<Burst::Deadline> Burst::BlockData::getBestDeadline(Poco::UInt64
 	return getBestDeadlineUnlocked(accountId, searchType);
 }
 
+std::shared_ptr<Burst::TopDeadlines> Burst::BlockData::getTopDeadlines() const
+{
+	// it is only set in the constructor
+	return topDeadlines_;
+}
+
 Poco::ActiveResult<std::shared_ptr<Burst::Account>> Burst::BlockData::getLastWinnerAsync(const Wallet& wallet, Accounts& accounts)
 {
 	return DataLoader::getInstance().getLastWinner(make_tuple(std::cref(wallet), std::ref(accounts), std::ref(*this)));
@@ -427,10 +475,10 @@ void Burst::BlockData::addMessage(const Poco::Message& message) const
 		json.set("time", Poco::DateTimeFormatter::format(Poco::LocalDateTime(message.getTime()), "%H:%M:%S"));
 
 		entries_->emplace_back(json);
-	}
 
-	if (parent_ != nullptr)
-		parent_->blockDataChangedEvent.notify(this, json);
+		if (parent_ != nullptr)
+			parent_->blockDataChangedEvent.notify(this, json);
+	}
 }
 
 void Burst::BlockData::clearEntries() const
@@ -499,6 +547,19 @@ Burst::MinerData::MinerData()
 			"	blockTime		REAL NOT NULL," <<
 			"	PRIMARY KEY (id)" <<
 			")", now;
+
+		*dbSession_ <<
+			"CREATE TABLE IF NOT EXISTS top_deadline (" <<
+			"	height			INTEGER NOT NULL," <<
+			"	account			INTEGER NOT NULL," <<
+			"	rank			INTEGER NOT NULL," <<
+			"	nonce			INTEGER NOT NULL," <<
+			"	value			INTEGER NOT NULL," <<
+			"	file			TEXT NOT NULL," <<
+			"	PRIMARY KEY (height, account, rank)" <<
+			")", now;
+
+		checkpoint_ = std::make_unique<RoundCheckpoint>(databasePath);
 	}
 	catch (Poco::Exception& e)
 	{
@@ -511,62 +572,67 @@ Burst::MinerData::~MinerData() = default;
 std::shared_ptr<Burst::BlockData> Burst::MinerData::startNewBlock(Poco::UInt64 block, Poco::UInt64 baseTarget,
                                                                   const std::string& genSig,
                                                                   Poco::UInt64 blockTargetDeadline)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	blockData_ = std::make_shared<BlockData>(block, baseTarget, genSig, this, blockTargetDeadline);
+	return blockData_;
+}
+
+void Burst::MinerData::saveBlock(const BlockData& blockData)
 {
 	std::lock_guard<std::mutex> lock{mutex_};
 
-	// save the old data in the historical container
-	if (blockData_ != nullptr)
+	// add the block to the database
+	try
 	{
-		// add the block to the database
-		try
-		{
-			*dbSession_ <<
-				"INSERT INTO block VALUES (NULL, :height, :scoop, :btarget, :gensig, :diff, :targdl, :roundt, :blockt)",
-				bind(blockData_->getBlockheight()), bind(blockData_->getScoop()), bind(blockData_->getBasetarget()),
-				useRef(blockData_->getGensigStr()), bind(blockData_->getDifficulty()), bind(blockData_->getBlockTargetDeadline()),
-				bind(blockData_->getRoundTime()), bind(blockData_->getBlockTime()), now;
+		*dbSession_ <<
+			"INSERT INTO block VALUES (NULL, :height, :scoop, :btarget, :gensig, :diff, :targdl, :roundt, :blockt)",
+			bind(blockData.getBlockheight()), bind(blockData.getScoop()), bind(blockData.getBasetarget()),
+			useRef(blockData.getGensigStr()), bind(blockData.getDifficulty()), bind(blockData.getBlockTargetDeadline()),
+			bind(blockData.getRoundTime()), bind(blockData.getBlockTime()), now;
 
-			blockData_->forDeadlines([this](const Deadline& deadline)
+		blockData.forDeadlines([this](const Deadline& deadline)
+		{
+			try
 			{
-				try
-				{
-					const auto status = [&]()
-					{
-						if (deadline.isConfirmed())
-							return 3;
+				const auto status = static_cast<int>(deadline.getStatus());
 
-						if (deadline.isSent())
-							return 2;
+				*dbSession_ <<
+					"INSERT INTO deadline VALUES (NULL, :height, :account, :nonce, :value, :file, :miner, :totalplotsize, :status)",
+					bind(deadline.getBlock()), bind(deadline.getAccountId()), bind(deadline.getNonce()), bind(deadline.getDeadline()),
+					bind(deadline.getPlotFile()), bind(deadline.getMiner()), bind(deadline.getTotalPlotsize()), bind(status), now;
+			}
+			catch (Poco::Exception& e)
+			{
+				log_error(MinerLogger::general, "Could not insert deadline %s for block %Lu\n\tReason: %s",
+					deadline.deadlineToReadableString(), deadline.getBlock(), e.displayText());
+			}
 
-						if (deadline.isOnTheWay())
-							return 1;
+			return false;
+		});
 
-						return 0;
-					}();
+		// the k best deadlines of every account
+		if (blockData.getTopDeadlines() != nullptr)
+		{
+			for (const auto& account : blockData.getTopDeadlines()->get())
+			{
+				for (size_t rank = 0; rank < account.second.size(); ++rank)
+				{
+					const auto& entry = account.second[rank];
 
 					*dbSession_ <<
-						"INSERT INTO deadline VALUES (NULL, :height, :account, :nonce, :value, :file, :miner, :totalplotsize, :status)",
-						bind(deadline.getBlock()), bind(deadline.getAccountId()), bind(deadline.getNonce()), bind(deadline.getDeadline()),
-						bind(deadline.getPlotFile()), bind(deadline.getMiner()), bind(deadline.getTotalPlotsize()), bind(status), now;
+						"INSERT OR REPLACE INTO top_deadline VALUES (:height, :account, :rank, :nonce, :value, :file)",
+						bind(blockData.getBlockheight()), bind(account.first), bind(static_cast<Poco::UInt64>(rank)),
+						bind(entry.nonce), bind(entry.deadline), useRef(entry.plotFile), now;
 				}
-				catch (Poco::Exception& e)
-				{
-					log_error(MinerLogger::general, "Could not insert deadline %s for block %Lu\n\tReason: %s",
-						deadline.deadlineToReadableString(), deadline.getBlock(), e.displayText());
-				}
-
-				return false;
-			});
-		}
-		catch (Poco::Exception& e)
-		{
-			log_error(MinerLogger::general, "Could not insert block %Lu\n\tReason: %s",
-				blockData_->getBlockheight(), e.displayText());
+			}
 		}
 	}
-
-	blockData_ = std::make_shared<BlockData>(block, baseTarget, genSig, this, blockTargetDeadline);
-	return blockData_;
+	catch (Poco::Exception& e)
+	{
+		log_error(MinerLogger::general, "Could not insert block %Lu\n\tReason: %s",
+			blockData.getBlockheight(), e.displayText());
+	}
 }
 
 std::vector<std::shared_ptr<Burst::BlockData>> Burst::MinerData::getHistoricalBlocks(const Poco::UInt64 from, const Poco::UInt64 to) const
@@ -641,13 +707,13 @@ void Burst::MinerData::forAllBlocks(const Poco::UInt64 from, const Poco::UInt64
 		{
 			auto deadline = historicBlock->addDeadline(nonces[j], values[j], std::make_shared<Account>(accounts[j]), height, files[j]);
 
-			switch (status[j])
+			switch (static_cast<DeadlineStatus>(status[j]))
 			{
-			case 3:
+			case DeadlineStatus::Confirmed:
 				deadline->confirm();
-			case 2:
+			case DeadlineStatus::Sent:
 				deadline->send();
-			case 1:
+			case DeadlineStatus::OnTheWay:
 				deadline->onTheWay();
 			default:
 				break;
@@ -658,22 +724,18 @@ void Burst::MinerData::forAllBlocks(const Poco::UInt64 from, const Poco::UInt64
 	}
 }
 
-Poco::UInt64 Burst::MinerData::runGetWonBlocks(const std::pair<const Wallet*, const Accounts*>& args)
+Poco::UInt64 Burst::MinerData::runGetWonBlocks(const std::pair<const Wallet*, Accounts*>& args)
 {
 	poco_ndc(BlockData::runGetWonBlocks);
 
 	auto& wallet = *args.first;
 	auto& accounts = *args.second;
-	size_t wonBlocks = 0;
 
 	if (!wallet.isActive())
 		return 0;
 
-	std::vector<Block> blocks;
-
-	for (auto& account : accounts.getAccounts())
-		if (wallet.getAccountBlocks(account->getId(), blocks))
-			wonBlocks += blocks.size();
+	// only the expired data is fetched from the wallet
+	const auto wonBlocks = accounts.refresh(wallet);
 
 	bool refresh;
 
@@ -787,6 +849,24 @@ std::shared_ptr<const Burst::BlockData> Burst::MinerData::getBlockData() const
 	return blockData_;
 }
 
+std::vector<Poco::UInt64> Burst::MinerData::getBlockTimes(const Poco::UInt32 count) const
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	std::vector<Poco::UInt64> blockTimes;
+
+	try
+	{
+		*dbSession_ << "SELECT blockTime FROM block WHERE blockTime > 0 ORDER BY height DESC LIMIT :count",
+			into(blockTimes), bind(count), now;
+	}
+	catch (Poco::Exception& e)
+	{
+		log_error(MinerLogger::general, "Could not load the block times\n\tReason: %s", e.displayText());
+	}
+
+	return blockTimes;
+}
+
 std::shared_ptr<const Burst::BlockData> Burst::MinerData::getHistoricalBlockData(const Poco::UInt32 roundsBefore) const
 {
 	if (blockData_ == nullptr)
@@ -898,7 +978,12 @@ Poco::UInt64 Burst::MinerData::getCurrentScoopNum() const
 	return blockData_ == nullptr ? 0 : blockData_->getScoop();
 }
 
-Poco::ActiveResult<Poco::UInt64> Burst::MinerData::getWonBlocksAsync(const Wallet& wallet, const Accounts& accounts)
+Burst::RoundCheckpoint& Burst::MinerData::getCheckpoint()
+{
+	return *checkpoint_;
+}
+
+Poco::ActiveResult<Poco::UInt64> Burst::MinerData::getWonBlocksAsync(const Wallet& wallet, Accounts& accounts)
 {
 	const auto tuple = std::make_pair(&wallet, &accounts);
 	return activityWonBlocks_(tuple);
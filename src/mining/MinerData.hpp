@@ -35,6 +35,9 @@
 #include <Poco/BasicEvent.h>
 #include <Poco/Message.h>
 #include <Poco/Data/Session.h>
+#include "RoundCheckpoint.hpp"
+#include "plots/PlotChecksum.hpp"
+#include "TopDeadlines.hpp"
 
 namespace Burst
 {
@@ -65,6 +68,8 @@ namespace Burst
 		void refreshBlockEntry() const;
 		void refreshConfig() const;
 		void refreshPlotDirs() const;
+		void addCorruptedRegion(const std::string& plotFile, const CorruptedRegion& region) const;
+		void refreshHealth() const;
 		void setProgress(float progressRead, float progressVerification, Poco::UInt64 blockheight);
 		void setProgress(const std::string& plotDir, float progress, Poco::UInt64 blockheight);
 		void setBlockTime(Poco::UInt64 bTime);
@@ -83,9 +88,23 @@ namespace Burst
 		std::shared_ptr<Deadline> getBestDeadline() const;
 		std::shared_ptr<Deadline> getBestDeadline(DeadlineSearchType searchType) const;
 		//std::vector<Poco::JSON::Object> getEntries() const;
-		bool forEntries(std::function<bool(const Poco::JSON::Object&)> traverseFunction) const;
+		/**
+		 * \brief Traverses the entries, the overall progress and the dir progress.
+		 * An entry is added and sent to the listeners under the same lock, so no new entry can come in between.
+		 * \param traverseFunction The function, that is called for every entry; false stops the traverse.
+		 * \param finishFunction The function, that is called after the traverse, before a new entry can be added.
+		 * \return true, if the traverse was stopped, false otherwise.
+		 */
+		bool forEntries(std::function<bool(const Poco::JSON::Object&)> traverseFunction,
+			std::function<void()> finishFunction = nullptr) const;
 		//const std::unordered_map<AccountId, Deadlines>& getDeadlines() const;
 		std::shared_ptr<Deadline> getBestDeadline(Poco::UInt64 accountId, DeadlineSearchType searchType);
+
+		/**
+		 * \brief Returns the collector of the K best deadlines per account of the round.
+		 * \return The collector, nullptr if the deadlines are not collected.
+		 */
+		std::shared_ptr<TopDeadlines> getTopDeadlines() const;
 		Poco::ActiveResult<std::shared_ptr<Account>> getLastWinnerAsync(const Wallet& wallet, Accounts& accounts);
 
 		std::shared_ptr<Deadline> addDeadlineIfBest(Poco::UInt64 nonce, Poco::UInt64 deadline,
@@ -100,6 +119,13 @@ namespace Burst
 	protected:
 		
 		void addBlockEntry(Poco::JSON::Object entry) const;
+
+		/**
+		 * \brief Adds an entry only, when it differs from the last one of its kind.
+		 * \param entry The entry.
+		 * \param last The last entry of the kind (stringified), is updated when the entry is added.
+		 */
+		void addBlockEntryIfChanged(Poco::JSON::Object entry, std::string& last) const;
 		void confirmedDeadlineEvent(const std::shared_ptr<Deadline>& deadline);
 
 	private:
@@ -136,9 +162,11 @@ namespace Burst
 		std::shared_ptr<Account> lastWinner_ = nullptr;
 		std::unordered_map<AccountId, std::shared_ptr<Deadlines>> deadlines_;
 		std::shared_ptr<Deadline> bestDeadline_;
+		std::shared_ptr<TopDeadlines> topDeadlines_;
 		MinerData* parent_;
 		Poco::JSON::Object::Ptr jsonProgress_;
 		std::unordered_map<std::string, Poco::JSON::Object::Ptr> jsonDirProgress_;
+		mutable std::string jsonConfig_, jsonPlotDirs_;
 		mutable std::mutex mutex_;
 
 		friend class Deadlines;
@@ -158,6 +186,12 @@ namespace Burst
 		~MinerData() override;
 		
 		std::shared_ptr<BlockData> startNewBlock(Poco::UInt64 block, Poco::UInt64 baseTarget, const std::string& genSig, Poco::UInt64 blockTargetDeadline);
+
+		/**
+		 * \brief Writes a finished block and its deadlines into the database.
+		 * \param blockData The finished block.
+		 */
+		void saveBlock(const BlockData& blockData);
 		void addMessage(const Poco::Message& message);
 
 		std::shared_ptr<Deadline> getBestDeadlineOverall(bool onlyHistorical = false) const;
@@ -168,6 +202,13 @@ namespace Burst
 		std::shared_ptr<BlockData> getBlockData();
 		std::shared_ptr<const BlockData> getBlockData() const;
 		std::shared_ptr<const BlockData> getHistoricalBlockData(Poco::UInt32 roundsBefore) const;
+
+		/**
+		 * \brief Returns the times of the last blocks from the database.
+		 * \param count The maximum number of blocks.
+		 * \return The block times in seconds, the newest first.
+		 */
+		std::vector<Poco::UInt64> getBlockTimes(Poco::UInt32 count) const;
 		std::vector<std::shared_ptr<BlockData>> getAllHistoricalBlockData() const;
 		Poco::UInt64 getConfirmedDeadlines() const;
 		Poco::UInt64 getAverageDeadline() const;
@@ -178,7 +219,8 @@ namespace Burst
 		Poco::UInt64 getCurrentBlockheight() const;
 		Poco::UInt64 getCurrentBasetarget() const;
 		Poco::UInt64 getCurrentScoopNum() const;
-		Poco::ActiveResult<Poco::UInt64> getWonBlocksAsync(const Wallet& wallet, const Accounts& accounts);
+		Poco::ActiveResult<Poco::UInt64> getWonBlocksAsync(const Wallet& wallet, Accounts& accounts);
+		RoundCheckpoint& getCheckpoint();
 
 		Poco::BasicEvent<const Poco::JSON::Object> blockDataChangedEvent;
 		std::vector<std::shared_ptr<BlockData>> getHistoricalBlocks(Poco::UInt64 from, Poco::UInt64 to) const;
@@ -186,7 +228,7 @@ namespace Burst
 		void forAllBlocks(Poco::UInt64 from, Poco::UInt64 to, const std::function<bool(std::shared_ptr<BlockData>&)>& traverseFunction) const;
 
 	protected:
-		Poco::UInt64 runGetWonBlocks(const std::pair<const Wallet*, const Accounts*>& args);
+		Poco::UInt64 runGetWonBlocks(const std::pair<const Wallet*, Accounts*>& args);
 
 	private:
 		Poco::Timestamp startTime_ = {};
@@ -195,8 +237,9 @@ namespace Burst
 		mutable std::mutex mutex_;
 
 		std::unique_ptr<Poco::Data::Session> dbSession_ = nullptr;
+		std::unique_ptr<RoundCheckpoint> checkpoint_ = nullptr;
 
-		Poco::ActiveMethod<Poco::UInt64, std::pair<const Wallet*, const Accounts*>, MinerData,
+		Poco::ActiveMethod<Poco::UInt64, std::pair<const Wallet*, Accounts*>, MinerData,
 						   Poco::ActiveStarter<MinerData>> activityWonBlocks_;
 
 		friend class BlockData;
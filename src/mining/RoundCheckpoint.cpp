@@ -0,0 +1,294 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#include "RoundCheckpoint.hpp"
+#include "MinerData.hpp"
+#include "logging/MinerLogger.hpp"
+#include <Poco/Data/Session.h>
+#include <Poco/Format.h>
+#include <algorithm>
+#include <iterator>
+
+using namespace Poco::Data::Keywords;
+
+Burst::RoundCheckpoint::RoundCheckpoint(const std::string& databasePath)
+{
+	try
+	{
+		session_ = std::make_unique<Poco::Data::Session>("SQLite", databasePath);
+
+		*session_ <<
+			"CREATE TABLE IF NOT EXISTS checkpoint (" <<
+			"	height			INTEGER NOT NULL," <<
+			"	gensig			TEXT NOT NULL," <<
+			"	file			TEXT NOT NULL," <<
+			"	nonceStart		INTEGER NOT NULL," <<
+			"	nonceEnd		INTEGER NOT NULL" <<
+			")", now;
+
+		*session_ <<
+			"CREATE TABLE IF NOT EXISTS checkpoint_deadline (" <<
+			"	height			INTEGER NOT NULL," <<
+			"	gensig			TEXT NOT NULL," <<
+			"	account			INTEGER NOT NULL," <<
+			"	nonce			INTEGER NOT NULL," <<
+			"	value			INTEGER NOT NULL," <<
+			"	file			TEXT NOT NULL," <<
+			"	status			INTEGER NOT NULL" <<
+			")", now;
+	}
+	catch (Poco::Exception& e)
+	{
+		throw Poco::Exception{Poco::format("Could not load/create the round checkpoint '%s'\n\tReason: %s", databasePath, e.displayText())};
+	}
+
+	// a damaged checkpoint only costs the time to read the round again
+	try
+	{
+		auto saved = std::make_unique<Saved>();
+		std::vector<Poco::UInt64> heights;
+		std::vector<std::string> gensigs;
+
+		*session_ << "SELECT height, gensig FROM checkpoint_deadline UNION SELECT height, gensig FROM checkpoint",
+			into(heights), into(gensigs), now;
+
+		if (heights.size() != 1)
+			return;
+
+		saved->height = heights.front();
+		saved->gensig = gensigs.front();
+
+		std::vector<std::string> files;
+		std::vector<Poco::UInt64> nonceStarts, nonceEnds;
+
+		*session_ << "SELECT file, nonceStart, nonceEnd FROM checkpoint",
+			into(files), into(nonceStarts), into(nonceEnds), now;
+
+		for (size_t i = 0; i < files.size(); ++i)
+			addRange(saved->verified[files[i]], nonceStarts[i], nonceEnds[i]);
+
+		std::vector<AccountId> accounts;
+		std::vector<Poco::UInt64> nonces, values;
+		std::vector<int> status;
+
+		files.clear();
+
+		*session_ << "SELECT account, nonce, value, file, status FROM checkpoint_deadline",
+			into(accounts), into(nonces), into(values), into(files), into(status), now;
+
+		for (size_t i = 0; i < accounts.size(); ++i)
+		{
+			SavedDeadline deadline;
+			deadline.accountId = accounts[i];
+			deadline.nonce = nonces[i];
+			deadline.deadline = values[i];
+			deadline.plotFile = files[i];
+			deadline.status = static_cast<DeadlineStatus>(status[i]);
+			saved->deadlines.emplace_back(deadline);
+		}
+
+		saved_ = std::move(saved);
+	}
+	catch (Poco::Exception& e)
+	{
+		log_warning(MinerLogger::miner, "Could not load the round checkpoint\n\tReason: %s", e.displayText());
+	}
+}
+
+Burst::RoundCheckpoint::~RoundCheckpoint() = default;
+
+std::vector<Burst::RoundCheckpoint::SavedDeadline> Burst::RoundCheckpoint::start(const Poco::UInt64 height, const std::string& gensig)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+
+	height_ = height;
+	gensig_ = gensig;
+	verified_.clear();
+	found_.clear();
+	dirty_ = true;
+
+	// the saved checkpoint can only be used by the first round after the start
+	const auto saved = std::move(saved_);
+
+	if (saved == nullptr || saved->height != height || saved->gensig != gensig)
+		return {};
+
+	verified_ = saved->verified;
+
+	// the saved deadlines belong to the restored nonces, until they are back in the block data
+	for (const auto& deadline : saved->deadlines)
+		addBest(found_, deadline);
+
+	log_information(MinerLogger::miner, "Continuing block %Lu from the checkpoint (%z plot files, %z deadlines)",
+		height, verified_.size(), saved->deadlines.size());
+
+	return saved->deadlines;
+}
+
+void Burst::RoundCheckpoint::addVerified(const Poco::UInt64 height, const std::string& plotFile, const Poco::UInt64 nonceStart,
+	const Poco::UInt64 nonces, const AccountId accountId, const Poco::UInt64 bestNonce, const Poco::UInt64 bestDeadline)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+
+	if (height != height_ || nonces == 0)
+		return;
+
+	addRange(verified_[plotFile], nonceStart, nonceStart + nonces);
+
+	if (bestNonce != 0 && bestDeadline != 0)
+	{
+		SavedDeadline deadline;
+		deadline.accountId = accountId;
+		deadline.nonce = bestNonce;
+		deadline.deadline = bestDeadline;
+		deadline.plotFile = plotFile;
+		addBest(found_, deadline);
+	}
+
+	dirty_ = true;
+}
+
+bool Burst::RoundCheckpoint::isVerified(const Poco::UInt64 height, const std::string& plotFile, const Poco::UInt64 nonceStart,
+	const Poco::UInt64 nonces) const
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+
+	if (height != height_)
+		return false;
+
+	const auto file = verified_.find(plotFile);
+
+	if (file == verified_.end())
+		return false;
+
+	// the last range, that begins before or at the nonces
+	auto range = file->second.upper_bound(nonceStart);
+
+	if (range == file->second.begin())
+		return false;
+
+	--range;
+	return range->second >= nonceStart + nonces;
+}
+
+void Burst::RoundCheckpoint::save(const BlockData& block)
+{
+	std::lock_guard<std::mutex> sessionLock{sessionMutex_};
+	Poco::UInt64 height;
+	std::string gensig;
+	std::unordered_map<std::string, Ranges> verified;
+	BestDeadlines found;
+
+	// the verifiers are only blocked while copying
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+
+		if (!dirty_ || block.getBlockheight() != height_)
+			return;
+
+		height = height_;
+		gensig = gensig_;
+		verified = verified_;
+		found = found_;
+		dirty_ = false;
+	}
+
+	// only the best deadline of every account is needed to avoid worse submissions
+	BestDeadlines bestDeadlines;
+
+	block.forDeadlines([&bestDeadlines](const Deadline& deadline)
+	{
+		auto& best = bestDeadlines[deadline.getAccountId()];
+
+		if (best.nonce == 0 || deadline.getDeadline() < best.deadline)
+		{
+			best.accountId = deadline.getAccountId();
+			best.nonce = deadline.getNonce();
+			best.deadline = deadline.getDeadline();
+			best.plotFile = deadline.getPlotFile();
+			best.status = deadline.getStatus();
+		}
+
+		return false;
+	});
+
+	// the deadlines of the verified nonces, that are not in the block data yet
+	for (const auto& deadline : found)
+		addBest(bestDeadlines, deadline.second);
+
+	try
+	{
+		session_->begin();
+
+		*session_ << "DELETE FROM checkpoint", now;
+		*session_ << "DELETE FROM checkpoint_deadline", now;
+
+		for (const auto& file : verified)
+			for (const auto& range : file.second)
+				*session_ << "INSERT INTO checkpoint VALUES (:height, :gensig, :file, :start, :end)",
+					bind(height), bind(gensig), bind(file.first), bind(range.first), bind(range.second), now;
+
+		for (const auto& best : bestDeadlines)
+			*session_ << "INSERT INTO checkpoint_deadline VALUES (:height, :gensig, :account, :nonce, :value, :file, :status)",
+				bind(height), bind(gensig), bind(best.second.accountId), bind(best.second.nonce), bind(best.second.deadline),
+				bind(best.second.plotFile), bind(static_cast<int>(best.second.status)), now;
+
+		session_->commit();
+	}
+	catch (Poco::Exception& e)
+	{
+		if (session_->isTransaction())
+			session_->rollback();
+
+		log_error(MinerLogger::miner, "Could not save the round checkpoint\n\tReason: %s", e.displayText());
+
+		std::lock_guard<std::mutex> lock{mutex_};
+		dirty_ = dirty_ || height == height_;
+	}
+}
+
+void Burst::RoundCheckpoint::addRange(Ranges& ranges, Poco::UInt64 begin, Poco::UInt64 end)
+{
+	// merge all ranges, that overlap or touch the new one
+	auto range = ranges.upper_bound(begin);
+
+	if (range != ranges.begin() && std::prev(range)->second >= begin)
+		--range;
+
+	while (range != ranges.end() && range->first <= end)
+	{
+		begin = std::min(begin, range->first);
+		end = std::max(end, range->second);
+		range = ranges.erase(range);
+	}
+
+	ranges.emplace(begin, end);
+}
+
+void Burst::RoundCheckpoint::addBest(BestDeadlines& bestDeadlines, const SavedDeadline& deadline)
+{
+	const auto best = bestDeadlines.find(deadline.accountId);
+
+	// on a tie the known deadline is kept, because its status can be further
+	if (best == bestDeadlines.end() || deadline.deadline < best->second.deadline)
+		bestDeadlines[deadline.accountId] = deadline;
+}
@@ -0,0 +1,137 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Declarations.hpp"
+#include "Deadline.hpp"
+
+namespace Poco
+{
+	namespace Data
+	{
+		class Session;
+	}
+}
+
+namespace Burst
+{
+	class BlockData;
+
+	/**
+	 * \brief Remembers the verified nonces and the best deadlines of the current round,
+	 * so that a restarted miner can continue the round instead of reading everything again.
+	 */
+	class RoundCheckpoint
+	{
+	public:
+		struct SavedDeadline
+		{
+			AccountId accountId = 0;
+			Poco::UInt64 nonce = 0;
+			Poco::UInt64 deadline = 0;
+			std::string plotFile;
+			DeadlineStatus status = DeadlineStatus::Found;
+		};
+
+		/**
+		 * \brief Constructor.
+		 * Loads the checkpoint, that was saved by the last run.
+		 * \param databasePath The path to the SQLite database.
+		 * \throws Poco::Exception If the database could not be opened.
+		 */
+		explicit RoundCheckpoint(const std::string& databasePath);
+		~RoundCheckpoint();
+
+		/**
+		 * \brief Starts a new round.
+		 * If the saved checkpoint belongs to the same round, its verified nonces are restored.
+		 * \param height The height of the round.
+		 * \param gensig The generation signature of the round.
+		 * \return The saved deadlines of the round, empty if the checkpoint belongs to another round.
+		 */
+		std::vector<SavedDeadline> start(Poco::UInt64 height, const std::string& gensig);
+
+		/**
+		 * \brief Marks nonces of a plot file as verified.
+		 * The best deadline of the nonces is remembered together with them, because it may still be
+		 * on its way into the block data, when the checkpoint is saved.
+		 * \param height The height of the round, the nonces were verified for.
+		 * \param plotFile The path of the plot file.
+		 * \param nonceStart The first nonce, relative to the start of the plot file.
+		 * \param nonces The number of nonces.
+		 * \param accountId The account of the plot file.
+		 * \param bestNonce The nonce with the best deadline, 0 if there is none.
+		 * \param bestDeadline The best deadline, 0 if there is none.
+		 */
+		void addVerified(Poco::UInt64 height, const std::string& plotFile, Poco::UInt64 nonceStart, Poco::UInt64 nonces,
+			AccountId accountId, Poco::UInt64 bestNonce, Poco::UInt64 bestDeadline);
+
+		/**
+		 * \brief Checks, if nonces of a plot file were already verified in the current round.
+		 * \param height The height of the round.
+		 * \param plotFile The path of the plot file.
+		 * \param nonceStart The first nonce, relative to the start of the plot file.
+		 * \param nonces The number of nonces.
+		 * \return true, if all nonces were verified, false otherwise.
+		 */
+		bool isVerified(Poco::UInt64 height, const std::string& plotFile, Poco::UInt64 nonceStart, Poco::UInt64 nonces) const;
+
+		/**
+		 * \brief Writes the verified nonces and the best deadline of every account into the database.
+		 * Nothing is written, if nothing changed since the last save.
+		 * \param block The data of the current round.
+		 */
+		void save(const BlockData& block);
+
+	private:
+		using Ranges = std::map<Poco::UInt64, Poco::UInt64>;
+		using BestDeadlines = std::unordered_map<AccountId, SavedDeadline>;
+
+		struct Saved
+		{
+			Poco::UInt64 height = 0;
+			std::string gensig;
+			std::unordered_map<std::string, Ranges> verified;
+			std::vector<SavedDeadline> deadlines;
+		};
+
+		static void addRange(Ranges& ranges, Poco::UInt64 begin, Poco::UInt64 end);
+		static void addBest(BestDeadlines& bestDeadlines, const SavedDeadline& deadline);
+
+		Poco::UInt64 height_ = 0;
+		std::string gensig_;
+		std::unordered_map<std::string, Ranges> verified_;
+		BestDeadlines found_;
+		bool dirty_ = false;
+		std::unique_ptr<Saved> saved_;
+		std::unique_ptr<Poco::Data::Session> session_;
+		mutable std::mutex mutex_;
+		std::mutex sessionMutex_;
+	};
+}
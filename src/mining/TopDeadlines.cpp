@@ -0,0 +1,110 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#include "TopDeadlines.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+	// used for a max heap, so the worst collected deadline is on top
+	bool isBetter(const Burst::TopDeadlines::Entry& lhs, const Burst::TopDeadlines::Entry& rhs)
+	{
+		return lhs.deadline < rhs.deadline;
+	}
+}
+
+Burst::TopDeadlines::Account::Account(const size_t size)
+	: size_{size},
+	  threshold_{std::numeric_limits<Poco::UInt64>::max()}
+{
+	heap_.reserve(size);
+}
+
+bool Burst::TopDeadlines::Account::isCandidate(const Poco::UInt64 deadline) const
+{
+	return deadline < threshold_.load(std::memory_order_relaxed);
+}
+
+void Burst::TopDeadlines::Account::add(const Poco::UInt64 nonce, const Poco::UInt64 deadline, const std::string& plotFile)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+
+	// another verifier could have raised the bar in the meantime
+	if (!isCandidate(deadline) || size_ == 0)
+		return;
+
+	if (heap_.size() < size_)
+	{
+		heap_.emplace_back();
+	}
+	else
+	{
+		// the worst one makes room, its entry is reused
+		std::pop_heap(heap_.begin(), heap_.end(), isBetter);
+	}
+
+	auto& entry = heap_.back();
+	entry.nonce = nonce;
+	entry.deadline = deadline;
+	entry.plotFile = plotFile;
+
+	std::push_heap(heap_.begin(), heap_.end(), isBetter);
+
+	if (heap_.size() == size_)
+		threshold_.store(heap_.front().deadline, std::memory_order_relaxed);
+}
+
+std::vector<Burst::TopDeadlines::Entry> Burst::TopDeadlines::Account::get() const
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	auto entries = heap_;
+	std::sort(entries.begin(), entries.end(), isBetter);
+	return entries;
+}
+
+Burst::TopDeadlines::TopDeadlines(const size_t size)
+	: size_{size}
+{}
+
+std::shared_ptr<Burst::TopDeadlines::Account> Burst::TopDeadlines::getAccount(const Poco::UInt64 accountId)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+
+	auto& account = accounts_[accountId];
+
+	if (account == nullptr)
+		account = std::make_shared<Account>(size_);
+
+	return account;
+}
+
+std::map<Poco::UInt64, std::vector<Burst::TopDeadlines::Entry>> Burst::TopDeadlines::get() const
+{
+	std::map<Poco::UInt64, std::vector<Entry>> deadlines;
+	std::lock_guard<std::mutex> lock{mutex_};
+
+	for (const auto& account : accounts_)
+		deadlines.emplace(account.first, account.second->get());
+
+	return deadlines;
+}
@@ -0,0 +1,118 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#pragma once
+
+#include <Poco/Types.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Burst
+{
+	/**
+	 * \brief Collects the K best deadlines of every account in a round.
+	 * The verifiers compare every deadline lock-free against the worst collected deadline
+	 * of the account, only the few better ones take a lock. The K best deadlines show,
+	 * if the plots of an account perform like their capacity promises.
+	 */
+	class TopDeadlines
+	{
+	public:
+		/**
+		 * \brief A collected deadline.
+		 */
+		struct Entry
+		{
+			Poco::UInt64 nonce = 0;
+			Poco::UInt64 deadline = 0;
+			std::string plotFile;
+		};
+
+		/**
+		 * \brief The K best deadlines of one account.
+		 */
+		class Account
+		{
+		public:
+			/**
+			 * \brief Constructor.
+			 * \param size The number of deadlines, that are collected (K).
+			 */
+			explicit Account(size_t size);
+
+			/**
+			 * \brief Checks without a lock, if a deadline could be one of the K best.
+			 * \param deadline The deadline.
+			 * \return true, if the deadline needs to be added, false otherwise.
+			 */
+			bool isCandidate(Poco::UInt64 deadline) const;
+
+			/**
+			 * \brief Adds a deadline, if it is one of the K best.
+			 * \param nonce The nonce.
+			 * \param deadline The deadline.
+			 * \param plotFile The path of the plot file of the nonce.
+			 */
+			void add(Poco::UInt64 nonce, Poco::UInt64 deadline, const std::string& plotFile);
+
+			/**
+			 * \brief Returns the collected deadlines.
+			 * \return The deadlines, the best first.
+			 */
+			std::vector<Entry> get() const;
+
+		private:
+			size_t size_;
+			std::vector<Entry> heap_;
+			std::atomic<Poco::UInt64> threshold_;
+			mutable std::mutex mutex_;
+		};
+
+		/**
+		 * \brief Constructor.
+		 * \param size The number of deadlines per account, that are collected (K).
+		 */
+		explicit TopDeadlines(size_t size);
+
+		/**
+		 * \brief Returns the collector of an account, it is created if needed.
+		 * \param accountId The account id.
+		 * \return The collector.
+		 */
+		std::shared_ptr<Account> getAccount(Poco::UInt64 accountId);
+
+		/**
+		 * \brief Returns the collected deadlines of all accounts.
+		 * \return The deadlines per account, the best first.
+		 */
+		std::map<Poco::UInt64, std::vector<Entry>> get() const;
+
+	private:
+		size_t size_;
+		std::map<Poco::UInt64, std::shared_ptr<Account>> accounts_;
+		mutable std::mutex mutex_;
+	};
+}
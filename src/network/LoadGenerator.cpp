@@ -0,0 +1,315 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#include "LoadGenerator.hpp"
+#include "Request.hpp"
+#include "Declarations.hpp"
+#include "logging/MinerLogger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <Poco/FileStream.h>
+#include <Poco/Format.h>
+#include <Poco/JSON/Array.h>
+#include <Poco/JSON/Parser.h>
+#include <Poco/Net/HTTPClientSession.h>
+#include <Poco/Net/HTTPRequest.h>
+#include <Poco/Net/HTTPResponse.h>
+#include <Poco/StreamCopier.h>
+#include <Poco/Thread.h>
+#include <Poco/URI.h>
+
+bool Burst::LoadGenerator::load(const std::string& path)
+{
+	poco_ndc(LoadGenerator::load);
+
+	try
+	{
+		Poco::FileInputStream scriptStream{path};
+		Poco::JSON::Parser parser;
+		const auto script = parser.parse(scriptStream).extract<Poco::JSON::Object::Ptr>();
+
+		url_ = {script->optValue<std::string>("url", "http://127.0.0.1:8125"), "http", 80};
+		miners_ = std::max(script->optValue("miners", miners_), 1u);
+		duration_ = std::max(script->optValue("duration", duration_), 1u);
+		miningInfoInterval_ = std::max(script->optValue("miningInfoInterval", miningInfoInterval_), 1u);
+		submitInterval_ = std::max(script->optValue("submitInterval", submitInterval_), 1u);
+		capacity_ = script->optValue("capacity", capacity_);
+		reportPath_ = script->optValue("report", reportPath_);
+	}
+	catch (Poco::Exception& exc)
+	{
+		log_error(MinerLogger::general, "Could not read the load test script %s\n\t%s", path, exc.displayText());
+		return false;
+	}
+
+	if (url_.empty())
+	{
+		log_error(MinerLogger::general, "The load test script %s has no valid url!", path);
+		return false;
+	}
+
+	return true;
+}
+
+void Burst::LoadGenerator::run()
+{
+	poco_ndc(LoadGenerator::run);
+
+	for (auto& stats : stats_)
+		stats = {};
+
+	log_information(MinerLogger::general, "Simulating %u miners against %s for %u seconds...",
+		miners_, url_.getCanonical(true), duration_);
+
+	const Poco::Timestamp start;
+	Poco::Timestamp end;
+	end += static_cast<Poco::Timestamp::TimeDiff>(duration_) * 1000 * 1000;
+
+	// every simulated miner blocks on its requests, so every one of them gets its own thread
+	std::vector<std::thread> miners;
+	miners.reserve(miners_);
+
+	for (auto i = 0u; i < miners_; ++i)
+		miners.emplace_back(&LoadGenerator::simulateMiner, this, i, end);
+
+	for (auto& miner : miners)
+		miner.join();
+
+	elapsed_ = start.elapsed() / 1000. / 1000.;
+
+	const auto& miningInfos = stats_[static_cast<size_t>(RequestType::MiningInfo)];
+	const auto& submissions = stats_[static_cast<size_t>(RequestType::SubmitNonce)];
+
+	log_success(MinerLogger::general,
+		"Load test finished after %.2f seconds\n"
+		"\tmining infos: %Lu ok, %Lu errors, %Lu failed\n"
+		"\tsubmissions:  %Lu ok, %Lu errors, %Lu failed",
+		elapsed_, miningInfos.ok, miningInfos.errors, miningInfos.failures,
+		submissions.ok, submissions.errors, submissions.failures);
+}
+
+bool Burst::LoadGenerator::writeReport(const std::string& path) const
+{
+	const auto& reportPath = path.empty() ? reportPath_ : path;
+	Poco::JSON::Object report;
+
+	report.set("version", Settings::Project.getVersion());
+	report.set("url", url_.getCanonical(true));
+	report.set("miners", miners_);
+	report.set("duration", elapsed_);
+	report.set("miningInfoInterval", miningInfoInterval_);
+	report.set("submitInterval", submitInterval_);
+
+	Poco::Mutex::ScopedLock lock{mutex_};
+
+	for (size_t type = 0; type < RequestTypeCount; ++type)
+	{
+		auto latencies = stats_[type].latencies;
+		std::sort(latencies.begin(), latencies.end());
+
+		// nearest rank percentiles, like the benchmark report
+		const auto percentile = [&latencies](const double p)
+		{
+			if (latencies.empty())
+				return 0.;
+
+			const auto rank = static_cast<size_t>(std::ceil(p / 100. * latencies.size()));
+			return latencies[std::max(rank, size_t{1}) - 1];
+		};
+
+		auto total = 0.;
+
+		for (const auto latency : latencies)
+			total += latency;
+
+		const auto requests = stats_[type].ok + stats_[type].errors + stats_[type].failures;
+		Poco::JSON::Object typeJson, latencyJson;
+
+		typeJson.set("requests", requests);
+		typeJson.set("ok", stats_[type].ok);
+		typeJson.set("errors", stats_[type].errors);
+		typeJson.set("failures", stats_[type].failures);
+		typeJson.set("throughput", elapsed_ > 0. ? requests / elapsed_ : 0.);
+
+		latencyJson.set("min", latencies.empty() ? 0. : latencies.front());
+		latencyJson.set("max", latencies.empty() ? 0. : latencies.back());
+		latencyJson.set("avg", latencies.empty() ? 0. : total / latencies.size());
+		latencyJson.set("p50", percentile(50));
+		latencyJson.set("p90", percentile(90));
+		latencyJson.set("p99", percentile(99));
+
+		typeJson.set("latency", latencyJson);
+		report.set(static_cast<RequestType>(type) == RequestType::MiningInfo ? "miningInfo" : "submitNonce", typeJson);
+	}
+
+	try
+	{
+		Poco::FileStream reportStream{reportPath, std::ios_base::out | std::ios::trunc};
+		report.stringify(reportStream, 4);
+		reportStream << std::endl;
+		log_success(MinerLogger::general, "Wrote load test report into %s", reportPath);
+		return true;
+	}
+	catch (...)
+	{
+		log_error(MinerLogger::general, "Could not write load test report into %s!", reportPath);
+		return false;
+	}
+}
+
+void Burst::LoadGenerator::simulateMiner(const unsigned index, const Poco::Timestamp& end)
+{
+	using namespace Poco::Net;
+
+	std::mt19937_64 random{std::random_device{}()};
+	std::unique_ptr<HTTPClientSession> session;
+	const auto accountId = Poco::UInt64{index} + 1;
+	const auto minerName = Poco::format("creepMiner load test %u", index);
+	Poco::UInt64 height = 0;
+	Poco::UInt64 bestDeadline = 0;
+
+	// spread the first requests, so that not all miners hit the target at the same time
+	Poco::Timestamp nextMiningInfo;
+	nextMiningInfo += std::uniform_int_distribution<Poco::Timestamp::TimeDiff>{0, miningInfoInterval_ * 1000}(random);
+	Poco::Timestamp nextSubmit = nextMiningInfo;
+
+	while (true)
+	{
+		const auto next = std::min(nextMiningInfo, nextSubmit);
+
+		if (next >= end)
+			break;
+
+		const Poco::Timestamp now;
+
+		if (next > now)
+			Poco::Thread::sleep(static_cast<long>((next - now) / 1000));
+
+		if (Poco::Timestamp{} >= nextMiningInfo)
+		{
+			HTTPRequest request{HTTPRequest::HTTP_GET, "/burst?requestType=getMiningInfo", HTTPRequest::HTTP_1_1};
+			request.setKeepAlive(true);
+			Poco::JSON::Object::Ptr json;
+
+			if (send(session, request, RequestType::MiningInfo, json) == Result::Ok)
+			{
+				const auto newHeight = json->get("height").convert<Poco::UInt64>();
+
+				// a new block starts with a fresh (bad) deadline
+				if (newHeight != height)
+				{
+					height = newHeight;
+					bestDeadline = std::uniform_int_distribution<Poco::UInt64>{1000000, 10000000}(random);
+					nextSubmit = Poco::Timestamp{};
+				}
+			}
+
+			nextMiningInfo += static_cast<Poco::Timestamp::TimeDiff>(miningInfoInterval_) * 1000;
+		}
+
+		if (height > 0 && Poco::Timestamp{} >= nextSubmit)
+		{
+			// every submission is better than the one before, like a real miner would send them
+			bestDeadline = std::uniform_int_distribution<Poco::UInt64>{1, std::max(bestDeadline, Poco::UInt64{1})}(random);
+
+			Poco::URI uri;
+			uri.setPath("/burst");
+			uri.addQueryParameter("requestType", "submitNonce");
+			uri.addQueryParameter("nonce", std::to_string(std::uniform_int_distribution<Poco::UInt64>{1}(random)));
+			uri.addQueryParameter("accountId", std::to_string(accountId));
+			uri.addQueryParameter("blockheight", std::to_string(height));
+
+			HTTPRequest request{HTTPRequest::HTTP_POST, uri.getPathAndQuery(), HTTPRequest::HTTP_1_1};
+			request.set(X_Capacity, std::to_string(capacity_));
+			request.set(X_Miner, minerName);
+			request.set(X_Deadline, std::to_string(bestDeadline));
+			request.setKeepAlive(true);
+			request.setContentLength(0);
+
+			Poco::JSON::Object::Ptr json;
+			send(session, request, RequestType::SubmitNonce, json);
+			nextSubmit += static_cast<Poco::Timestamp::TimeDiff>(submitInterval_) * 1000;
+		}
+		else if (height == 0)
+			nextSubmit = nextMiningInfo;
+	}
+}
+
+Burst::LoadGenerator::Result Burst::LoadGenerator::send(std::unique_ptr<Poco::Net::HTTPClientSession>& session,
+	Poco::Net::HTTPRequest& request, const RequestType type, Poco::JSON::Object::Ptr& json)
+{
+	using namespace Poco::Net;
+
+	const Poco::Timestamp start;
+	auto result = Result::Failed;
+
+	try
+	{
+		if (session == nullptr)
+			session = url_.createSession();
+
+		session->sendRequest(request);
+
+		HTTPResponse response;
+		auto& responseStream = session->receiveResponse(response);
+		std::string body;
+		Poco::StreamCopier::copyToString(responseStream, body);
+
+		if (response.getStatus() == HTTPResponse::HTTP_OK)
+		{
+			Poco::JSON::Parser parser;
+			json = parser.parse(body).extract<Poco::JSON::Object::Ptr>();
+
+			// a nonce is only accepted, when the pool confirms its deadline
+			const auto expected = type == RequestType::MiningInfo ? "height" : "deadline";
+			result = json->has(expected) ? Result::Ok : Result::Error;
+		}
+		else
+			result = Result::Error;
+	}
+	catch (Poco::Exception& exc)
+	{
+		log_debug(MinerLogger::general, "Load test request %s failed\n\t%s", request.getURI(), exc.displayText());
+		// a broken session is not reused
+		session.reset();
+	}
+
+	addSample(type, result, start.elapsed() / 1000.);
+	return result;
+}
+
+void Burst::LoadGenerator::addSample(const RequestType type, const Result result, const double latency)
+{
+	Poco::Mutex::ScopedLock lock{mutex_};
+	auto& stats = stats_[static_cast<size_t>(type)];
+
+	switch (result)
+	{
+	case Result::Ok: ++stats.ok; break;
+	case Result::Error: ++stats.errors; break;
+	case Result::Failed: ++stats.failures; return;
+	}
+
+	stats.latencies.emplace_back(latency);
+}
@@ -0,0 +1,111 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <Poco/JSON/Object.h>
+#include <Poco/Mutex.h>
+#include <Poco/Timestamp.h>
+#include "Url.hpp"
+
+namespace Poco
+{
+	namespace Net
+	{
+		class HTTPClientSession;
+		class HTTPRequest;
+	}
+}
+
+namespace Burst
+{
+	/**
+	 * \brief Simulates a number of downstream miners, that poll the mining info and submit nonces.
+	 * Points at a pool, a stub pool or a proxy and measures the latency and throughput of the requests.
+	 */
+	class LoadGenerator
+	{
+	public:
+		/**
+		 * \brief Loads the script, that describes the target and the simulated miners.
+		 * \param path The path to the JSON script.
+		 * \return true, if the script is valid.
+		 */
+		bool load(const std::string& path);
+
+		/**
+		 * \brief Runs all simulated miners until the duration is over.
+		 */
+		void run();
+
+		/**
+		 * \brief Writes the measured latencies and throughputs as JSON.
+		 * \param path The path of the report. If empty, the path of the script is used.
+		 * \return true, if the report could be written.
+		 */
+		bool writeReport(const std::string& path = "") const;
+
+	private:
+		enum class RequestType
+		{
+			MiningInfo,
+			SubmitNonce
+		};
+
+		enum class Result
+		{
+			Ok,
+			Error,
+			Failed
+		};
+
+		static constexpr size_t RequestTypeCount = 2;
+
+		struct Stats
+		{
+			Poco::UInt64 ok = 0;
+			Poco::UInt64 errors = 0;
+			Poco::UInt64 failures = 0;
+			std::vector<double> latencies;
+		};
+
+		void simulateMiner(unsigned index, const Poco::Timestamp& end);
+		Result send(std::unique_ptr<Poco::Net::HTTPClientSession>& session, Poco::Net::HTTPRequest& request,
+			RequestType type, Poco::JSON::Object::Ptr& json);
+		void addSample(RequestType type, Result result, double latency);
+
+		Url url_;
+		unsigned miners_ = 100;
+		unsigned duration_ = 60;
+		unsigned miningInfoInterval_ = 3000;
+		unsigned submitInterval_ = 1000;
+		Poco::UInt64 capacity_ = 1024;
+		std::string reportPath_ = "loadtest.json";
+
+		mutable Poco::Mutex mutex_;
+		std::array<Stats, RequestTypeCount> stats_;
+		double elapsed_ = 0.;
+	};
+}
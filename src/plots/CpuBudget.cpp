@@ -0,0 +1,142 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#include "CpuBudget.hpp"
+#include "PlotReader.hpp"
+#include "mining/MinerConfig.hpp"
+#include <algorithm>
+#include <thread>
+#include <Poco/Environment.h>
+#include <Poco/Timestamp.h>
+
+std::atomic<unsigned> Burst::CpuBudget::share_{0};
+std::atomic<Poco::UInt64> Burst::CpuBudget::busy_{0};
+std::atomic<Poco::Int64> Burst::CpuBudget::measureStart_{Poco::Timestamp().epochMicroseconds()};
+
+namespace
+{
+	// the work between two sleeps, short enough to stay smooth for other workloads
+	const std::chrono::microseconds slice{10000};
+
+	// the clock is only read every few calls, because the stop function is called for every few nonces
+	const unsigned callsPerCheck = 64;
+}
+
+void Burst::CpuBudget::Pacer::begin()
+{
+	busyStart_ = Clock::now();
+	calls_ = 0;
+}
+
+void Burst::CpuBudget::Pacer::pace(const std::function<bool()>& stopFunction)
+{
+	if (!isActive() || ++calls_ < callsPerCheck)
+		return;
+
+	calls_ = 0;
+
+	const auto busy = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - busyStart_);
+
+	if (busy < slice)
+		return;
+
+	busy_ += busy.count();
+
+	const auto share = getThreadShare();
+
+	if (share < 1.)
+	{
+		debt_ += std::chrono::microseconds{static_cast<Poco::Int64>(busy.count() * (1. / share - 1.))};
+
+		// sleep in small steps, so that a new round does not need to wait
+		const std::chrono::microseconds step{2000};
+		const auto sleepStart = Clock::now();
+		auto slept = std::chrono::microseconds{0};
+		auto stopped = false;
+
+		while (slept < debt_ && !(stopped = stopFunction()))
+		{
+			std::this_thread::sleep_for(std::min(step, debt_ - slept));
+			slept = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - sleepStart);
+		}
+
+		// the sleep is never exact, the difference is taken into the next slice,
+		// but a stopped sleep is forgotten, so that the next round does not pay for it
+		if (stopped)
+			debt_ = std::chrono::microseconds{0};
+		else
+			debt_ -= slept;
+	}
+
+	busyStart_ = Clock::now();
+}
+
+void Burst::CpuBudget::Pacer::end()
+{
+	busy_ += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - busyStart_).count();
+}
+
+void Burst::CpuBudget::setShare(const unsigned percent)
+{
+	share_ = percent >= 100 ? 0 : percent;
+}
+
+unsigned Burst::CpuBudget::getShare()
+{
+	return share_;
+}
+
+bool Burst::CpuBudget::isActive()
+{
+	return share_ > 0;
+}
+
+double Burst::CpuBudget::getUtilization()
+{
+	const auto elapsed = Poco::Timestamp().epochMicroseconds() - measureStart_;
+	const auto cpus = std::max(Poco::Environment::processorCount(), 1u);
+
+	if (elapsed <= 0)
+		return 0.;
+
+	return std::min(1., static_cast<double>(busy_) / elapsed / cpus);
+}
+
+void Burst::CpuBudget::resetUtilization()
+{
+	busy_ = 0;
+	measureStart_ = Poco::Timestamp().epochMicroseconds();
+}
+
+double Burst::CpuBudget::getThreadShare()
+{
+	// the round comes first, so in the second half of its time budget the verifiers run at full speed
+	const auto roundBudget = PlotReader::roundEpoch.getBudget();
+
+	if (roundBudget > 0 && PlotReader::roundEpoch.getElapsed() >= roundBudget * 1000ull * 1000ull / 2)
+		return 1.;
+
+	const auto cpus = std::max(Poco::Environment::processorCount(), 1u);
+	const auto verifiers = std::max(MinerConfig::getConfig().getMiningIntensity(), 1u);
+
+	return std::min(1., std::max(0.01, share_ / 100. * cpus / verifiers));
+}
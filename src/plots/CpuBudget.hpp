@@ -0,0 +1,116 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <Poco/Types.h>
+
+namespace Burst
+{
+	/**
+	 * \brief Limits the cpu time of all plot verifiers to a share of the machine.
+	 * Every verifier thread is duty-cycled by its own \see Pacer, so that the
+	 * verifiers together stay inside the budget.
+	 */
+	class CpuBudget
+	{
+	public:
+		~CpuBudget() = delete;
+
+		/**
+		 * \brief Paces a single verifier thread.
+		 * After every slice of work, the thread sleeps long enough to keep its share.
+		 */
+		class Pacer
+		{
+		public:
+			/**
+			 * \brief Starts a piece of work.
+			 */
+			void begin();
+
+			/**
+			 * \brief Sleeps, if the slice of work is used up.
+			 * The sleep is interrupted as soon as the stop function returns true.
+			 * \param stopFunction Stops the sleeping.
+			 */
+			void pace(const std::function<bool()>& stopFunction);
+
+			/**
+			 * \brief Ends a piece of work.
+			 */
+			void end();
+
+		private:
+			using Clock = std::chrono::steady_clock;
+
+			Clock::time_point busyStart_;
+			// the sleep time, that was not slept yet (or overslept, if negative)
+			std::chrono::microseconds debt_{0};
+			unsigned calls_ = 0;
+		};
+
+		/**
+		 * \brief Sets the budget.
+		 * \param percent The share of all cpus in percent, 0 or 100 for no limit.
+		 */
+		static void setShare(unsigned percent);
+
+		/**
+		 * \brief Returns the budget.
+		 * \return The share of all cpus in percent, 0 for no limit.
+		 */
+		static unsigned getShare();
+
+		/**
+		 * \brief Checks, if the verifiers are limited.
+		 * \return true, if there is a budget, false otherwise.
+		 */
+		static bool isActive();
+
+		/**
+		 * \brief Returns the cpu time of the verifiers since the last reset.
+		 * \return The used share of all cpus between 0 and 1.
+		 */
+		static double getUtilization();
+
+		/**
+		 * \brief Starts a new measurement of the utilization.
+		 */
+		static void resetUtilization();
+
+	private:
+		/**
+		 * \brief Returns the share of a single verifier thread.
+		 * It is 1, if the budget is lifted, so that the round finishes in its time budget.
+		 * \return The share between 0 and 1.
+		 */
+		static double getThreadShare();
+
+		static std::atomic<unsigned> share_;
+		static std::atomic<Poco::UInt64> busy_;
+		static std::atomic<Poco::Int64> measureStart_;
+	};
+}
@@ -0,0 +1,145 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#include "IoScheduler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <Poco/Timestamp.h>
+
+std::unordered_map<Poco::UInt64, Burst::IoScheduler::Device> Burst::IoScheduler::devices_;
+std::array<Poco::UInt64, Burst::IoScheduler::Classes> Burst::IoScheduler::rates_{};
+std::mutex Burst::IoScheduler::mutex_;
+std::condition_variable Burst::IoScheduler::condition_;
+
+void Burst::IoScheduler::beginRound(const std::vector<Poco::UInt64>& devices)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+
+	// the reads of an interrupted round are stale
+	for (auto& device : devices_)
+		device.second.pendingRoundReads = 0;
+
+	for (const auto device : devices)
+		++devices_[device].pendingRoundReads;
+}
+
+void Burst::IoScheduler::finishRoundRead(const Poco::UInt64 device)
+{
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		auto& state = devices_[device];
+
+		if (state.pendingRoundReads > 0)
+			--state.pendingRoundReads;
+	}
+
+	condition_.notify_all();
+}
+
+void Burst::IoScheduler::endRound()
+{
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+
+		for (auto& device : devices_)
+			device.second.pendingRoundReads = 0;
+	}
+
+	condition_.notify_all();
+}
+
+bool Burst::IoScheduler::acquire(const IoPriority priority, const Poco::UInt64 device, const Poco::UInt64 bytes,
+	const std::function<bool()>& stopFunction)
+{
+	if (priority == IoPriority::Round)
+		return true;
+
+	const auto index = static_cast<size_t>(priority);
+
+	std::unique_lock<std::mutex> lock{mutex_};
+	auto& state = devices_[device];
+	++state.waiting[index];
+
+	auto acquired = false;
+
+	while (!acquired)
+	{
+		if (stopFunction && stopFunction())
+			break;
+
+		const auto higherWaiting = std::any_of(state.waiting.begin() + 1, state.waiting.begin() + index,
+			[](const size_t waiting) { return waiting > 0; });
+
+		acquired = state.pendingRoundReads == 0 && !higherWaiting && takeTokens(state, index, bytes);
+
+		// the tokens are refilled over time, so we have to look again after a while
+		if (!acquired)
+			condition_.wait_for(lock, std::chrono::milliseconds(100));
+	}
+
+	--state.waiting[index];
+	lock.unlock();
+
+	// lower priorities could wait for us
+	condition_.notify_all();
+	return acquired;
+}
+
+void Burst::IoScheduler::setRate(const IoPriority priority, const Poco::UInt64 bytesPerSecond)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	rates_[static_cast<size_t>(priority)] = bytesPerSecond;
+}
+
+bool Burst::IoScheduler::isIdle(const Poco::UInt64 device)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	const auto iter = devices_.find(device);
+	return iter == devices_.end() || iter->second.pendingRoundReads == 0;
+}
+
+bool Burst::IoScheduler::takeTokens(Device& device, const size_t priority, const Poco::UInt64 bytes)
+{
+	const auto rate = rates_[priority];
+
+	if (rate == 0)
+		return true;
+
+	const auto now = Poco::Timestamp().epochMicroseconds();
+	auto& tokens = device.tokens[priority];
+	auto& refilled = device.refilled[priority];
+
+	// the bucket holds the tokens of one second
+	if (refilled == 0)
+		tokens = static_cast<double>(rate);
+	else
+		tokens = std::min(static_cast<double>(rate), tokens + (now - refilled) / 1000000.0 * rate);
+
+	refilled = now;
+
+	// an access, that is bigger than the bucket, only needs a full bucket
+	if (tokens <= 0 || (tokens < bytes && tokens < rate))
+		return false;
+
+	tokens -= bytes;
+	return true;
+}
@@ -0,0 +1,118 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <Poco/Types.h>
+
+namespace Burst
+{
+	/**
+	 * \brief The priority classes of disk accesses, the highest first.
+	 */
+	enum class IoPriority
+	{
+		Round,
+		Integrity,
+		Plotting
+	};
+
+	/**
+	 * \brief Coordinates the disk accesses of the round reads and the background work per device.
+	 * The round reads are never delayed. Background work on a device waits until the
+	 * round reads on it are done, until no background work with a higher priority waits
+	 * for the device and until its token bucket allows it.
+	 */
+	class IoScheduler
+	{
+	public:
+		~IoScheduler() = delete;
+
+		/**
+		 * \brief Starts the round reads and preempts the background work on the devices.
+		 * The background work stops at its next \see acquire.
+		 * \param devices The device of every plot read notification of the round.
+		 */
+		static void beginRound(const std::vector<Poco::UInt64>& devices);
+
+		/**
+		 * \brief Notifies, that a plot read notification of the round was read.
+		 * \param device The device of the plot read notification.
+		 */
+		static void finishRoundRead(Poco::UInt64 device);
+
+		/**
+		 * \brief Ends the round, all devices are free for background work.
+		 */
+		static void endRound();
+
+		/**
+		 * \brief Waits until a disk access is allowed.
+		 * Accesses of the round never wait.
+		 * \param priority The priority class of the access.
+		 * \param device The device, that is accessed.
+		 * \param bytes The amount of bytes, that will be read or written.
+		 * \param stopFunction Stops the waiting, when it returns true.
+		 * \return true, if the access is allowed, false if the waiting was stopped.
+		 */
+		static bool acquire(IoPriority priority, Poco::UInt64 device, Poco::UInt64 bytes,
+			const std::function<bool()>& stopFunction = {});
+
+		/**
+		 * \brief Sets the rate of the token bucket of a priority class on every device.
+		 * \param priority The priority class.
+		 * \param bytesPerSecond The rate in bytes per second, 0 for no limit.
+		 */
+		static void setRate(IoPriority priority, Poco::UInt64 bytesPerSecond);
+
+		/**
+		 * \brief Checks, if there are no unfinished round reads on a device.
+		 * \param device The device.
+		 * \return true, if the device is idle, false otherwise.
+		 */
+		static bool isIdle(Poco::UInt64 device);
+
+	private:
+		static constexpr size_t Classes = 3;
+
+		struct Device
+		{
+			size_t pendingRoundReads = 0;
+			std::array<size_t, Classes> waiting{};
+			std::array<double, Classes> tokens{};
+			std::array<Poco::Int64, Classes> refilled{};
+		};
+
+		static bool takeTokens(Device& device, size_t priority, Poco::UInt64 bytes);
+
+		static std::unordered_map<Poco::UInt64, Device> devices_;
+		static std::array<Poco::UInt64, Classes> rates_;
+		static std::mutex mutex_;
+		static std::condition_variable condition_;
+	};
+}
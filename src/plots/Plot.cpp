@@ -28,9 +28,23 @@
 #include "logging/Message.hpp"
 #include "logging/MinerLogger.hpp"
 #include "MinerUtil.hpp"
+#include "PlotChecksum.hpp"
+#include <algorithm>
 
 Burst::PlotFile::PlotFile(std::string&& path, const Poco::UInt64 size)
 	: path_(move(path)), size_(size)
+{
+	parseName();
+	extents_ = getFileExtents(path_);
+}
+
+Burst::PlotFile::PlotFile(std::string&& path, const Poco::UInt64 size, std::shared_ptr<const VirtualPlotSettings> virtualSettings)
+	: path_(move(path)), size_(size), virtualSettings_(std::move(virtualSettings))
+{
+	parseName();
+}
+
+void Burst::PlotFile::parseName()
 {
 	accountId_ = stoull(getAccountIdFromPlotFile(path_));
 	nonceStart_ = stoull(getStartNonceFromPlotFile(path_));
@@ -109,10 +123,55 @@ bool Burst::PlotFile::isPoC(int version) const
 	return version_ == version;
 }
 
+Poco::UInt64 Burst::PlotFile::getPhysicalOffset() const
+{
+	if (extents_.empty())
+		return 0;
+
+	return extents_.front().physical;
+}
+
+bool Burst::PlotFile::getPhysicalOffset(const Poco::UInt64 logicalOffset, Poco::UInt64& physicalOffset) const
+{
+	// search the last extent, that starts before the logical offset
+	auto extent = std::upper_bound(extents_.begin(), extents_.end(), logicalOffset,
+		[](const Poco::UInt64 offset, const FileExtent& fileExtent)
+	{
+		return offset < fileExtent.logical;
+	});
+
+	if (extent == extents_.begin())
+		return false;
+
+	--extent;
+
+	if (logicalOffset >= extent->logical + extent->length)
+		return false;
+
+	physicalOffset = extent->physical + (logicalOffset - extent->logical);
+	return true;
+}
+
+const std::vector<Burst::FileExtent>& Burst::PlotFile::getExtents() const
+{
+	return extents_;
+}
+
+bool Burst::PlotFile::isVirtual() const
+{
+	return virtualSettings_ != nullptr;
+}
+
+const std::shared_ptr<const Burst::VirtualPlotSettings>& Burst::PlotFile::getVirtualSettings() const
+{
+	return virtualSettings_;
+}
+
 Burst::PlotDir::PlotDir(std::string plotPath, Type type)
 	: path_{std::move(plotPath)},
 	  type_{type},
-	  size_{0}
+	  size_{0},
+	  deviceId_{Burst::getDeviceId(path_)}
 {
 	addPlotLocation(path_);
 	recalculateHash();
@@ -121,7 +180,8 @@ Burst::PlotDir::PlotDir(std::string plotPath, Type type)
 Burst::PlotDir::PlotDir(std::string path, const std::vector<std::string>& relatedPaths, Type type)
 	: path_{std::move(path)},
 	  type_{type},
-	  size_{0}
+	  size_{0},
+	  deviceId_{Burst::getDeviceId(path_)}
 {
 	addPlotLocation(path_);
 
@@ -131,6 +191,17 @@ Burst::PlotDir::PlotDir(std::string path, const std::vector<std::string>& relate
 	recalculateHash();
 }
 
+Burst::PlotDir::PlotDir(std::string path, const VirtualPlotSettings& virtualSettings)
+	: path_{std::move(path)},
+	  type_{Type::Sequential},
+	  size_{0},
+	  deviceId_{0},
+	  virtualSettings_{std::make_shared<VirtualPlotSettings>(virtualSettings)}
+{
+	addVirtualPlotFiles();
+	recalculateHash();
+}
+
 Burst::PlotDir::PlotList Burst::PlotDir::getPlotfiles(bool recursive) const
 {
 	// copy all plot files inside this plot directory
@@ -176,12 +247,25 @@ const std::string& Burst::PlotDir::getHash() const
 	return hash_;
 }
 
+Poco::UInt64 Burst::PlotDir::getDeviceId() const
+{
+	return deviceId_;
+}
+
+const std::shared_ptr<const Burst::VirtualPlotSettings>& Burst::PlotDir::getVirtualSettings() const
+{
+	return virtualSettings_;
+}
+
 void Burst::PlotDir::rescan()
 {
 	plotfiles_.clear();
 	size_ = 0;
 
-	addPlotLocation(path_);
+	if (virtualSettings_ != nullptr)
+		addVirtualPlotFiles();
+	else
+		addPlotLocation(path_);
 
 	for (auto& relatedDir : relatedDirs_)
 		relatedDir->rescan();
@@ -240,6 +324,10 @@ bool Burst::PlotDir::addPlotLocation(const std::string& fileOrPath)
 
 std::shared_ptr<Burst::PlotFile> Burst::PlotDir::addPlotFile(const Poco::File& file)
 {
+	// the checksums of a plotfile are stored next to it
+	if (PlotChecksum::isSidecar(file.path()))
+		return nullptr;
+
 	auto result = isValidPlotFile(file.path());
 
 	if (result == PlotCheckResult::Ok)
@@ -288,3 +376,20 @@ void Burst::PlotDir::recalculateHash()
 	shaStream << std::flush;
 	hash_ = Poco::SHA1Engine::digestToHex(sha.digest());
 }
+
+void Burst::PlotDir::addVirtualPlotFiles()
+{
+	auto nonce = virtualSettings_->startNonce;
+
+	for (auto i = 0u; i < virtualSettings_->files; ++i)
+	{
+		// the virtual plotfiles are optimized for PoC2
+		auto name = path_ + "/" + std::to_string(virtualSettings_->account) + "_" + std::to_string(nonce) + "_" +
+			std::to_string(virtualSettings_->nonces);
+
+		const auto size = virtualSettings_->nonces * Settings::PlotSize;
+		plotfiles_.emplace_back(std::make_shared<PlotFile>(std::move(name), size, virtualSettings_));
+		size_ += size;
+		nonce += virtualSettings_->nonces;
+	}
+}
@@ -24,6 +24,7 @@
 #include <Poco/Types.h>
 #include <memory>
 #include <vector>
+#include "MinerUtil.hpp"
 
 namespace Poco {
 	class File;
@@ -31,6 +32,51 @@ namespace Poco {
 
 namespace Burst
 {
+	/**
+	 * \brief The settings of a virtual plot directory.
+	 * A virtual plot directory contains plotfiles, that don't exist on a disk.
+	 * Their scoops are generated while reading, which makes it possible to benchmark
+	 * the miner without real plotfiles.
+	 */
+	struct VirtualPlotSettings
+	{
+		/**
+		 * \brief The account id of the virtual plotfiles.
+		 */
+		Poco::UInt64 account = 0;
+
+		/**
+		 * \brief The first nonce of the first virtual plotfile.
+		 */
+		Poco::UInt64 startNonce = 0;
+
+		/**
+		 * \brief The number of nonces of every virtual plotfile.
+		 */
+		Poco::UInt64 nonces = 0;
+
+		/**
+		 * \brief The number of virtual plotfiles.
+		 */
+		unsigned files = 1;
+
+		/**
+		 * \brief If true, real nonces are generated, otherwise deterministic pseudo data.
+		 * Real nonces are slow, but can be used to check the correctness of the deadlines.
+		 */
+		bool realNonces = false;
+
+		/**
+		 * \brief The emulated latency of a seek in milliseconds.
+		 */
+		double seekLatency = 0.;
+
+		/**
+		 * \brief The emulated throughput in MB/s, 0 for unlimited.
+		 */
+		double throughput = 0.;
+	};
+
 	/**
 	 * \brief Represents a plotfile.
 	 * This class is not an actual representation of the physical file,
@@ -46,6 +92,14 @@ namespace Burst
 		 */
 		PlotFile(std::string&& path, Poco::UInt64 size);
 
+		/**
+		 * \brief Constructor for a virtual plotfile.
+		 * \param path The virtual path to the plotfile, its name needs to follow the plotfile naming.
+		 * \param size The size of the plotfile in Bytes.
+		 * \param virtualSettings The settings of the virtual plot directory.
+		 */
+		PlotFile(std::string&& path, Poco::UInt64 size, std::shared_ptr<const VirtualPlotSettings> virtualSettings);
+
 		/**
 		 * \brief Returns the path to the plotfile.
 		 * \return A string, that holds the path to he plotfile.
@@ -112,10 +166,48 @@ namespace Burst
 		 */
 		bool isPoC(int version) const;
 
+		/**
+		 * \brief Returns the physical offset of the plotfile on its device.
+		 * It is used to read the plotfiles of one device in the order they are stored.
+		 * \return The offset of the first block of the plotfile in bytes, 0 if unknown.
+		 */
+		Poco::UInt64 getPhysicalOffset() const;
+
+		/**
+		 * \brief Translates a position inside the plotfile to its physical position on the device.
+		 * \param logicalOffset The position inside the plotfile in bytes.
+		 * \param physicalOffset The physical position on the device in bytes.
+		 * \return true, if the physical position is known, false otherwise.
+		 */
+		bool getPhysicalOffset(Poco::UInt64 logicalOffset, Poco::UInt64& physicalOffset) const;
+
+		/**
+		 * \brief Returns the extents of the plotfile on its device.
+		 * They are gathered once, when the plotfile is added.
+		 * \return A list of the extents, ordered by their position inside the plotfile.
+		 */
+		const std::vector<FileExtent>& getExtents() const;
+
+		/**
+		 * \brief Returns, if the plotfile is a virtual one.
+		 * \return true, if virtual, false otherwise.
+		 */
+		bool isVirtual() const;
+
+		/**
+		 * \brief Returns the settings of the virtual plotfile.
+		 * \return The settings, nullptr if the plotfile is not virtual.
+		 */
+		const std::shared_ptr<const VirtualPlotSettings>& getVirtualSettings() const;
+
 	private:
+		void parseName();
+
 		std::string path_;
 		Poco::UInt64 size_;
 		Poco::UInt64 accountId_, nonceStart_, nonces_, staggerSize_, version_;
+		std::vector<FileExtent> extents_;
+		std::shared_ptr<const VirtualPlotSettings> virtualSettings_;
 	};
 
 	/**
@@ -166,6 +258,14 @@ namespace Burst
 		 */
 		PlotDir(std::string path, const std::vector<std::string>& relatedPaths, Type type);
 
+		/**
+		 * \brief Constructor for a virtual plot directory.
+		 * The virtual plotfiles are created from the settings.
+		 * \param path The name of the virtual plot directory.
+		 * \param virtualSettings The settings of the virtual plotfiles.
+		 */
+		PlotDir(std::string path, const VirtualPlotSettings& virtualSettings);
+
 		/**
 		* \brief Returns all plot files inside the directory.
 		* \param recursive If true, also all plot files in all related plot directories are gathered.
@@ -205,6 +305,18 @@ namespace Burst
 		 */
 		const std::string& getHash() const;
 
+		/**
+		 * \brief Returns the id of the device, on which the plot directory is stored.
+		 * \return The device id, 0 if unknown.
+		 */
+		Poco::UInt64 getDeviceId() const;
+
+		/**
+		 * \brief Returns the settings of the virtual plot directory.
+		 * \return The settings, nullptr if the plot directory is not virtual.
+		 */
+		const std::shared_ptr<const VirtualPlotSettings>& getVirtualSettings() const;
+
 		/**
 		 * \brief Resets the list of all plot files and searches the directory again for them.
 		 * The unique hash value and the total size is also recalculated.
@@ -235,11 +347,18 @@ namespace Burst
 		 */
 		void recalculateHash();
 
+		/**
+		 * \brief Creates the virtual plotfiles from the virtual settings.
+		 */
+		void addVirtualPlotFiles();
+
 		std::string path_;
 		Type type_;
 		Poco::UInt64 size_;
+		Poco::UInt64 deviceId_;
 		PlotList plotfiles_;
 		std::vector<std::shared_ptr<PlotDir>> relatedDirs_;
 		std::string hash_;
+		std::shared_ptr<const VirtualPlotSettings> virtualSettings_;
 	};
 }
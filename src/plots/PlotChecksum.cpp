@@ -0,0 +1,297 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#include "PlotChecksum.hpp"
+#include "Plot.hpp"
+#include "IoScheduler.hpp"
+#include "Declarations.hpp"
+#include "MinerUtil.hpp"
+#include "logging/MinerLogger.hpp"
+#include "mining/MinerConfig.hpp"
+#include <Poco/File.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+
+#if defined(USE_SSE4) && (defined(__x86_64__) || defined(_M_X64))
+#include <nmmintrin.h>
+#define CRC32C_HARDWARE
+#endif
+
+// only the hardware function may use SSE4.2, all others have to run on every cpu
+#if defined(CRC32C_HARDWARE) && (defined(__GNUC__) || defined(__clang__))
+#define CRC32C_TARGET __attribute__((target("sse4.2")))
+#else
+#define CRC32C_TARGET
+#endif
+
+constexpr Poco::UInt64 Burst::PlotChecksum::SliceNonces;
+const std::string Burst::PlotChecksum::extension_ = ".crc";
+
+Poco::UInt32 Burst::PlotChecksum::crc32c(const void* data, const size_t size, const Poco::UInt32 crc)
+{
+	static const auto hardware = Settings::Sse4 && cpuHasInstructionSet(CpuInstructionSet::sse4);
+
+	if (hardware)
+		return ~crc32cHardware(data, size, ~crc);
+
+	return ~crc32cSoftware(data, size, ~crc);
+}
+
+std::string Burst::PlotChecksum::getPath(const PlotFile& plotFile)
+{
+	return plotFile.getPath() + extension_;
+}
+
+bool Burst::PlotChecksum::isSidecar(const std::string& path)
+{
+	return path.size() > extension_.size() &&
+		path.compare(path.size() - extension_.size(), extension_.size(), extension_) == 0;
+}
+
+bool Burst::PlotChecksum::exists(const PlotFile& plotFile)
+{
+	return open(plotFile) != nullptr;
+}
+
+std::unique_ptr<std::istream> Burst::PlotChecksum::open(const PlotFile& plotFile)
+{
+	std::unique_ptr<std::istream> sidecar = std::make_unique<std::ifstream>(getPath(plotFile),
+		std::ios::in | std::ios::binary);
+
+	if (!*sidecar || !readHeader(*sidecar, plotFile))
+		return nullptr;
+
+	return sidecar;
+}
+
+bool Burst::PlotChecksum::create(const PlotFile& plotFile, const std::function<bool()>& stopFunction)
+{
+	const auto header = createHeader(plotFile);
+	const auto staggerSize = plotFile.getStaggerSize();
+	const auto slicesPerStagger = getSlicesPerStagger(plotFile);
+	const auto device = getDeviceId(plotFile.getPath());
+	// the unfinished sidecar is also no plotfile
+	const auto tempPath = plotFile.getPath() + ".tmp" + extension_;
+
+	std::ifstream input{plotFile.getPath(), std::ios::in | std::ios::binary};
+	std::ofstream output{tempPath, std::ios::out | std::ios::binary | std::ios::trunc};
+
+	if (!input || !output)
+		return false;
+
+	output.write(reinterpret_cast<const char*>(&header), sizeof header);
+
+	std::vector<char> buffer(SliceNonces * Settings::ScoopSize);
+	std::vector<Poco::UInt32> checksums(slicesPerStagger);
+	auto completed = true;
+
+	// the plotfile is read from the beginning to the end, so the checksums
+	// are ordered by stagger, scoop and slice
+	for (Poco::UInt64 stagger = 0; stagger < plotFile.getStaggerCount() && completed; ++stagger)
+	{
+		for (Poco::UInt64 scoop = 0; scoop < Settings::ScoopPerPlot && completed; ++scoop)
+		{
+			for (Poco::UInt64 slice = 0; slice < slicesPerStagger && completed; ++slice)
+			{
+				const auto sliceBytes = std::min(SliceNonces, staggerSize - slice * SliceNonces) * Settings::ScoopSize;
+
+				// only read, when the device is not needed by the round
+				completed = IoScheduler::acquire(IoPriority::Integrity, device, sliceBytes, stopFunction) &&
+					input.read(buffer.data(), sliceBytes);
+
+				if (completed)
+					checksums[slice] = crc32c(buffer.data(), sliceBytes);
+			}
+
+			if (completed)
+				output.write(reinterpret_cast<const char*>(checksums.data()), checksums.size() * sizeof(Poco::UInt32));
+		}
+	}
+
+	output.close();
+	completed = completed && output;
+
+	try
+	{
+		Poco::File file{tempPath};
+
+		if (completed)
+			file.renameTo(getPath(plotFile));
+		else
+			file.remove();
+	}
+	catch (Poco::Exception& exc)
+	{
+		log_exception(MinerLogger::general, exc);
+		return false;
+	}
+
+	return completed;
+}
+
+std::vector<Burst::CorruptedRegion> Burst::PlotChecksum::check(const PlotFile& plotFile, std::istream& sidecar, const Poco::UInt64 scoop,
+	const Poco::UInt64 startNonce, const Poco::UInt64 nonces, const char* data)
+{
+	std::vector<CorruptedRegion> corrupted;
+
+	const auto staggerSize = plotFile.getStaggerSize();
+	const auto slicesPerStagger = getSlicesPerStagger(plotFile);
+	const auto stagger = startNonce / staggerSize;
+	const auto begin = startNonce % staggerSize;
+	const auto end = begin + nonces;
+
+	// only the slices, that are completely inside the read, can be checked
+	const auto firstSlice = (begin + SliceNonces - 1) / SliceNonces;
+	const auto lastSlice = end == staggerSize ? slicesPerStagger : end / SliceNonces;
+
+	if (firstSlice >= lastSlice)
+		return corrupted;
+
+	std::vector<Poco::UInt32> checksums(lastSlice - firstSlice);
+
+	// a failed read of the last check must not break this one
+	sidecar.clear();
+	sidecar.seekg(sizeof(Header) + ((stagger * Settings::ScoopPerPlot + scoop) * slicesPerStagger + firstSlice) *
+		sizeof(Poco::UInt32));
+
+	if (!sidecar.read(reinterpret_cast<char*>(checksums.data()), checksums.size() * sizeof(Poco::UInt32)))
+		return corrupted;
+
+	for (auto slice = firstSlice; slice < lastSlice; ++slice)
+	{
+		const auto sliceStart = slice * SliceNonces;
+		const auto sliceNonces = std::min(SliceNonces, staggerSize - sliceStart);
+
+		if (crc32c(data + (sliceStart - begin) * Settings::ScoopSize, sliceNonces * Settings::ScoopSize) !=
+			checksums[slice - firstSlice])
+			corrupted.emplace_back(CorruptedRegion{scoop, stagger * staggerSize + sliceStart, sliceNonces});
+	}
+
+	return corrupted;
+}
+
+Burst::PlotChecksum::Header Burst::PlotChecksum::createHeader(const PlotFile& plotFile)
+{
+	Header header;
+	header.magic = 0x53435243; // "CRCS"
+	header.version = 1;
+	header.nonces = plotFile.getNonces();
+	header.staggerSize = plotFile.getStaggerSize();
+	header.sliceNonces = SliceNonces;
+	return header;
+}
+
+bool Burst::PlotChecksum::readHeader(std::istream& sidecar, const PlotFile& plotFile)
+{
+	const auto expected = createHeader(plotFile);
+	Header header;
+
+	if (!sidecar.read(reinterpret_cast<char*>(&header), sizeof header))
+		return false;
+
+	return header.magic == expected.magic &&
+		header.version == expected.version &&
+		header.nonces == expected.nonces &&
+		header.staggerSize == expected.staggerSize &&
+		header.sliceNonces == expected.sliceNonces;
+}
+
+Poco::UInt64 Burst::PlotChecksum::getSlicesPerStagger(const PlotFile& plotFile)
+{
+	return (plotFile.getStaggerSize() + SliceNonces - 1) / SliceNonces;
+}
+
+Poco::UInt32 Burst::PlotChecksum::crc32cSoftware(const void* data, size_t size, Poco::UInt32 crc)
+{
+	static const auto table = []()
+	{
+		std::array<Poco::UInt32, 256> result;
+
+		for (Poco::UInt32 i = 0; i < 256; ++i)
+		{
+			auto value = i;
+
+			for (auto bit = 0; bit < 8; ++bit)
+				value = value & 1 ? (value >> 1) ^ 0x82F63B78 : value >> 1;
+
+			result[i] = value;
+		}
+
+		return result;
+	}();
+
+	auto bytes = static_cast<const unsigned char*>(data);
+
+	for (; size > 0; --size, ++bytes)
+		crc = table[(crc ^ *bytes) & 0xFF] ^ (crc >> 8);
+
+	return crc;
+}
+
+CRC32C_TARGET Poco::UInt32 Burst::PlotChecksum::crc32cHardware(const void* data, size_t size, Poco::UInt32 crc)
+{
+#ifdef CRC32C_HARDWARE
+	auto bytes = static_cast<const unsigned char*>(data);
+	Poco::UInt64 crc64 = crc;
+
+	for (; size >= sizeof(Poco::UInt64); size -= sizeof(Poco::UInt64), bytes += sizeof(Poco::UInt64))
+	{
+		Poco::UInt64 value;
+		memcpy(&value, bytes, sizeof value);
+		crc64 = _mm_crc32_u64(crc64, value);
+	}
+
+	crc = static_cast<Poco::UInt32>(crc64);
+
+	for (; size > 0; --size, ++bytes)
+		crc = _mm_crc32_u8(crc, *bytes);
+
+	return crc;
+#else
+	return crc32cSoftware(data, size, crc);
+#endif
+}
+
+Burst::PlotChecksumBuilder::PlotChecksumBuilder()
+	: Task("PlotChecksumBuilder")
+{}
+
+void Burst::PlotChecksumBuilder::runTask()
+{
+	for (const auto& plotFile : MinerConfig::getConfig().getPlotFiles())
+	{
+		if (isCancelled())
+			return;
+
+		if (plotFile->isVirtual() || PlotChecksum::exists(*plotFile))
+			continue;
+
+		log_information(MinerLogger::general, "Writing the checksums of %s...", plotFile->getPath());
+
+		if (PlotChecksum::create(*plotFile, [this]() { return isCancelled(); }))
+			log_information(MinerLogger::general, "Checksums of %s written", plotFile->getPath());
+		else if (!isCancelled())
+			log_warning(MinerLogger::general, "Could not write the checksums of %s", plotFile->getPath());
+	}
+}
@@ -0,0 +1,151 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#pragma once
+
+#include <Poco/Types.h>
+#include <Poco/Task.h>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Burst
+{
+	class PlotFile;
+
+	/**
+	 * \brief A range of nonces of one scoop, whose checksum does not match.
+	 */
+	struct CorruptedRegion
+	{
+		Poco::UInt64 scoop;
+		Poco::UInt64 startNonce;
+		Poco::UInt64 nonces;
+	};
+
+	/**
+	 * \brief The checksum sidecar of a plotfile.
+	 * The sidecar holds a CRC32C for every slice of a scoop inside a stagger. It is
+	 * written once by a background pass and used while reading the round, to detect
+	 * bitrot without generating a single nonce.
+	 */
+	class PlotChecksum
+	{
+	public:
+		~PlotChecksum() = delete;
+
+		/**
+		 * \brief The number of nonces of a slice, the last slice of a stagger can be smaller.
+		 */
+		static constexpr Poco::UInt64 SliceNonces = 4096;
+
+		/**
+		 * \brief Calculates the CRC32C of a block of data.
+		 * The crc32 instruction of SSE4.2 is used, when the cpu supports it.
+		 * \param data The data.
+		 * \param size The size of the data in bytes.
+		 * \param crc The checksum of the preceding data.
+		 * \return The checksum.
+		 */
+		static Poco::UInt32 crc32c(const void* data, size_t size, Poco::UInt32 crc = 0);
+
+		/**
+		 * \brief Returns the path of the sidecar of a plotfile.
+		 * \param plotFile The plotfile.
+		 * \return The path of the sidecar.
+		 */
+		static std::string getPath(const PlotFile& plotFile);
+
+		/**
+		 * \brief Checks, if a file is a sidecar and not a plotfile.
+		 * \param path The path of the file.
+		 * \return true, if the file is a sidecar, false otherwise.
+		 */
+		static bool isSidecar(const std::string& path);
+
+		/**
+		 * \brief Checks, if a plotfile has a sidecar, that fits to it.
+		 * \param plotFile The plotfile.
+		 * \return true, if the sidecar exists, false otherwise.
+		 */
+		static bool exists(const PlotFile& plotFile);
+
+		/**
+		 * \brief Opens the sidecar of a plotfile, for the checks of all reads of a round.
+		 * \param plotFile The plotfile.
+		 * \return The sidecar, nullptr if it does not exist or does not fit to the plotfile.
+		 */
+		static std::unique_ptr<std::istream> open(const PlotFile& plotFile);
+
+		/**
+		 * \brief Reads the whole plotfile and writes its sidecar.
+		 * The reads are background work of the integrity class of the \see IoScheduler.
+		 * \param plotFile The plotfile.
+		 * \param stopFunction Stops the pass, when it returns true.
+		 * \return true, if the sidecar was written, false if the pass was stopped or failed.
+		 */
+		static bool create(const PlotFile& plotFile, const std::function<bool()>& stopFunction);
+
+		/**
+		 * \brief Checks the slices, that are completely inside a read of one scoop.
+		 * \param plotFile The plotfile.
+		 * \param sidecar The sidecar of the plotfile, opened by \see open.
+		 * \param scoop The scoop, that was read.
+		 * \param startNonce The first nonce of the read, relative to the plotfile.
+		 * \param nonces The number of nonces of the read, it never overlaps two staggers.
+		 * \param data The scoops of the read.
+		 * \return The slices, whose checksum does not match.
+		 */
+		static std::vector<CorruptedRegion> check(const PlotFile& plotFile, std::istream& sidecar, Poco::UInt64 scoop,
+			Poco::UInt64 startNonce, Poco::UInt64 nonces, const char* data);
+
+	private:
+		struct Header
+		{
+			Poco::UInt32 magic;
+			Poco::UInt32 version;
+			Poco::UInt64 nonces;
+			Poco::UInt64 staggerSize;
+			Poco::UInt64 sliceNonces;
+		};
+
+		static Header createHeader(const PlotFile& plotFile);
+		static bool readHeader(std::istream& sidecar, const PlotFile& plotFile);
+		static Poco::UInt64 getSlicesPerStagger(const PlotFile& plotFile);
+		static Poco::UInt32 crc32cSoftware(const void* data, size_t size, Poco::UInt32 crc);
+		static Poco::UInt32 crc32cHardware(const void* data, size_t size, Poco::UInt32 crc);
+
+		static const std::string extension_;
+	};
+
+	/**
+	 * \brief Writes the missing sidecars of all plotfiles in the background.
+	 */
+	class PlotChecksumBuilder : public Poco::Task
+	{
+	public:
+		PlotChecksumBuilder();
+		void runTask() override;
+	};
+}
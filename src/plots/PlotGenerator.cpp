@@ -25,6 +25,7 @@
 #include "mining/Miner.hpp"
 #include "PlotVerifier.hpp"
 #include "MinerUtil.hpp"
+#include "IoScheduler.hpp"
 #include <fstream>
 #include <random>
 #include "webserver/MinerServer.hpp"
@@ -117,13 +118,16 @@ double Burst::PlotGenerator::checkPlotfileIntegrity(std::string plotPath, Miner&
 	// reading the nonces from the plot file in a parallel thread
 	std::vector<char> readNonce(16 + scoopSize * checkNonces * checkScoops);
 
-	std::thread nonceReader([&readNonce, scoops, plotPath, &miner, nonces, checkNonces, checkScoops,
+	const auto device = getDeviceId(plotPath);
+
+	std::thread nonceReader([&readNonce, scoops, plotPath, device, nonces, checkNonces, checkScoops,
 		startNonce, nonceCount, staggerSize, scoopSize, scoopStep, nonceStep]
 	{
 		const auto nonceScoopOffset = staggerSize * scoopSize;
 		for (auto scoopInterval = 0ull; scoopInterval < checkScoops; scoopInterval++)
 		{
-			while (miner.isProcessing()) Poco::Thread::sleep(1000);
+			// only read, when the device is not needed by the round
+			IoScheduler::acquire(IoPriority::Integrity, device, checkNonces * scoopSize);
 
 			auto scoop = scoopInterval * scoopStep + scoops[scoopInterval];
 			if (scoop >= Settings::ScoopPerPlot) scoop = Settings::ScoopPerPlot - 1;
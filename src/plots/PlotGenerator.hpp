@@ -62,6 +62,12 @@ namespace Burst
 			std::array<std::vector<char>, Shabal256_AVX2::HashSize>& gendatas,
 			GensigData& generationSignature, Poco::UInt64 scoop, Poco::UInt64 baseTarget);
 
+		/**
+		 * \brief Converts a generated PoC1 nonce into a PoC2 nonce.
+		 * \param gendata The generated nonce.
+		 */
+		static void convertToPoC2(char* gendata);
+
 	private:
 		template <typename TShabal, typename TOperations>
 		static std::array<std::vector<char>, TShabal::HashSize> generate(const Poco::UInt64 account, const Poco::UInt64 startNonce)
@@ -165,8 +171,6 @@ namespace Burst
 			return deadlines;
 		}
 
-		static void convertToPoC2(char* gendata);
-
 		template <typename TContainer>
 		static void convertToPoC2(TContainer& container)
 		{
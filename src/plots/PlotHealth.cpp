@@ -0,0 +1,225 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#include "PlotHealth.hpp"
+#include "logging/MinerLogger.hpp"
+#include <Poco/String.h>
+#include <Poco/Format.h>
+#include <Poco/JSON/Array.h>
+#include <algorithm>
+#include <vector>
+
+Burst::HealthPolicy Burst::PlotHealth::policy_ = HealthPolicy::Deprioritize;
+double Burst::PlotHealth::slowRead_ = 1.;
+unsigned Burst::PlotHealth::quarantineRounds_ = 10;
+Poco::UInt64 Burst::PlotHealth::blockheight_ = 0;
+std::map<Poco::UInt64, Burst::PlotHealth::Device> Burst::PlotHealth::devices_;
+std::map<std::string, Burst::PlotHealth::File> Burst::PlotHealth::files_;
+Poco::Mutex Burst::PlotHealth::mutex_;
+
+void Burst::PlotHealth::setPolicy(const HealthPolicy policy, const double slowRead, const unsigned quarantineRounds)
+{
+	Poco::ScopedLock<Poco::Mutex> lock{mutex_};
+	policy_ = policy;
+	slowRead_ = slowRead;
+	quarantineRounds_ = quarantineRounds;
+}
+
+Burst::HealthPolicy Burst::PlotHealth::getPolicy()
+{
+	Poco::ScopedLock<Poco::Mutex> lock{mutex_};
+	return policy_;
+}
+
+Burst::HealthPolicy Burst::PlotHealth::fromString(const std::string& policy)
+{
+	const auto policyLower = Poco::toLower(policy);
+
+	if (policyLower == "deprioritize")
+		return HealthPolicy::Deprioritize;
+
+	if (policyLower == "skip")
+		return HealthPolicy::Skip;
+
+	return HealthPolicy::Off;
+}
+
+std::string Burst::PlotHealth::toString(const HealthPolicy policy)
+{
+	switch (policy)
+	{
+	case HealthPolicy::Deprioritize: return "deprioritize";
+	case HealthPolicy::Skip: return "skip";
+	default: return "off";
+	}
+}
+
+void Burst::PlotHealth::beginRound(const Poco::UInt64 blockheight)
+{
+	Poco::ScopedLock<Poco::Mutex> lock{mutex_};
+
+	blockheight_ = blockheight;
+
+	for (auto& device : devices_)
+	{
+		device.second.slowReadsRound = 0;
+		device.second.errorsRound = 0;
+
+		// the device gets another chance, if it is still slow, it is quarantined again
+		if (device.second.quarantinedUntil != 0 && device.second.quarantinedUntil <= blockheight)
+		{
+			device.second.quarantinedUntil = 0;
+
+			for (const auto& dir : device.second.dirs)
+				log_information(MinerLogger::plotReader, "The quarantine of %s is over", dir);
+		}
+	}
+}
+
+void Burst::PlotHealth::addRead(const Poco::UInt64 device, const std::string& dir, const std::string& path, const double seconds)
+{
+	// the weight of a new measurement and the number of samples for the percentiles
+	const auto alpha = 0.2;
+	const size_t maxSamples = 256;
+	// a single slow read can be a disk, that needs to spin up
+	const auto maxSlowReads = 3u;
+
+	Poco::ScopedLock<Poco::Mutex> lock{mutex_};
+
+	auto& deviceHealth = devices_[device];
+	deviceHealth.dirs.emplace(dir);
+	deviceHealth.latency = deviceHealth.reads == 0 ? seconds : alpha * seconds + (1. - alpha) * deviceHealth.latency;
+	deviceHealth.samples.emplace_back(seconds);
+	++deviceHealth.reads;
+
+	if (deviceHealth.samples.size() > maxSamples)
+		deviceHealth.samples.pop_front();
+
+	auto& fileHealth = files_[path];
+	fileHealth.latency = fileHealth.reads == 0 ? seconds : alpha * seconds + (1. - alpha) * fileHealth.latency;
+	++fileHealth.reads;
+
+	// the unknown device 0 can be many disks, one of them must not quarantine the others
+	if (device != 0 && seconds >= slowRead_ && ++deviceHealth.slowReadsRound == maxSlowReads)
+		quarantine(deviceHealth, Poco::format("%u reads slower than %.1fs", maxSlowReads, slowRead_));
+}
+
+void Burst::PlotHealth::addError(const Poco::UInt64 device, const std::string& dir, const std::string& path)
+{
+	Poco::ScopedLock<Poco::Mutex> lock{mutex_};
+
+	auto& deviceHealth = devices_[device];
+	deviceHealth.dirs.emplace(dir);
+	++deviceHealth.errors;
+	++files_[path].errors;
+
+	log_warning(MinerLogger::plotReader, "Could not read %s", path);
+
+	if (++deviceHealth.errorsRound == 1 && device != 0)
+		quarantine(deviceHealth, "read error");
+}
+
+bool Burst::PlotHealth::isQuarantined(const Poco::UInt64 device)
+{
+	Poco::ScopedLock<Poco::Mutex> lock{mutex_};
+
+	if (policy_ == HealthPolicy::Off)
+		return false;
+
+	const auto iter = devices_.find(device);
+	return iter != devices_.end() && iter->second.quarantinedUntil > blockheight_;
+}
+
+bool Burst::PlotHealth::isSkipped(const Poco::UInt64 device)
+{
+	return getPolicy() == HealthPolicy::Skip && isQuarantined(device);
+}
+
+Poco::JSON::Object Burst::PlotHealth::toJSON()
+{
+	Poco::ScopedLock<Poco::Mutex> lock{mutex_};
+
+	Poco::JSON::Object json;
+	Poco::JSON::Array devices, files;
+
+	for (const auto& device : devices_)
+	{
+		Poco::JSON::Object deviceJson;
+		Poco::JSON::Array dirs;
+
+		for (const auto& dir : device.second.dirs)
+			dirs.add(dir);
+
+		deviceJson.set("dirs", dirs);
+		deviceJson.set("latency", device.second.latency * 1000);
+		deviceJson.set("p50", getPercentile(device.second.samples, .5) * 1000);
+		deviceJson.set("p95", getPercentile(device.second.samples, .95) * 1000);
+		deviceJson.set("p99", getPercentile(device.second.samples, .99) * 1000);
+		deviceJson.set("reads", device.second.reads);
+		deviceJson.set("errors", device.second.errors);
+		deviceJson.set("quarantined", policy_ != HealthPolicy::Off && device.second.quarantinedUntil > blockheight_);
+		devices.add(deviceJson);
+	}
+
+	// only the unhealthy files, a farm can have thousands of them
+	for (const auto& file : files_)
+	{
+		if (file.second.errors == 0 && file.second.latency < slowRead_)
+			continue;
+
+		Poco::JSON::Object fileJson;
+		fileJson.set("path", file.first);
+		fileJson.set("latency", file.second.latency * 1000);
+		fileJson.set("errors", file.second.errors);
+		files.add(fileJson);
+	}
+
+	json.set("type", "plot-health");
+	json.set("policy", toString(policy_));
+	json.set("devices", devices);
+	json.set("files", files);
+	return json;
+}
+
+void Burst::PlotHealth::quarantine(Device& device, const std::string& reason)
+{
+	if (policy_ == HealthPolicy::Off || device.quarantinedUntil > blockheight_)
+		return;
+
+	device.quarantinedUntil = blockheight_ + quarantineRounds_;
+
+	for (const auto& dir : device.dirs)
+		log_warning(MinerLogger::plotReader, "%s is quarantined for %u rounds (%s), it is %s",
+			dir, quarantineRounds_, reason,
+			std::string(policy_ == HealthPolicy::Skip ? "skipped" : "read last"));
+}
+
+double Burst::PlotHealth::getPercentile(const std::deque<double>& samples, const double percentile)
+{
+	if (samples.empty())
+		return 0.;
+
+	std::vector<double> sorted(samples.begin(), samples.end());
+	const auto nth = sorted.begin() + static_cast<size_t>(percentile * (sorted.size() - 1));
+	std::nth_element(sorted.begin(), nth, sorted.end());
+	return *nth;
+}
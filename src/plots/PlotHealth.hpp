@@ -0,0 +1,146 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#pragma once
+
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <Poco/Mutex.h>
+#include <Poco/Types.h>
+#include <Poco/JSON/Object.h>
+
+namespace Burst
+{
+	/**
+	 * \brief What happens with a device, that is quarantined.
+	 */
+	enum class HealthPolicy
+	{
+		Off,
+		Deprioritize,
+		Skip
+	};
+
+	/**
+	 * \brief Tracks the read latencies and errors of the plot files and devices.
+	 * A device is quarantined for some rounds, when it reads slowly or fails. Depending on the
+	 * policy, a quarantined device is read last or skipped, so that a dying disk does not stretch
+	 * the whole round.
+	 */
+	class PlotHealth
+	{
+	public:
+		~PlotHealth() = delete;
+
+		/**
+		 * \brief Sets the policy and its thresholds.
+		 * \param policy The policy for quarantined devices.
+		 * \param slowRead The time in seconds, from which on a read slice is slow.
+		 * \param quarantineRounds The number of rounds, a device stays quarantined.
+		 */
+		static void setPolicy(HealthPolicy policy, double slowRead, unsigned quarantineRounds);
+		static HealthPolicy getPolicy();
+
+		/**
+		 * \brief Parses a policy ("off", "deprioritize" or "skip").
+		 * \param policy The policy as string.
+		 * \return The policy, Off if the string is unknown.
+		 */
+		static HealthPolicy fromString(const std::string& policy);
+		static std::string toString(HealthPolicy policy);
+
+		/**
+		 * \brief Starts a new round, expired quarantines are lifted.
+		 * \param blockheight The height of the round.
+		 */
+		static void beginRound(Poco::UInt64 blockheight);
+
+		/**
+		 * \brief Adds the latency of a read.
+		 * The unknown device 0 is measured, but never quarantined.
+		 * \param device The device of the plot directory.
+		 * \param dir The path of the plot directory.
+		 * \param path The path of the plot file.
+		 * \param seconds The time needed for the read.
+		 */
+		static void addRead(Poco::UInt64 device, const std::string& dir, const std::string& path, double seconds);
+
+		/**
+		 * \brief Adds a failed read.
+		 * The unknown device 0 is never quarantined.
+		 * \param device The device of the plot directory.
+		 * \param dir The path of the plot directory.
+		 * \param path The path of the plot file.
+		 */
+		static void addError(Poco::UInt64 device, const std::string& dir, const std::string& path);
+
+		/**
+		 * \brief Checks, if a device is quarantined.
+		 * \param device The device.
+		 * \return true, if the policy is not off and the device is quarantined, false otherwise.
+		 */
+		static bool isQuarantined(Poco::UInt64 device);
+
+		/**
+		 * \brief Checks, if the reads of a device are skipped.
+		 * \param device The device.
+		 * \return true, if the device is quarantined and the policy skips it, false otherwise.
+		 */
+		static bool isSkipped(Poco::UInt64 device);
+
+		/**
+		 * \brief Creates the health of all devices and the unhealthy plot files.
+		 * \return The JSON object for the web interface.
+		 */
+		static Poco::JSON::Object toJSON();
+
+	private:
+		struct Device
+		{
+			std::set<std::string> dirs;
+			double latency = 0.;
+			std::deque<double> samples;
+			Poco::UInt64 reads = 0, errors = 0;
+			unsigned slowReadsRound = 0, errorsRound = 0;
+			Poco::UInt64 quarantinedUntil = 0;
+		};
+
+		struct File
+		{
+			double latency = 0.;
+			Poco::UInt64 reads = 0, errors = 0;
+		};
+
+		static void quarantine(Device& device, const std::string& reason);
+		static double getPercentile(const std::deque<double>& samples, double percentile);
+
+		static HealthPolicy policy_;
+		static double slowRead_;
+		static unsigned quarantineRounds_;
+		static Poco::UInt64 blockheight_;
+		static std::map<Poco::UInt64, Device> devices_;
+		static std::map<std::string, File> files_;
+		static Poco::Mutex mutex_;
+	};
+}
@@ -0,0 +1,171 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#include "PlotReadScheduler.hpp"
+#include "PlotHealth.hpp"
+#include <algorithm>
+#include <deque>
+
+std::map<std::string, double> Burst::PlotReadScheduler::throughput_;
+Poco::Mutex Burst::PlotReadScheduler::mutex_;
+
+void Burst::PlotReadScheduler::addMeasurement(const std::string& dir, const Poco::UInt64 bytes, const double seconds)
+{
+	if (bytes == 0 || seconds <= 0.)
+		return;
+
+	// the weight of a new measurement
+	const auto alpha = 0.3;
+	const auto throughput = bytes / seconds;
+
+	Poco::ScopedLock<Poco::Mutex> lock{mutex_};
+
+	auto iter = throughput_.find(dir);
+
+	if (iter == throughput_.end())
+		throughput_.emplace(dir, throughput);
+	else
+		iter->second = alpha * throughput + (1. - alpha) * iter->second;
+}
+
+double Burst::PlotReadScheduler::getThroughput(const std::string& dir)
+{
+	Poco::ScopedLock<Poco::Mutex> lock{mutex_};
+
+	const auto iter = throughput_.find(dir);
+
+	if (iter == throughput_.end())
+		return 0.;
+
+	return iter->second;
+}
+
+double Burst::PlotReadScheduler::getExpectedReadTime(const PlotReadNotification& notification)
+{
+	const auto bytes = static_cast<double>(getScoopBytes(notification));
+	auto throughput = getThroughput(notification.dir);
+
+	if (throughput <= 0.)
+	{
+		Poco::ScopedLock<Poco::Mutex> lock{mutex_};
+
+		// unknown dir, use the average throughput of all known dirs
+		for (const auto& known : throughput_)
+			throughput += known.second;
+
+		if (!throughput_.empty())
+			throughput /= throughput_.size();
+	}
+
+	// no measurement at all, so only the size matters
+	if (throughput <= 0.)
+		return bytes;
+
+	return bytes / throughput;
+}
+
+void Burst::PlotReadScheduler::schedule(std::vector<PlotReadNotification::Ptr>& notifications)
+{
+	struct Device
+	{
+		double expectedTime = 0.;
+		bool quarantined = false;
+		std::deque<std::pair<double, PlotReadNotification::Ptr>> notifications;
+	};
+
+	std::map<Poco::UInt64, Device> devices;
+
+	for (auto& notification : notifications)
+	{
+		auto& device = devices[notification->deviceId];
+		device.quarantined = PlotHealth::isQuarantined(notification->deviceId);
+		const auto expectedTime = getExpectedReadTime(*notification);
+		device.expectedTime += expectedTime;
+		device.notifications.emplace_back(expectedTime, notification);
+	}
+
+	std::vector<Device*> sortedDevices;
+
+	for (auto& device : devices)
+	{
+		// the longest job of the device first
+		std::stable_sort(device.second.notifications.begin(), device.second.notifications.end(),
+			[](const std::pair<double, PlotReadNotification::Ptr>& lhs, const std::pair<double, PlotReadNotification::Ptr>& rhs)
+		{
+			return lhs.first > rhs.first;
+		});
+
+		sortedDevices.emplace_back(&device.second);
+	}
+
+	// the device with the most work first
+	std::stable_sort(sortedDevices.begin(), sortedDevices.end(), [](const Device* lhs, const Device* rhs)
+	{
+		return lhs->expectedTime > rhs->expectedTime;
+	});
+
+	notifications.clear();
+
+	// interleave the devices, so that every device gets a reader as soon as possible,
+	// the quarantined devices get the readers, that are left over
+	for (const auto quarantined : {false, true})
+	{
+		auto remaining = true;
+
+		while (remaining)
+		{
+			remaining = false;
+
+			for (auto device : sortedDevices)
+			{
+				if (device->quarantined != quarantined || device->notifications.empty())
+					continue;
+
+				notifications.emplace_back(device->notifications.front().second);
+				device->notifications.pop_front();
+				remaining = true;
+			}
+		}
+	}
+}
+
+void Burst::PlotReadScheduler::sortByPhysicalOffset(std::vector<std::shared_ptr<PlotFile>>& plotList)
+{
+	std::stable_sort(plotList.begin(), plotList.end(), [](const std::shared_ptr<PlotFile>& lhs, const std::shared_ptr<PlotFile>& rhs)
+	{
+		return lhs->getPhysicalOffset() < rhs->getPhysicalOffset();
+	});
+}
+
+Poco::UInt64 Burst::PlotReadScheduler::getScoopBytes(const PlotReadNotification& notification)
+{
+	Poco::UInt64 bytes = 0;
+
+	for (const auto& plotFile : notification.plotList)
+		bytes += plotFile->getNonces() * Settings::ScoopSize;
+
+	for (const auto& relatedPlotList : notification.relatedPlotLists)
+		for (const auto& plotFile : relatedPlotList.second)
+			bytes += plotFile->getNonces() * Settings::ScoopSize;
+
+	return bytes;
+}
@@ -0,0 +1,90 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <Poco/Mutex.h>
+#include "PlotReader.hpp"
+
+namespace Burst
+{
+	/**
+	 * \brief Orders the plot read notifications of a round, so that all devices finish at about the same time.
+	 * The expected read time of every notification is estimated by the historical throughput of its
+	 * plot directory and the amount of bytes that need to be read.
+	 */
+	class PlotReadScheduler
+	{
+	public:
+		~PlotReadScheduler() = delete;
+
+		/**
+		 * \brief Adds a measured read throughput for a plot directory.
+		 * The throughput is smoothed over the rounds.
+		 * \param dir The path of the plot directory.
+		 * \param bytes The amount of bytes that were read.
+		 * \param seconds The time needed to read the bytes.
+		 */
+		static void addMeasurement(const std::string& dir, Poco::UInt64 bytes, double seconds);
+
+		/**
+		 * \brief Returns the smoothed read throughput of a plot directory.
+		 * \param dir The path of the plot directory.
+		 * \return The throughput in bytes per second, 0 if there was no measurement yet.
+		 */
+		static double getThroughput(const std::string& dir);
+
+		/**
+		 * \brief Estimates the time needed to read a plot read notification.
+		 * If there is no measurement for the plot directory yet, the average throughput of all
+		 * plot directories is used.
+		 * \param notification The plot read notification.
+		 * \return The expected read time in seconds.
+		 * If there is no measurement at all, the amount of bytes is returned.
+		 */
+		static double getExpectedReadTime(const PlotReadNotification& notification);
+
+		/**
+		 * \brief Sorts the plot read notifications of a round.
+		 * The devices with the longest expected read time are served first and the notifications of
+		 * the devices are interleaved, so that every device gets a plot reader as early as possible.
+		 * Quarantined devices are served after all other devices.
+		 * \param notifications The notifications, that will be sorted.
+		 */
+		static void schedule(std::vector<PlotReadNotification::Ptr>& notifications);
+
+		/**
+		 * \brief Sorts a list of plot files by their physical offset on the device.
+		 * \param plotList The list of plot files.
+		 */
+		static void sortByPhysicalOffset(std::vector<std::shared_ptr<PlotFile>>& plotList);
+
+	private:
+		static Poco::UInt64 getScoopBytes(const PlotReadNotification& notification);
+
+		static Poco::Mutex mutex_;
+		static std::map<std::string, double> throughput_;
+	};
+}
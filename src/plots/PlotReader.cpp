@@ -24,16 +24,27 @@
 #include "logging/MinerLogger.hpp"
 #include "mining/MinerConfig.hpp"
 #include <fstream>
+#include <algorithm>
 #include <utility>
 #include "mining/Miner.hpp"
 #include <Poco/NotificationQueue.h>
 #include "PlotVerifier.hpp"
 #include <Poco/Timestamp.h>
+#include <Poco/NumberFormatter.h>
 #include "logging/Output.hpp"
 #include "Plot.hpp"
 #include "logging/Performance.hpp"
+#include "PlotReadScheduler.hpp"
+#include "IoScheduler.hpp"
+#include "WakeUpScheduler.hpp"
+#include "PlotChecksum.hpp"
+#include "PlotHealth.hpp"
+#include "PlotStream.hpp"
+#include "VerifierBalance.hpp"
+#include "mining/Benchmark.hpp"
 
 Burst::GlobalBufferSize Burst::PlotReader::globalBufferSize;
+Burst::RoundEpoch Burst::PlotReader::roundEpoch;
 
 void Burst::GlobalBufferSize::setMax(const Poco::UInt64 max)
 {
@@ -80,16 +91,100 @@ Poco::UInt64 Burst::GlobalBufferSize::getMax() const
 	return max_;
 }
 
+Poco::UInt64 Burst::RoundEpoch::next()
+{
+	started_ = Poco::Timestamp().epochMicroseconds();
+	abortLatency_ = 0;
+	skipped_ = 0;
+	firstReadLatency_ = 0;
+	return ++epoch_;
+}
+
+Poco::UInt64 Burst::RoundEpoch::get() const
+{
+	return epoch_;
+}
+
+bool Burst::RoundEpoch::isCurrent(const Poco::UInt64 epoch) const
+{
+	return epoch_ == epoch;
+}
+
+void Burst::RoundEpoch::abandon()
+{
+	const auto latency = static_cast<Poco::UInt64>(Poco::Timestamp().epochMicroseconds() - started_);
+	auto abortLatency = abortLatency_.load();
+
+	while (latency > abortLatency && !abortLatency_.compare_exchange_weak(abortLatency, latency))
+	{
+	}
+}
+
+Poco::UInt64 Burst::RoundEpoch::getAbortLatency() const
+{
+	return abortLatency_;
+}
+
+Poco::UInt64 Burst::RoundEpoch::getElapsed() const
+{
+	return static_cast<Poco::UInt64>(Poco::Timestamp().epochMicroseconds() - started_);
+}
+
+bool Burst::RoundEpoch::isBudgetExceeded() const
+{
+	const Poco::UInt64 budget = budget_;
+	return budget > 0 && getElapsed() >= budget * 1000ull * 1000ull;
+}
+
+void Burst::RoundEpoch::setBudget(const Poco::UInt64 seconds)
+{
+	budget_ = seconds;
+}
+
+Poco::UInt64 Burst::RoundEpoch::getBudget() const
+{
+	return budget_;
+}
+
+void Burst::RoundEpoch::addSkipped(const Poco::UInt64 bytes)
+{
+	skipped_ += bytes;
+}
+
+Poco::UInt64 Burst::RoundEpoch::getSkipped() const
+{
+	return skipped_;
+}
+
+void Burst::RoundEpoch::firstRead(const Poco::UInt64 epoch)
+{
+	if (firstReadLatency_ != 0 || !isCurrent(epoch))
+		return;
+
+	Poco::UInt64 expected = 0;
+	firstReadLatency_.compare_exchange_strong(expected, std::max(getElapsed(), Poco::UInt64{1}));
+}
+
+Poco::UInt64 Burst::RoundEpoch::getFirstReadLatency() const
+{
+	return firstReadLatency_;
+}
+
 Burst::PlotReader::PlotReader(MinerData& data, std::shared_ptr<PlotReadProgress> progress,
-                              Poco::NotificationQueue& verificationQueue, Poco::NotificationQueue& plotReadQueue)
-	: Task("PlotReader"), data_(data), progress_{std::move(progress)}, verificationQueue_{&verificationQueue},
-	  plotReadQueue_(&plotReadQueue)
+                              std::shared_ptr<PlotReadProgress> progressVerify,
+                              Poco::NotificationQueue& verificationQueue, Poco::NotificationQueue& gpuVerificationQueue,
+                              Poco::NotificationQueue& plotReadQueue)
+	: Task("PlotReader"), data_(data), progress_{std::move(progress)}, progressVerify_{std::move(progressVerify)},
+	  verificationQueue_{&verificationQueue}, gpuVerificationQueue_{&gpuVerificationQueue}, plotReadQueue_(&plotReadQueue)
 {
 }
 
 void Burst::PlotReader::runTask()
 {
-	std::vector<ScoopData> bufferMirror;
+	ScoopBuffer bufferMirror;
+
+	// the chunk buffers are first touched here, so they are allocated on the NUMA node of the reader
+	setThreadAffinity(MinerConfig::getConfig().getReaderCpus());
 
 	while (!isCancelled())
 	{
@@ -105,10 +200,13 @@ void Burst::PlotReader::runTask()
 
 			START_PROBE_DOMAIN("PlotReader.ReadDir", plotReadNotification->dir)
 
-			// only process the current block
-			if (data_.getCurrentBlockheight() != plotReadNotification->blockheight)
+			// only process the current round
+			if (!roundEpoch.isCurrent(plotReadNotification->epoch))
 				continue;
 
+			if (RoundStats::isActive() && !plotReadNotification->wakeUpCall)
+				RoundStats::add(RoundStats::Stage::ReadQueue, plotReadNotification->enqueued.elapsed());
+
 			auto poc2 = false;
 
 			if (MinerConfig::getConfig().getPoc2StartBlock() > 0)
@@ -117,7 +215,7 @@ void Burst::PlotReader::runTask()
 			Poco::Timestamp timeStartDir;
 
 			// check, if the incoming plot-read-notification is for the current round
-			auto currentBlock = plotReadNotification->blockheight == data_.getCurrentBlockheight();
+			auto currentBlock = roundEpoch.isCurrent(plotReadNotification->epoch);
 			auto& plotList = plotReadNotification->plotList;
 
 			// put in all related plot files
@@ -125,230 +223,196 @@ void Burst::PlotReader::runTask()
 				for (const auto& relatedPlotFile : relatedPlotList.second)
 					plotList.emplace_back(relatedPlotFile);
 
-			for (auto plotFileIter = plotList.begin(); plotFileIter != plotList.end() && !isCancelled() && currentBlock; ++plotFileIter)
+			if (plotReadNotification->wakeUpCall)
+			{
+				const Poco::Timestamp wakeUpStart;
+
+				// the time of a disk, that is already spinning, tells nothing about its spin-up
+				const auto wasActive = getDevicePowerState(plotReadNotification->dir) == DevicePowerState::Active;
+
+				for (const auto& plotFile : plotList)
+				{
+					auto inputStream = PlotStream::open(*plotFile);
+
+					if (!inputStream->isOpen())
+						continue;
+
+					// its just a wake up call for the HDD, simply read one byte,
+					// every time at another position, so that it does not come from the page cache
+					char dummyByte;
+					inputStream->seek(WakeUpScheduler::getWakeUpOffset(plotReadNotification->dir, plotFile->getSize()));
+					inputStream->read(&dummyByte, 1);
+
+					// a sleeping disk needs to spin up first
+					const auto spinUp = wakeUpStart.elapsed() / 1000000.;
+
+					if (!wasActive)
+						WakeUpScheduler::addSpinUp(plotReadNotification->dir, spinUp);
+
+					WakeUpScheduler::wokeUp(plotReadNotification->dir);
+
+					log_debug(MinerLogger::plotReader, "Woke up the HDD %s in %ss", plotReadNotification->dir,
+						Poco::NumberFormatter::format(spinUp, 3));
+
+					// ... and then jump to the next notification, no need to search for deadlines
+					break;
+				}
+
+				continue;
+			}
+
+			const auto readPlan = createReadPlan(*plotReadNotification);
+
+			struct FileState
 			{
-				auto& plotFile = **plotFileIter;
-				std::ifstream inputStream(plotFile.getPath(), std::ifstream::in | std::ifstream::binary);
+				std::unique_ptr<PlotStream> stream;
+				std::unique_ptr<std::istream> sidecar;
+				Poco::Timestamp timeStart;
+				size_t remainingReads = 0;
+			};
 
-				START_PROBE_DOMAIN("PlotReader.ReadFile", plotFile.getPath())
-				Poco::Timestamp timeStartFile;
+			std::vector<FileState> files(plotList.size());
+			size_t filesDone = 0;
+
+			for (const auto& readRequest : readPlan)
+				++files[readRequest.fileIndex].remainingReads;
+
+			auto readRequest = readPlan.begin();
+
+			for (; readRequest != readPlan.end() && !isCancelled() && currentBlock; ++readRequest)
+			{
+				// the round took too long or the device is quarantined, skip the rest
+				if (roundEpoch.isBudgetExceeded() || PlotHealth::isSkipped(plotReadNotification->deviceId))
+					break;
 
-				if (!isCancelled() && inputStream.is_open())
+				auto& plotFile = *plotList[readRequest->fileIndex];
+				auto& fileState = files[readRequest->fileIndex];
+
+				if (fileState.stream == nullptr)
 				{
-					if (plotReadNotification->wakeUpCall)
-					{
-						// its just a wake up call for the HDD, simply read the first byte
-						char dummyByte;
-						//
-						inputStream.read(&dummyByte, 1);
-
-						// close the file ...
-						inputStream.close();
-
-						log_debug(MinerLogger::plotReader, "Woke up the HDD %s", plotReadNotification->dir);
-
-						// ... and then jump to the next notification, no need to search for deadlines
-						break;
-					}
-
-					const auto maxBufferSize = MinerConfig::getConfig().getMaxBufferSize();
-					auto chunkBytes = maxBufferSize / MinerConfig::getConfig().getBufferChunkCount();
-
-					// unlimited buffer size
-					if (maxBufferSize == 0)
-						chunkBytes = plotFile.getStaggerScoopBytes();
-
-					const auto noncesPerChunk = std::min(chunkBytes / Settings::ScoopSize, plotFile.getStaggerSize());
-					auto nonce = 0ull;
-
-					while (nonce < plotFile.getNonces() && currentBlock && !isCancelled())
-					{
-						START_PROBE_DOMAIN("PlotReader.Nonces", plotFile.getPath());
-						const auto startNonce = nonce;
-						auto readNonces = noncesPerChunk;
-						const auto staggerBegin = startNonce / plotFile.getStaggerSize();
-						const auto staggerEnd = (startNonce + readNonces) / plotFile.getStaggerSize();
-
-						if (staggerBegin != staggerEnd)
-							readNonces = plotFile.getStaggerSize() - startNonce % plotFile.getStaggerSize();
-
-						auto memoryAcquired = false;
-						auto memoryAcquiredMirror = false;
-						const auto memoryToAcquire = std::min(readNonces * Settings::ScoopSize, chunkBytes);
-
-						START_PROBE_DOMAIN("PlotReader.AllocMemory", plotFile.getPath());
-						while (!isCancelled() && !memoryAcquired)
-						{
-							memoryAcquired = globalBufferSize.reserve(memoryToAcquire);
-
-							if ((poc2 && !plotFile.isPoC(2)) || (!poc2 && plotFile.isPoC(2)))
-								while (!isCancelled() && !memoryAcquiredMirror)
-									memoryAcquiredMirror = globalBufferSize.reserve(memoryToAcquire);
-						}
-						TAKE_PROBE_DOMAIN("PlotReader.AllocMemory", plotFile.getPath());
-
-						// if the reader is cancelled, jump out of the loop
-						if (isCancelled())
-						{
-							// but first give free the allocated memory
-							if (memoryAcquired)
-								globalBufferSize.free(memoryToAcquire);
-
-							if (memoryAcquiredMirror)
-								globalBufferSize.free(memoryToAcquire);
-
-							continue;
-						}
-
-						if (memoryAcquired && currentBlock)
-						{
-							START_PROBE_DOMAIN("PlotReader.PushWork", plotFile.getPath());
-							const auto chunkOffset = startNonce % plotFile.getStaggerSize() * Settings::ScoopSize;
-							const auto staggerBlockOffset = staggerBegin * plotFile.getStaggerBytes();
-							const auto staggerScoopOffset = plotReadNotification->scoopNum * plotFile.getStaggerScoopBytes();
-
-							START_PROBE("PlotReader.CreateVerification");
-							VerifyNotification::Ptr verification(new VerifyNotification{});
-							verification->accountId = plotFile.getAccountId();
-							verification->nonceStart = plotFile.getNonceStart();
-							verification->block = plotReadNotification->blockheight;
-							verification->inputPath = plotFile.getPath();
-							verification->gensig = plotReadNotification->gensig;
-							verification->nonceRead = startNonce;
-							verification->baseTarget = plotReadNotification->baseTarget;
-							verification->memorySize = memoryToAcquire;
-
-							memoryAcquired = false;
-
-							while (!memoryAcquired && !isCancelled())
-							{
-								try
-								{
-									verification->buffer.resize(readNonces);
-									memoryAcquired = true;
-								}
-								catch (std::bad_alloc&)
-								{
-								}
-								catch (...)
-								{
-									globalBufferSize.free(memoryToAcquire);
-									throw;
-								}
-							}
-
-							if (memoryAcquiredMirror)
-							{
-								memoryAcquiredMirror = false;
-
-								while (!memoryAcquiredMirror && !isCancelled())
-								{
-									try
-									{
-										bufferMirror.resize(readNonces);
-										memoryAcquiredMirror = true;
-									}
-									catch (std::bad_alloc&)
-									{
-									}
-									catch (...)
-									{
-										globalBufferSize.free(memoryToAcquire);
-										throw;
-									}
-								}
-							}
-							TAKE_PROBE("PlotReader.CreateVerification");
-
-							START_PROBE_DOMAIN("PlotReader.SeekAndRead", plotFile.getPath());
-							inputStream.seekg(staggerBlockOffset + staggerScoopOffset + chunkOffset);
-							inputStream.read(reinterpret_cast<char*>(&verification->buffer[0]), memoryToAcquire);
-
-							if (memoryAcquiredMirror)
-							{
-								const auto staggerScoopOffsetMirror = (4095 - plotReadNotification->scoopNum) * plotFile.getStaggerScoopBytes();
-								inputStream.seekg(staggerBlockOffset + staggerScoopOffsetMirror + chunkOffset);
-								inputStream.read(reinterpret_cast<char*>(&bufferMirror[0]), memoryToAcquire);
-
-								for (size_t i = 0; i < verification->buffer.size(); ++i)
-									memcpy(&verification->buffer[i][32], &bufferMirror[i][32], 32);
-
-								bufferMirror.clear();
-								globalBufferSize.free(memoryToAcquire);
-							}
-							TAKE_PROBE_DOMAIN("PlotReader.SeekAndRead", plotFile.getPath());
-
-							verificationQueue_->enqueueNotification(verification);
-
-							if (MinerConfig::getConfig().isSteadyProgressBar() && progress_ != nullptr)
-								progress_->add(readNonces * Settings::PlotSize, plotReadNotification->blockheight);
-
-							// check, if the incoming plot-read-notification is for the current round
-							currentBlock = plotReadNotification->blockheight == data_.getCurrentBlockheight();
-							nonce += readNonces;
-
-							TAKE_PROBE_DOMAIN("PlotReader.PushWork", plotFile.getPath());
-						}
-						// if the memory was acquired, but it was not the right block, give it free
-						else if (memoryAcquired)
-							globalBufferSize.free(memoryToAcquire);
-							// this should never happen.. no memory allocated, not cancelled, wrong block
-						else;
-						TAKE_PROBE_DOMAIN("PlotReader.Nonces", plotFile.getPath());
-					}
+					fileState.stream = PlotStream::open(plotFile);
+					fileState.timeStart.update();
+
+					// the sidecar is opened once for all reads of the plot file
+					if (MinerConfig::getConfig().isPlotChecksums() && !plotFile.isVirtual())
+						fileState.sidecar = PlotChecksum::open(plotFile);
 				}
 
-				inputStream.close();
+				// the nonces were verified before the miner was restarted
+				if (data_.getCheckpoint().isVerified(plotReadNotification->blockheight, plotFile.getPath(),
+					readRequest->startNonce, readRequest->nonces))
+				{
+					const auto bytes = readRequest->nonces * Settings::PlotSize;
+
+					if (MinerConfig::getConfig().isSteadyProgressBar() && progress_ != nullptr)
+						progress_->add(bytes, plotReadNotification->blockheight);
+
+					if (progressVerify_ != nullptr)
+						progressVerify_->add(bytes, plotReadNotification->blockheight);
+				}
+				else
+				{
+					START_PROBE_DOMAIN("PlotReader.Nonces", plotFile.getPath());
+					if (fileState.stream->isOpen())
+						readChunk(*plotReadNotification, plotFile, *fileState.stream, fileState.sidecar.get(), *readRequest, poc2,
+							bufferMirror);
+					TAKE_PROBE_DOMAIN("PlotReader.Nonces", plotFile.getPath());
+				}
 
 				// check, if the incoming plot-read-notification is for the current round
-				currentBlock = plotReadNotification->blockheight == data_.getCurrentBlockheight();
+				currentBlock = roundEpoch.isCurrent(plotReadNotification->epoch);
+
+				if (isCancelled() || !currentBlock || --fileState.remainingReads > 0)
+					continue;
+
+				// the last chunk of the plot file was read
+				fileState.stream.reset();
+				fileState.sidecar.reset();
+				++filesDone;
+
+				const auto fileReadDiff = fileState.timeStart.elapsed();
+				const auto fileReadDiffSeconds = static_cast<float>(fileReadDiff) / 1000 / 1000;
+				const Poco::Timespan span{fileReadDiff};
 
-				if (!isCancelled() && currentBlock)
+				const auto plotListSize = plotReadNotification->plotList.size();
+
+				if (plotListSize > 0)
 				{
-					const auto fileReadDiff = timeStartFile.elapsed();
-					const auto fileReadDiffSeconds = static_cast<float>(fileReadDiff) / 1000 / 1000;
-					const Poco::Timespan span{fileReadDiff};
-
-					const auto plotListSize = plotReadNotification->plotList.size();
-
-					if (plotListSize > 0)
-					{
-						data_.getBlockData()->setProgress(
-							plotReadNotification->dir,
-							static_cast<float>(std::distance(plotReadNotification->plotList.begin(), plotFileIter) + 1) / plotListSize
-							* 100.f,
-							plotReadNotification->blockheight
-						);
-					}
-
-					const auto nonceBytes = static_cast<double>(plotFile.getNonces() * Settings::ScoopSize);
-					const auto bytesPerSeconds = nonceBytes / fileReadDiffSeconds;
-
-					log_information_if(MinerLogger::plotReader, MinerLogger::hasOutput(PlotDone), "%s (%s) read in %ss (~%s/s)",
-						plotFile.getPath(),
-						memToString(plotFile.getSize(), 2),
-						Poco::DateTimeFormatter::format(span, "%s.%i"),
-						memToString(static_cast<Poco::UInt64>(bytesPerSeconds), 2));
-
-					if (!MinerConfig::getConfig().isSteadyProgressBar() && progress_ != nullptr)
-					{
-						START_PROBE("PlotReader.Progress")
-						progress_->add(plotFile.getSize(), plotReadNotification->blockheight);
-						TAKE_PROBE("PlotReader.Progress")
-					}
+					data_.getBlockData()->setProgress(
+						plotReadNotification->dir,
+						static_cast<float>(filesDone) / plotListSize * 100.f,
+						plotReadNotification->blockheight
+					);
 				}
 
-				// if it was cancelled, we push the current plot dir back in the queue again
-				if (isCancelled())
-					plotReadQueue_->enqueueNotification(plotReadNotification);
+				const auto nonceBytes = static_cast<double>(plotFile.getNonces() * Settings::ScoopSize);
+				const auto bytesPerSeconds = nonceBytes / fileReadDiffSeconds;
+
+				if (plotReadNotification->type == PlotDir::Type::Parallel)
+					PlotReadScheduler::addMeasurement(plotReadNotification->dir, plotFile.getNonces() * Settings::ScoopSize,
+						fileReadDiffSeconds);
+
+				log_information_if(MinerLogger::plotReader, MinerLogger::hasOutput(PlotDone), "%s (%s) read in %ss (~%s/s)",
+					plotFile.getPath(),
+					memToString(plotFile.getSize(), 2),
+					Poco::DateTimeFormatter::format(span, "%s.%i"),
+					memToString(static_cast<Poco::UInt64>(bytesPerSeconds), 2));
 
-				TAKE_PROBE_DOMAIN("PlotReader.ReadFile", plotFile.getPath());
+				if (!MinerConfig::getConfig().isSteadyProgressBar() && progress_ != nullptr)
+				{
+					START_PROBE("PlotReader.Progress")
+					progress_->add(plotFile.getSize(), plotReadNotification->blockheight);
+					TAKE_PROBE("PlotReader.Progress")
+				}
 			}
 
-			if (plotReadNotification->wakeUpCall)
+			// if it was cancelled, we push the current plot dir back in the queue again
+			if (isCancelled())
+			{
+				plotReadQueue_->enqueueNotification(plotReadNotification);
+				continue;
+			}
+
+			// the round is over, stop here
+			if (!currentBlock)
+			{
+				roundEpoch.abandon();
 				continue;
+			}
+
+			// the round budget was exceeded or the device is quarantined, the unread scoops
+			// are counted as processed, so that the round can finish
+			if (readRequest != readPlan.end())
+			{
+				Poco::UInt64 skippedBytes = 0;
+				Poco::UInt64 skippedFileBytes = 0;
+
+				for (; readRequest != readPlan.end(); ++readRequest)
+				{
+					skippedBytes += readRequest->nonces * Settings::PlotSize;
+
+					if (--files[readRequest->fileIndex].remainingReads == 0)
+						skippedFileBytes += plotList[readRequest->fileIndex]->getSize();
+				}
+
+				roundEpoch.addSkipped(skippedBytes);
+
+				log_debug(MinerLogger::plotReader, "%s, skipped %s of %s",
+					std::string(PlotHealth::isSkipped(plotReadNotification->deviceId) ? "Device quarantined" : "Round budget exceeded"),
+					memToString(skippedBytes, 2), plotReadNotification->dir);
+
+				if (progress_ != nullptr)
+					progress_->add(MinerConfig::getConfig().isSteadyProgressBar() ? skippedBytes : skippedFileBytes,
+						plotReadNotification->blockheight);
+
+				if (progressVerify_ != nullptr)
+					progressVerify_->add(skippedBytes, plotReadNotification->blockheight);
+
+				currentBlock = false;
+			}
 
 			data_.getBlockData()->setProgress(plotReadNotification->dir, 100.f, plotReadNotification->blockheight);
+			IoScheduler::finishRoundRead(plotReadNotification->deviceId);
 
 			const auto dirReadDiff = timeStartDir.elapsed();
 			const auto dirReadDiffSeconds = static_cast<float>(dirReadDiff) / 1000 / 1000;
@@ -365,6 +429,8 @@ void Burst::PlotReader::runTask()
 				const auto sumNoncesBytes = static_cast<float>(sumNonces * Settings::ScoopSize);
 				const auto bytesPerSecond = sumNoncesBytes / dirReadDiffSeconds;
 
+				PlotReadScheduler::addMeasurement(plotReadNotification->dir, sumNonces * Settings::ScoopSize, dirReadDiffSeconds);
+
 				std::stringstream sstr;
 
 				sstr << plotReadNotification->dir;
@@ -398,6 +464,329 @@ void Burst::PlotReader::runTask()
 	}
 }
 
+std::vector<Burst::PlotReader::ReadRequest> Burst::PlotReader::createReadPlan(const PlotReadNotification& notification)
+{
+	std::vector<ReadRequest> readPlan;
+	auto physicalOrder = true;
+
+	const auto maxBufferSize = MinerConfig::getConfig().getMaxBufferSize();
+
+	for (size_t fileIndex = 0; fileIndex < notification.plotList.size(); ++fileIndex)
+	{
+		const auto& plotFile = *notification.plotList[fileIndex];
+		auto chunkBytes = maxBufferSize / MinerConfig::getConfig().getBufferChunkCount();
+
+		// unlimited buffer size
+		if (maxBufferSize == 0)
+			chunkBytes = plotFile.getStaggerScoopBytes();
+
+		auto noncesPerChunk = std::max(std::min(chunkBytes / Settings::ScoopSize, plotFile.getStaggerSize()), Poco::UInt64{1});
+
+		// every stripe needs at least one read
+		if (MinerConfig::getConfig().isProgressiveReading())
+		{
+			const auto stripes = MinerConfig::getConfig().getProgressiveStripes();
+			noncesPerChunk = std::max(std::min(noncesPerChunk, (plotFile.getNonces() + stripes - 1) / stripes), Poco::UInt64{1});
+		}
+		auto nonce = 0ull;
+		size_t fileReads = 0;
+
+		while (nonce < plotFile.getNonces())
+		{
+			++fileReads;
+
+			ReadRequest readRequest;
+			readRequest.fileIndex = fileIndex;
+			readRequest.startNonce = nonce;
+			readRequest.nonces = noncesPerChunk;
+
+			const auto staggerBegin = nonce / plotFile.getStaggerSize();
+			const auto staggerEnd = (nonce + noncesPerChunk) / plotFile.getStaggerSize();
+
+			// a chunk never overlaps two staggers
+			if (staggerBegin != staggerEnd)
+				readRequest.nonces = plotFile.getStaggerSize() - nonce % plotFile.getStaggerSize();
+
+			readRequest.offset = staggerBegin * plotFile.getStaggerBytes() +
+				notification.scoopNum * plotFile.getStaggerScoopBytes() +
+				nonce % plotFile.getStaggerSize() * Settings::ScoopSize;
+
+			readRequest.physicalOffset = 0;
+			readRequest.stripe = 0;
+
+			if (physicalOrder)
+				physicalOrder = plotFile.getPhysicalOffset(readRequest.offset, readRequest.physicalOffset);
+
+			readPlan.emplace_back(readRequest);
+			nonce += readRequest.nonces;
+		}
+
+		// the stripe of a read is its relative position inside the plot file
+		if (MinerConfig::getConfig().isProgressiveReading())
+		{
+			const auto stripes = MinerConfig::getConfig().getProgressiveStripes();
+
+			for (auto i = readPlan.size() - fileReads; i < readPlan.size(); ++i)
+				readPlan[i].stripe = (i - (readPlan.size() - fileReads)) * stripes / fileReads;
+		}
+	}
+
+	// if all physical positions are known, we read them like an elevator
+	// from the beginning to the end of the device, otherwise file by file;
+	// when reading progressively, every stripe is read on its own
+	std::stable_sort(readPlan.begin(), readPlan.end(), [physicalOrder](const ReadRequest& lhs, const ReadRequest& rhs)
+	{
+		if (lhs.stripe != rhs.stripe)
+			return lhs.stripe < rhs.stripe;
+
+		if (physicalOrder)
+			return lhs.physicalOffset < rhs.physicalOffset;
+
+		return false;
+	});
+
+	return readPlan;
+}
+
+bool Burst::PlotReader::readChunk(const PlotReadNotification& notification, const PlotFile& plotFile,
+	PlotStream& inputStream, std::istream* sidecar, const ReadRequest& readRequest, const bool poc2, ScoopBuffer& bufferMirror)
+{
+	const auto readNonces = readRequest.nonces;
+	const auto memoryToAcquire = readNonces * Settings::ScoopSize;
+	const auto mirror = (poc2 && !plotFile.isPoC(2)) || (!poc2 && plotFile.isPoC(2));
+
+	const auto epoch = notification.epoch;
+	auto memoryAcquired = false;
+	auto memoryAcquiredMirror = false;
+
+	START_PROBE_DOMAIN("PlotReader.AllocMemory", plotFile.getPath());
+	const Poco::Timestamp allocationStart;
+
+	while (!isCancelled() && roundEpoch.isCurrent(epoch) && !memoryAcquired)
+	{
+		memoryAcquired = globalBufferSize.reserve(memoryToAcquire);
+
+		if (mirror)
+			while (!isCancelled() && roundEpoch.isCurrent(epoch) && !memoryAcquiredMirror)
+				memoryAcquiredMirror = globalBufferSize.reserve(memoryToAcquire);
+	}
+	TAKE_PROBE_DOMAIN("PlotReader.AllocMemory", plotFile.getPath());
+
+	if (RoundStats::isActive())
+		RoundStats::add(RoundStats::Stage::Allocation, allocationStart.elapsed());
+
+	// if the reader is cancelled or the round is over, give free the allocated memory
+	if (isCancelled() || !roundEpoch.isCurrent(epoch) || !memoryAcquired)
+	{
+		if (memoryAcquired)
+			globalBufferSize.free(memoryToAcquire);
+
+		if (memoryAcquiredMirror)
+			globalBufferSize.free(memoryToAcquire);
+
+		return false;
+	}
+
+	START_PROBE_DOMAIN("PlotReader.PushWork", plotFile.getPath());
+
+	START_PROBE("PlotReader.CreateVerification");
+	// from now on, the verification gives the reserved memory free when it is destroyed
+	VerifyNotification::Ptr verification(new VerifyNotification{});
+	verification->memorySize = memoryToAcquire;
+	verification->accountId = plotFile.getAccountId();
+	verification->nonceStart = plotFile.getNonceStart();
+	verification->block = notification.blockheight;
+	verification->inputPath = plotFile.getPath();
+	verification->gensig = notification.gensig;
+	verification->nonceRead = readRequest.startNonce;
+	verification->baseTarget = notification.baseTarget;
+	verification->epoch = epoch;
+
+	memoryAcquired = false;
+
+	while (!memoryAcquired && !isCancelled())
+	{
+		try
+		{
+			verification->buffer.resize(readNonces);
+			memoryAcquired = true;
+		}
+		catch (std::bad_alloc&)
+		{
+		}
+		catch (...)
+		{
+			if (memoryAcquiredMirror)
+				globalBufferSize.free(memoryToAcquire);
+
+			throw;
+		}
+	}
+
+	// the mirror buffer is only needed while reading
+	const auto mirrorReserved = memoryAcquiredMirror;
+
+	if (memoryAcquiredMirror)
+	{
+		memoryAcquiredMirror = false;
+
+		while (!memoryAcquiredMirror && !isCancelled())
+		{
+			try
+			{
+				bufferMirror.resize(readNonces);
+				memoryAcquiredMirror = true;
+			}
+			catch (std::bad_alloc&)
+			{
+			}
+			catch (...)
+			{
+				globalBufferSize.free(memoryToAcquire);
+				throw;
+			}
+		}
+	}
+	TAKE_PROBE("PlotReader.CreateVerification");
+
+	if (!memoryAcquired || (mirrorReserved && !memoryAcquiredMirror))
+	{
+		if (mirrorReserved)
+			globalBufferSize.free(memoryToAcquire);
+
+		return false;
+	}
+
+	START_PROBE_DOMAIN("PlotReader.SeekAndRead", plotFile.getPath());
+	const Poco::Timestamp readStart;
+	auto read = readSliced(notification, plotFile, inputStream, readRequest.offset,
+		reinterpret_cast<char*>(&verification->buffer[0]), memoryToAcquire);
+
+	// the scoops are checked as they are stored, before the halves of the mirror are merged
+	const auto checkScoop = [&](const Poco::UInt64 scoop, const ScoopBuffer& buffer)
+	{
+		if (sidecar == nullptr)
+			return;
+
+		for (const auto& region : PlotChecksum::check(plotFile, *sidecar, scoop, readRequest.startNonce, readNonces,
+			reinterpret_cast<const char*>(&buffer[0])))
+		{
+			log_warning(MinerLogger::plotReader, "Checksum mismatch in %s, scoop %Lu, nonces %Lu - %Lu",
+				plotFile.getPath(), region.scoop, plotFile.getNonceStart() + region.startNonce,
+				plotFile.getNonceStart() + region.startNonce + region.nonces - 1);
+
+			data_.getBlockData()->addCorruptedRegion(plotFile.getPath(), region);
+		}
+	};
+
+	if (read)
+		checkScoop(notification.scoopNum, verification->buffer);
+
+	if (read && memoryAcquiredMirror)
+	{
+		const auto scoopMirror = Settings::ScoopPerPlot - 1 - notification.scoopNum;
+		const auto scoopOffset = notification.scoopNum * plotFile.getStaggerScoopBytes();
+		const auto scoopOffsetMirror = scoopMirror * plotFile.getStaggerScoopBytes();
+		read = readSliced(notification, plotFile, inputStream, readRequest.offset - scoopOffset + scoopOffsetMirror,
+			reinterpret_cast<char*>(&bufferMirror[0]), memoryToAcquire);
+
+		if (read)
+		{
+			checkScoop(scoopMirror, bufferMirror);
+
+			for (size_t i = 0; i < verification->buffer.size(); ++i)
+				memcpy(&verification->buffer[i][32], &bufferMirror[i][32], 32);
+		}
+
+		bufferMirror.clear();
+	}
+
+	if (mirrorReserved)
+		globalBufferSize.free(memoryToAcquire);
+	TAKE_PROBE_DOMAIN("PlotReader.SeekAndRead", plotFile.getPath());
+
+	if (RoundStats::isActive() && read)
+		RoundStats::add(RoundStats::Stage::Read, readStart.elapsed(), memoryToAcquire * (memoryAcquiredMirror ? 2 : 1));
+
+	if (!read)
+	{
+		// the chunk could not be read, it is not verified, but counted as skipped, so that the round can finish
+		if (!isCancelled() && roundEpoch.isCurrent(epoch))
+		{
+			const auto bytes = readNonces * Settings::PlotSize;
+
+			roundEpoch.addSkipped(bytes);
+
+			if (MinerConfig::getConfig().isSteadyProgressBar() && progress_ != nullptr)
+				progress_->add(bytes, notification.blockheight);
+
+			if (progressVerify_ != nullptr)
+				progressVerify_->add(bytes, notification.blockheight);
+
+			log_warning(MinerLogger::plotReader, "Could not read %s of %s, the nonces %Lu - %Lu are skipped",
+				memToString(memoryToAcquire, 2), plotFile.getPath(), plotFile.getNonceStart() + readRequest.startNonce,
+				plotFile.getNonceStart() + readRequest.startNonce + readNonces - 1);
+
+			return false;
+		}
+
+		// the round ended while reading, the verification and its memory are thrown away
+		roundEpoch.abandon();
+		return false;
+	}
+
+	auto verificationQueue = verificationQueue_;
+
+	// in hybrid mode the chunk goes to the verifiers, that are expected to finish it first
+	if (VerifierBalance::isActive())
+	{
+		verification->backend = VerifierBalance::assign(verification->buffer.size());
+
+		if (verification->backend == VerifierBackend::Gpu)
+			verificationQueue = gpuVerificationQueue_;
+	}
+
+	verification->enqueued.update();
+	verificationQueue->enqueueNotification(verification);
+
+	if (MinerConfig::getConfig().isSteadyProgressBar() && progress_ != nullptr)
+		progress_->add(readNonces * Settings::PlotSize, notification.blockheight);
+
+	TAKE_PROBE_DOMAIN("PlotReader.PushWork", plotFile.getPath());
+	return true;
+}
+
+bool Burst::PlotReader::readSliced(const PlotReadNotification& notification, const PlotFile& plotFile,
+	PlotStream& inputStream, const Poco::UInt64 offset, char* buffer, const Poco::UInt64 size) const
+{
+	// big reads are split, so that a new round does not need to wait for them
+	const Poco::UInt64 sliceSize = 4 * 1024 * 1024;
+	const auto epoch = notification.epoch;
+
+	inputStream.seek(offset);
+
+	for (Poco::UInt64 position = 0; position < size; position += sliceSize)
+	{
+		if (isCancelled() || !roundEpoch.isCurrent(epoch))
+			return false;
+
+		const Poco::Timestamp sliceStart;
+		inputStream.read(buffer + position, std::min(sliceSize, size - position));
+		roundEpoch.firstRead(epoch);
+
+		// the buffer holds no complete data anymore, so the rest of the read is useless
+		if (!inputStream.isGood())
+		{
+			PlotHealth::addError(notification.deviceId, notification.dir, plotFile.getPath());
+			return false;
+		}
+
+		PlotHealth::addRead(notification.deviceId, notification.dir, plotFile.getPath(), sliceStart.elapsed() / 1000000.);
+	}
+
+	return true;
+}
+
 void Burst::PlotReadProgress::reset(Poco::UInt64 blockheight, uintmax_t max)
 {
 	std::lock_guard<std::mutex> guard(mutex_);
@@ -24,12 +24,15 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <iosfwd>
 #include <thread>
 #include <mutex>
 #include "Declarations.hpp"
+#include "HugePages.hpp"
 #include <Poco/Task.h>
 #include <atomic>
 #include <Poco/Notification.h>
+#include <Poco/Timestamp.h>
 #include "mining/MinerConfig.hpp"
 #include "Plot.hpp"
 
@@ -42,6 +45,7 @@ namespace Burst
 {
 	class MinerData;
 	class PlotReadProgress;
+	class PlotStream;
 
 	class GlobalBufferSize
 	{
@@ -59,6 +63,104 @@ namespace Burst
 		mutable Poco::FastMutex mutex_;
 	};
 
+	/**
+	 * \brief The epoch of the current mining round.
+	 * Every queued or running piece of work carries the epoch of the round it belongs to.
+	 * When a new round starts, the epoch is increased and all work with an older epoch is stale.
+	 */
+	class RoundEpoch
+	{
+	public:
+		/**
+		 * \brief Starts a new epoch.
+		 * \return The new epoch.
+		 */
+		Poco::UInt64 next();
+
+		/**
+		 * \brief Returns the current epoch.
+		 * \return The current epoch.
+		 */
+		Poco::UInt64 get() const;
+
+		/**
+		 * \brief Checks, if the epoch is the current one.
+		 * \param epoch The epoch to check.
+		 * \return true, if the epoch is the current one, false otherwise.
+		 */
+		bool isCurrent(Poco::UInt64 epoch) const;
+
+		/**
+		 * \brief Notifies, that stale work of an older epoch was abandoned.
+		 * The time since the start of the current epoch is the abort latency.
+		 */
+		void abandon();
+
+		/**
+		 * \brief Returns the time between the start of the current epoch and the last abandoned stale work.
+		 * \return The abort latency in microseconds.
+		 */
+		Poco::UInt64 getAbortLatency() const;
+
+		/**
+		 * \brief Returns the time since the start of the current epoch.
+		 * \return The elapsed time in microseconds.
+		 */
+		Poco::UInt64 getElapsed() const;
+
+		/**
+		 * \brief Checks, if the time budget of the round is exceeded.
+		 * \return true, if there is a budget and it is exceeded, false otherwise.
+		 */
+		bool isBudgetExceeded() const;
+
+		/**
+		 * \brief Sets the time budget of the current epoch.
+		 * \param seconds The budget in seconds, 0 if unlimited.
+		 */
+		void setBudget(Poco::UInt64 seconds);
+
+		/**
+		 * \brief Returns the time budget of the current epoch.
+		 * \return The budget in seconds, 0 if unlimited.
+		 */
+		Poco::UInt64 getBudget() const;
+
+		/**
+		 * \brief Adds plot bytes, that were skipped in the current epoch, because the round budget was exceeded,
+		 * the device was quarantined or the bytes could not be read.
+		 * \param bytes The skipped bytes.
+		 */
+		void addSkipped(Poco::UInt64 bytes);
+
+		/**
+		 * \brief Returns the plot bytes, that were skipped in the current epoch.
+		 * \return The skipped bytes.
+		 */
+		Poco::UInt64 getSkipped() const;
+
+		/**
+		 * \brief Notifies, that plot data of an epoch was read.
+		 * The time between the start of the epoch and the first read is the first read latency.
+		 * \param epoch The epoch of the read.
+		 */
+		void firstRead(Poco::UInt64 epoch);
+
+		/**
+		 * \brief Returns the time between the start of the current epoch and the first read plot data.
+		 * \return The first read latency in microseconds, 0 if nothing was read yet.
+		 */
+		Poco::UInt64 getFirstReadLatency() const;
+
+	private:
+		std::atomic<Poco::UInt64> epoch_{0};
+		std::atomic<Poco::Int64> started_{0};
+		std::atomic<Poco::UInt64> abortLatency_{0};
+		std::atomic<Poco::UInt64> skipped_{0};
+		std::atomic<Poco::UInt64> firstReadLatency_{0};
+		std::atomic<Poco::UInt64> budget_{0};
+	};
+
 	struct PlotReadNotification : Poco::Notification
 	{
 		typedef Poco::AutoPtr<PlotReadNotification> Ptr;
@@ -71,23 +173,68 @@ namespace Burst
 		std::vector<std::pair<std::string, std::vector<std::shared_ptr<PlotFile>>>> relatedPlotLists;
 		PlotDir::Type type = PlotDir::Type::Sequential;
 		bool wakeUpCall = false;
+		Poco::UInt64 deviceId = 0;
+		Poco::UInt64 epoch = 0;
+		Poco::Timestamp enqueued;
 	};
 
 	class PlotReader : public Poco::Task
 	{
 	public:
-		PlotReader(MinerData& data, std::shared_ptr<PlotReadProgress> progress,
-			Poco::NotificationQueue& verificationQueue, Poco::NotificationQueue& plotReadQueue);
+		PlotReader(MinerData& data, std::shared_ptr<PlotReadProgress> progress, std::shared_ptr<PlotReadProgress> progressVerify,
+			Poco::NotificationQueue& verificationQueue, Poco::NotificationQueue& gpuVerificationQueue,
+			Poco::NotificationQueue& plotReadQueue);
 		~PlotReader() override = default;
 
 		void runTask() override;
 
 		static GlobalBufferSize globalBufferSize;
+		static RoundEpoch roundEpoch;
 
 	private:
+		/**
+		 * \brief A single read of scoops inside a plot file.
+		 */
+		struct ReadRequest
+		{
+			size_t fileIndex;
+			Poco::UInt64 startNonce;
+			Poco::UInt64 nonces;
+			Poco::UInt64 offset;
+			Poco::UInt64 physicalOffset;
+			Poco::UInt64 stripe;
+		};
+
+		/**
+		 * \brief Splits all plot files of a notification into reads, that fit into the buffer.
+		 * If the physical positions of all reads are known, the reads are sorted by them.
+		 * When reading progressively, the reads are first ordered by stripes across all plot files.
+		 * \param notification The plot read notification.
+		 * \return The list of reads in the order they should be processed.
+		 */
+		static std::vector<ReadRequest> createReadPlan(const PlotReadNotification& notification);
+
+		bool readChunk(const PlotReadNotification& notification, const PlotFile& plotFile, PlotStream& inputStream,
+			std::istream* sidecar, const ReadRequest& readRequest, bool poc2, ScoopBuffer& bufferMirror);
+
+		/**
+		 * \brief Reads a block of data in slices and stops, as soon as the round is over or a slice fails.
+		 * The latency of every slice is added to the health of the plot file and its device.
+		 * \param notification The plot read notification of the round, the data belongs to.
+		 * \param plotFile The plot file.
+		 * \param inputStream The stream of the plot file.
+		 * \param offset The position inside the plot file.
+		 * \param buffer The buffer, that receives the data.
+		 * \param size The size of the data in bytes.
+		 * \return true, if all data was read, false if the round is over or the data could not be read.
+		 */
+		bool readSliced(const PlotReadNotification& notification, const PlotFile& plotFile, PlotStream& inputStream,
+			Poco::UInt64 offset, char* buffer, Poco::UInt64 size) const;
+
 		MinerData& data_;
-		std::shared_ptr<PlotReadProgress> progress_;
+		std::shared_ptr<PlotReadProgress> progress_, progressVerify_;
 		Poco::NotificationQueue* verificationQueue_;
+		Poco::NotificationQueue* gpuVerificationQueue_;
 		Poco::NotificationQueue* plotReadQueue_;
 	};
 
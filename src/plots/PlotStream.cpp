@@ -0,0 +1,160 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#include "PlotStream.hpp"
+#include "PlotGenerator.hpp"
+#include <thread>
+#include <cstring>
+
+std::unique_ptr<Burst::PlotStream> Burst::PlotStream::open(const PlotFile& plotFile)
+{
+	if (plotFile.isVirtual())
+		return std::unique_ptr<PlotStream>{new VirtualPlotStream{plotFile}};
+
+	return std::unique_ptr<PlotStream>{new PlotFileStream{plotFile.getPath()}};
+}
+
+Burst::PlotFileStream::PlotFileStream(const std::string& path)
+	: stream_{path, std::ifstream::in | std::ifstream::binary}
+{
+}
+
+bool Burst::PlotFileStream::isOpen() const
+{
+	return stream_.is_open();
+}
+
+void Burst::PlotFileStream::seek(const Poco::UInt64 offset)
+{
+	// a failed read must not break the following ones
+	stream_.clear();
+	stream_.seekg(offset);
+}
+
+void Burst::PlotFileStream::read(char* buffer, const Poco::UInt64 size)
+{
+	stream_.read(buffer, size);
+}
+
+bool Burst::PlotFileStream::isGood() const
+{
+	return stream_.good();
+}
+
+Burst::VirtualPlotStream::VirtualPlotStream(const PlotFile& plotFile)
+	: plotFile_{plotFile}, busyUntil_{std::chrono::steady_clock::now()}
+{
+}
+
+bool Burst::VirtualPlotStream::isOpen() const
+{
+	return plotFile_.isVirtual();
+}
+
+void Burst::VirtualPlotStream::seek(const Poco::UInt64 offset)
+{
+	// a seek only costs time, if the position really changes
+	if (!sought_ || offset != position_)
+	{
+		const auto seekLatency = plotFile_.getVirtualSettings()->seekLatency;
+		wait(std::chrono::microseconds(static_cast<Poco::Int64>(seekLatency * 1000)));
+	}
+
+	position_ = offset;
+	sought_ = true;
+}
+
+void Burst::VirtualPlotStream::read(char* buffer, const Poco::UInt64 size)
+{
+	ScoopData scoopData;
+	auto written = 0ull;
+
+	while (written < size)
+	{
+		// find the nonce and the scoop of the current position
+		const auto stagger = position_ / plotFile_.getStaggerBytes();
+		const auto staggerOffset = position_ % plotFile_.getStaggerBytes();
+		const auto scoop = staggerOffset / plotFile_.getStaggerScoopBytes();
+		const auto scoopOffset = staggerOffset % plotFile_.getStaggerScoopBytes();
+		const auto nonce = stagger * plotFile_.getStaggerSize() + scoopOffset / Settings::ScoopSize;
+		const auto byteInScoop = scoopOffset % Settings::ScoopSize;
+		const auto bytes = std::min<Poco::UInt64>(Settings::ScoopSize - byteInScoop, size - written);
+
+		createScoop(plotFile_.getNonceStart() + nonce, scoop, scoopData);
+		memcpy(buffer + written, scoopData.data() + byteInScoop, bytes);
+
+		written += bytes;
+		position_ += bytes;
+	}
+
+	const auto throughput = plotFile_.getVirtualSettings()->throughput;
+
+	if (throughput > 0.)
+		wait(std::chrono::microseconds(static_cast<Poco::Int64>(size / (throughput * 1024 * 1024) * 1000 * 1000)));
+}
+
+bool Burst::VirtualPlotStream::isGood() const
+{
+	return true;
+}
+
+void Burst::VirtualPlotStream::createPseudoScoop(const Poco::UInt64 account, const Poco::UInt64 nonce, const Poco::UInt64 scoop,
+	ScoopData& scoopData)
+{
+	// splitmix64, seeded by the position of the scoop
+	auto state = account ^ (nonce * 0x9E3779B97F4A7C15ull) ^ (scoop << 48);
+
+	for (auto i = 0u; i < Settings::ScoopSize; i += sizeof(Poco::UInt64))
+	{
+		auto value = (state += 0x9E3779B97F4A7C15ull);
+		value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+		value = value ^ (value >> 31);
+		memcpy(scoopData.data() + i, &value, sizeof value);
+	}
+}
+
+void Burst::VirtualPlotStream::createScoop(const Poco::UInt64 nonce, const Poco::UInt64 scoop, ScoopData& scoopData) const
+{
+	const auto account = plotFile_.getAccountId();
+
+	if (!plotFile_.getVirtualSettings()->realNonces)
+	{
+		createPseudoScoop(account, nonce, scoop, scoopData);
+		return;
+	}
+
+	// the virtual plotfiles are PoC2, so the second hash is taken from the mirrored scoop
+	const auto gendata = PlotGenerator::generateSse2(account, nonce);
+	const auto scoopMirror = Settings::ScoopPerPlot - 1 - scoop;
+	memcpy(scoopData.data(), gendata.data() + scoop * Settings::ScoopSize, Settings::HashSize);
+	memcpy(scoopData.data() + Settings::HashSize, gendata.data() + scoopMirror * Settings::ScoopSize + Settings::HashSize,
+		Settings::HashSize);
+}
+
+void Burst::VirtualPlotStream::wait(const std::chrono::microseconds duration)
+{
+	// the device is busy for the given time, after the previous operation is done
+	const auto now = std::chrono::steady_clock::now();
+	busyUntil_ = std::max(busyUntil_, now) + duration;
+	std::this_thread::sleep_until(busyUntil_);
+}
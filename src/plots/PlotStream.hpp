@@ -0,0 +1,124 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#pragma once
+
+#include <Poco/Types.h>
+#include <memory>
+#include <fstream>
+#include <chrono>
+#include "Plot.hpp"
+#include "Declarations.hpp"
+
+namespace Burst
+{
+	/**
+	 * \brief A readable source of the scoops of a plotfile.
+	 */
+	class PlotStream
+	{
+	public:
+		virtual ~PlotStream() = default;
+
+		/**
+		 * \brief Returns, if the stream can be read.
+		 * \return true, if the stream is open, false otherwise.
+		 */
+		virtual bool isOpen() const = 0;
+
+		/**
+		 * \brief Sets the position of the next read.
+		 * \param offset The position inside the plotfile in bytes.
+		 */
+		virtual void seek(Poco::UInt64 offset) = 0;
+
+		/**
+		 * \brief Reads data from the current position.
+		 * \param buffer The buffer, that receives the data.
+		 * \param size The size of the data in bytes.
+		 */
+		virtual void read(char* buffer, Poco::UInt64 size) = 0;
+
+		/**
+		 * \brief Returns, if the last read succeeded.
+		 * \return true, if all data was read, false on a read error.
+		 */
+		virtual bool isGood() const = 0;
+
+		/**
+		 * \brief Opens a stream for a plotfile.
+		 * \param plotFile The plotfile.
+		 * \return A stream for the physical or virtual plotfile.
+		 */
+		static std::unique_ptr<PlotStream> open(const PlotFile& plotFile);
+	};
+
+	/**
+	 * \brief A stream, that reads a plotfile from the disk.
+	 */
+	class PlotFileStream : public PlotStream
+	{
+	public:
+		explicit PlotFileStream(const std::string& path);
+
+		bool isOpen() const override;
+		void seek(Poco::UInt64 offset) override;
+		void read(char* buffer, Poco::UInt64 size) override;
+		bool isGood() const override;
+
+	private:
+		std::ifstream stream_;
+	};
+
+	/**
+	 * \brief A stream, that generates the scoops of a virtual plotfile.
+	 * The latency and the throughput of a real device are emulated.
+	 */
+	class VirtualPlotStream : public PlotStream
+	{
+	public:
+		explicit VirtualPlotStream(const PlotFile& plotFile);
+
+		bool isOpen() const override;
+		void seek(Poco::UInt64 offset) override;
+		void read(char* buffer, Poco::UInt64 size) override;
+		bool isGood() const override;
+
+		/**
+		 * \brief Creates the deterministic pseudo data of a scoop.
+		 * \param account The account id.
+		 * \param nonce The nonce.
+		 * \param scoop The scoop number.
+		 * \param scoopData The scoop, that receives the data.
+		 */
+		static void createPseudoScoop(Poco::UInt64 account, Poco::UInt64 nonce, Poco::UInt64 scoop, ScoopData& scoopData);
+
+	private:
+		void createScoop(Poco::UInt64 nonce, Poco::UInt64 scoop, ScoopData& scoopData) const;
+		void wait(std::chrono::microseconds duration);
+
+		const PlotFile& plotFile_;
+		Poco::UInt64 position_ = 0;
+		bool sought_ = false;
+		std::chrono::steady_clock::time_point busyUntil_;
+	};
+}
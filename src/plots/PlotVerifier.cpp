@@ -20,3 +20,25 @@
 // ==========================================================================
 
 #include "PlotVerifier.hpp"
+#include "MinerUtil.hpp"
+#include "mining/MinerConfig.hpp"
+#include <atomic>
+
+Burst::VerifyNotification::~VerifyNotification()
+{
+	PlotReader::globalBufferSize.free(memorySize);
+}
+
+void Burst::pinVerifierThread()
+{
+	static std::atomic<size_t> nextCpu{0};
+	const auto& cpus = MinerConfig::getConfig().getVerifierCpus();
+
+	if (cpus.empty())
+		return;
+
+	const auto cpu = cpus[nextCpu++ % cpus.size()];
+
+	if (!setThreadAffinity({cpu}))
+		log_debug(MinerLogger::plotVerifier, "Could not pin the verifier to cpu %u", cpu);
+}
@@ -24,6 +24,7 @@
 #include <Poco/Task.h>
 #include <vector>
 #include "Declarations.hpp"
+#include "HugePages.hpp"
 #include <Poco/AutoPtr.h>
 #include <Poco/Notification.h>
 #include <Poco/NotificationQueue.h>
@@ -33,8 +34,13 @@
 #include "logging/Message.hpp"
 #include "logging/MinerLogger.hpp"
 #include "PlotReader.hpp"
+#include "CpuBudget.hpp"
+#include "VerifierBalance.hpp"
+#include "mining/Benchmark.hpp"
+#include "mining/TopDeadlines.hpp"
 #include "gpu/gpu_shell.hpp"
 #include "gpu/algorithm/gpu_algorithm_atomic.hpp"
+#include "gpu/algorithm/gpu_algorithm_buffered.hpp"
 
 namespace Burst
 {
@@ -44,7 +50,13 @@ namespace Burst
 	{
 		typedef Poco::AutoPtr<VerifyNotification> Ptr;
 
-		std::vector<ScoopData> buffer;
+		/**
+		 * \brief Destructor.
+		 * Gives the reserved buffer memory back, no matter if the notification was processed or dropped.
+		 */
+		~VerifyNotification() override;
+
+		ScoopBuffer buffer;
 		Poco::UInt64 accountId = 0;
 		Poco::UInt64 nonceRead = 0;
 		Poco::UInt64 nonceStart = 0;
@@ -53,8 +65,16 @@ namespace Burst
 		GensigData gensig;
 		Poco::UInt64 baseTarget = 0;
 		Poco::UInt64 memorySize = 0;
+		Poco::UInt64 epoch = 0;
+		Poco::Timestamp enqueued;
+		VerifierBackend backend = VerifierBackend::Cpu;
 	};
 	
+	/**
+	 * \brief Pins the calling verifier thread to the next of the configured verifier cpus.
+	 */
+	void pinVerifierThread();
+
 	using DeadlineTuple = std::pair<Poco::UInt64, Poco::UInt64>;
 	using SubmitFunction = std::function<void(Poco::UInt64, Poco::UInt64, Poco::UInt64, Poco::UInt64, std::string, bool)>;
 
@@ -90,6 +110,9 @@ namespace Burst
 	void PlotVerifier<TVerificationAlgorithm>::runTask()
 	{
 		void* stream = nullptr;
+		CpuBudget::Pacer pacer;
+
+		pinVerifierThread();
 		
 		if (!TVerificationAlgorithm::initStream(&stream))
 		{
@@ -110,17 +133,62 @@ namespace Burst
 				else
 					break;
 
-				const auto stopFunction = [this, &verifyNotification]()
+				const auto epoch = verifyNotification->epoch;
+
+				if (RoundStats::isActive())
+					RoundStats::add(RoundStats::Stage::VerifyQueue, verifyNotification->enqueued.elapsed());
+
+				// stale work of an older round, throw it away
+				if (!PlotReader::roundEpoch.isCurrent(epoch))
 				{
-					return isCancelled() || verifyNotification->block != data_->getCurrentBlockheight();
+					PlotReader::roundEpoch.abandon();
+
+					if (VerifierBalance::isActive())
+						VerifierBalance::drop(verifyNotification->backend, verifyNotification->buffer.size());
+
+					continue;
+				}
+
+				const std::function<bool()> isStale = [this, epoch]()
+				{
+					return isCancelled() || !PlotReader::roundEpoch.isCurrent(epoch);
 				};
 
+				// the verification is paced here, if there is a cpu budget
+				const auto stopFunction = [&pacer, &isStale]()
+				{
+					pacer.pace(isStale);
+					return isStale();
+				};
+
+				// the k best deadlines of the round, if they are collected
+				std::shared_ptr<TopDeadlines::Account> topDeadlines;
+				const auto block = data_->getBlockData();
+
+				if (block != nullptr && block->getBlockheight() == verifyNotification->block && block->getTopDeadlines() != nullptr)
+					topDeadlines = block->getTopDeadlines()->getAccount(verifyNotification->accountId);
+
 				START_PROBE("PlotVerifier.SearchDeadline");
+				const Poco::Timestamp verifyStart;
+				const auto balanced = VerifierBalance::isActive();
+
+				if (balanced)
+					VerifierBalance::begin(verifyNotification->backend);
+
+				pacer.begin();
 				auto bestResult = TVerificationAlgorithm::run(verifyNotification->buffer, verifyNotification->nonceRead,
 					verifyNotification->nonceStart, verifyNotification->baseTarget, verifyNotification->gensig,
-					stopFunction, stream);
+					stopFunction, stream, topDeadlines.get(), verifyNotification->inputPath);
+				pacer.end();
+
+				if (balanced)
+					VerifierBalance::end(verifyNotification->backend, verifyNotification->buffer.size());
 				TAKE_PROBE("PlotVerifier.SearchDeadline");
 
+				if (RoundStats::isActive())
+					RoundStats::add(RoundStats::Stage::Verify, verifyStart.elapsed(),
+						static_cast<Poco::UInt64>(verifyNotification->buffer.size()) * Settings::ScoopSize);
+
 				if (bestResult.first != 0 && bestResult.second != 0)
 				{
 					START_PROBE("PlotVerifier.Submit");
@@ -133,9 +201,12 @@ namespace Burst
 					TAKE_PROBE("PlotVerifier.Submit");
 				}
 
-				START_PROBE("PlotVerifier.FreeMemory");
-				PlotReader::globalBufferSize.free(verifyNotification->memorySize);
-				TAKE_PROBE("PlotVerifier.FreeMemory");
+				if (!PlotReader::roundEpoch.isCurrent(epoch))
+					PlotReader::roundEpoch.abandon();
+				else if (!isCancelled())
+					data_->getCheckpoint().addVerified(verifyNotification->block, verifyNotification->inputPath,
+						verifyNotification->nonceRead, verifyNotification->buffer.size(), verifyNotification->accountId,
+						bestResult.first, bestResult.second);
 
 				if (progress_ != nullptr)
 					progress_->add(static_cast<Poco::UInt64>(verifyNotification->buffer.size()) * Settings::PlotSize,
@@ -157,6 +228,7 @@ namespace Burst
 			}
 		}
 
+		TVerificationAlgorithm::releaseStream(stream);
 		log_debug(MinerLogger::plotVerifier, "Verifier stopped");
 	}
 
@@ -218,9 +290,15 @@ namespace Burst
 			return true;
 		}
 
-		static DeadlineTuple run(std::vector<ScoopData>& buffer, Poco::UInt64 nonceRead,
+		static bool releaseStream(void* stream)
+		{
+			return true;
+		}
+
+		static DeadlineTuple run(ScoopBuffer& buffer, Poco::UInt64 nonceRead,
 						Poco::UInt64 nonceStart, Poco::UInt64 baseTarget, const GensigData& gensig,
-						std::function<bool()> stop, void* stream)
+						std::function<bool()> stop, void* stream,
+						TopDeadlines::Account* topDeadlines = nullptr, const std::string& plotFile = "")
 		{
 			DeadlineTuple bestResult = {0, 0};
 			TShabal shabal;
@@ -237,15 +315,20 @@ namespace Burst
 				for (auto& pair : result)
 					// make sure the nonce->deadline pair is valid...
 					if (pair.first > 0 && pair.second > 0)
+					{
 						// ..and better than the others
 						if (bestResult.second == 0 || pair.second < bestResult.second)
 							bestResult = pair;
+
+						if (topDeadlines != nullptr && topDeadlines->isCandidate(pair.second))
+							topDeadlines->add(pair.first, pair.second, plotFile);
+					}
 			}
 
 			return bestResult;
 		}
 
-		static std::vector<DeadlineTuple> verify(const TShabal& shabalCopy, std::vector<ScoopData>& buffer, Poco::UInt64 nonceRead,
+		static std::vector<DeadlineTuple> verify(const TShabal& shabalCopy, ScoopBuffer& buffer, Poco::UInt64 nonceRead,
 										  Poco::UInt64 nonceStart, size_t offset, Poco::UInt64 baseTarget)
 		{
 			constexpr auto HashSize = TShabal::HashSize;
@@ -300,9 +383,15 @@ namespace Burst
 			return TGpu::initStream(stream);
 		}
 
-		static DeadlineTuple run(std::vector<ScoopData>& buffer, Poco::UInt64 nonceRead,
+		static bool releaseStream(void* stream)
+		{
+			return TGpu::releaseStream(stream);
+		}
+
+		static DeadlineTuple run(ScoopBuffer& buffer, Poco::UInt64 nonceRead,
 			Poco::UInt64 nonceStart, Poco::UInt64 baseTarget, const GensigData& gensig,
-			std::function<bool()> stop, void* stream)
+			std::function<bool()> stop, void* stream,
+			TopDeadlines::Account* topDeadlines = nullptr, const std::string& plotFile = "")
 		{
 			DeadlineTuple bestDeadline{0, 0};
 			TGpu::template run<TAlgorithm>(
@@ -312,6 +401,11 @@ namespace Burst
 				baseTarget,
 				stream,
 				bestDeadline);
+
+			// the gpu only reduces to the best deadline of the chunk
+			if (topDeadlines != nullptr && bestDeadline.second != 0 && topDeadlines->isCandidate(bestDeadline.second))
+				topDeadlines->add(bestDeadline.first, bestDeadline.second, plotFile);
+
 			return bestDeadline;
 		}
 	};
@@ -332,7 +426,7 @@ namespace Burst
 	using PlotVerifier_avx2 = PlotVerifier<PlotVerifierAlgorithm_avx2>;
 
 	using PlotVerifierAlgorithm_cuda = PlotVerifierAlgorithm_gpu<GpuCuda, Gpu_Algorithm_Atomic>;
-	using PlotVerifierAlgorithm_opencl = PlotVerifierAlgorithm_gpu<GpuOpenCL, Gpu_Algorithm_Atomic>;
+	using PlotVerifierAlgorithm_opencl = PlotVerifierAlgorithm_gpu<GpuOpenCL, Gpu_Algorithm_Buffered>;
 
 	using PlotVerifier_cuda = PlotVerifier<PlotVerifierAlgorithm_cuda>;
 	using PlotVerifier_opencl = PlotVerifier<PlotVerifierAlgorithm_opencl>;
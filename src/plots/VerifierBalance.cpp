@@ -0,0 +1,147 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#include "VerifierBalance.hpp"
+#include <algorithm>
+
+bool Burst::VerifierBalance::active_ = false;
+Burst::VerifierBalance::Backend Burst::VerifierBalance::cpu_;
+Burst::VerifierBalance::Backend Burst::VerifierBalance::gpu_;
+Poco::FastMutex Burst::VerifierBalance::mutex_;
+
+namespace
+{
+	// the weight of the old measurements, when a new round starts
+	constexpr auto RoundDecay = 0.5;
+}
+
+void Burst::VerifierBalance::setActive(const bool active)
+{
+	Poco::FastMutex::ScopedLock lock{mutex_};
+	active_ = active;
+	cpu_ = {};
+	gpu_ = {};
+}
+
+bool Burst::VerifierBalance::isActive()
+{
+	Poco::FastMutex::ScopedLock lock{mutex_};
+	return active_;
+}
+
+void Burst::VerifierBalance::beginRound()
+{
+	Poco::FastMutex::ScopedLock lock{mutex_};
+
+	for (auto backend : {&cpu_, &gpu_})
+	{
+		backend->pending = 0;
+		backend->busy *= RoundDecay;
+		backend->verified *= RoundDecay;
+	}
+}
+
+Burst::VerifierBackend Burst::VerifierBalance::assign(const Poco::UInt64 nonces)
+{
+	Poco::FastMutex::ScopedLock lock{mutex_};
+
+	auto cpuThroughput = calcThroughput(cpu_);
+	auto gpuThroughput = calcThroughput(gpu_);
+
+	// as long as one side was not measured, both are assumed to be equally fast
+	if (cpuThroughput <= 0. || gpuThroughput <= 0.)
+		cpuThroughput = gpuThroughput = 1.;
+
+	const auto cpuFinish = (cpu_.pending + nonces) / cpuThroughput;
+	const auto gpuFinish = (gpu_.pending + nonces) / gpuThroughput;
+
+	// on a tie the kind with less verified nonces gets the chunk, so an idle kind is measured too
+	const auto backend = gpuFinish < cpuFinish || (gpuFinish == cpuFinish && gpu_.verified <= cpu_.verified) ?
+		VerifierBackend::Gpu : VerifierBackend::Cpu;
+
+	get(backend).pending += nonces;
+	return backend;
+}
+
+void Burst::VerifierBalance::begin(const VerifierBackend backend)
+{
+	Poco::FastMutex::ScopedLock lock{mutex_};
+	auto& data = get(backend);
+
+	if (data.active++ == 0)
+		data.busySince.update();
+}
+
+void Burst::VerifierBalance::end(const VerifierBackend backend, const Poco::UInt64 nonces)
+{
+	Poco::FastMutex::ScopedLock lock{mutex_};
+	auto& data = get(backend);
+
+	data.verified += nonces;
+	data.pending -= std::min(data.pending, nonces);
+
+	if (data.active > 0 && --data.active == 0)
+		data.busy += data.busySince.elapsed() / 1000. / 1000.;
+}
+
+void Burst::VerifierBalance::drop(const VerifierBackend backend, const Poco::UInt64 nonces)
+{
+	Poco::FastMutex::ScopedLock lock{mutex_};
+	auto& data = get(backend);
+	data.pending -= std::min(data.pending, nonces);
+}
+
+double Burst::VerifierBalance::getThroughput(const VerifierBackend backend)
+{
+	Poco::FastMutex::ScopedLock lock{mutex_};
+	return calcThroughput(get(backend));
+}
+
+double Burst::VerifierBalance::getGpuShare()
+{
+	Poco::FastMutex::ScopedLock lock{mutex_};
+	const auto verified = cpu_.verified + gpu_.verified;
+
+	if (verified <= 0.)
+		return 0.;
+
+	return gpu_.verified / verified;
+}
+
+Burst::VerifierBalance::Backend& Burst::VerifierBalance::get(const VerifierBackend backend)
+{
+	return backend == VerifierBackend::Gpu ? gpu_ : cpu_;
+}
+
+double Burst::VerifierBalance::calcThroughput(const Backend& backend)
+{
+	// the time, the verifiers of the kind were busy, including the running chunks
+	auto busy = backend.busy;
+
+	if (backend.active > 0)
+		busy += backend.busySince.elapsed() / 1000. / 1000.;
+
+	if (busy <= 0.)
+		return 0.;
+
+	return backend.verified / busy;
+}
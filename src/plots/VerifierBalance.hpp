@@ -0,0 +1,127 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#pragma once
+
+#include <Poco/Mutex.h>
+#include <Poco/Timestamp.h>
+#include <Poco/Types.h>
+
+namespace Burst
+{
+	/**
+	 * \brief The kind of verifier, a chunk is verified with.
+	 */
+	enum class VerifierBackend
+	{
+		Cpu,
+		Gpu
+	};
+
+	/**
+	 * \brief Splits the chunks between the cpu and the gpu verifiers in hybrid mode.
+	 * The throughput of both kinds of verifiers is measured while they are busy and every chunk
+	 * is given to the kind, that is expected to finish it first. So the work is shared in proportion
+	 * to the throughput and a kind that falls behind gets less until it caught up again.
+	 */
+	class VerifierBalance
+	{
+	public:
+		~VerifierBalance() = delete;
+
+		/**
+		 * \brief Turns the balancing on or off.
+		 * \param active true, if cpu and gpu verifiers are running side by side.
+		 */
+		static void setActive(bool active);
+
+		/**
+		 * \brief Checks, if the balancing is active.
+		 * \return true, if the balancing is active, false otherwise.
+		 */
+		static bool isActive();
+
+		/**
+		 * \brief Starts a new round.
+		 * The queued work of the old round is forgotten and the measured throughput is weighted down,
+		 * so the split follows changes of the load.
+		 */
+		static void beginRound();
+
+		/**
+		 * \brief Chooses the kind of verifier for a chunk.
+		 * \param nonces The number of nonces in the chunk.
+		 * \return The kind of verifier, that is expected to finish the chunk first.
+		 */
+		static VerifierBackend assign(Poco::UInt64 nonces);
+
+		/**
+		 * \brief Notifies, that a verifier started to verify a chunk.
+		 * \param backend The kind of the verifier.
+		 */
+		static void begin(VerifierBackend backend);
+
+		/**
+		 * \brief Notifies, that a verifier finished a chunk.
+		 * \param backend The kind of the verifier.
+		 * \param nonces The number of verified nonces.
+		 */
+		static void end(VerifierBackend backend, Poco::UInt64 nonces);
+
+		/**
+		 * \brief Notifies, that a chunk was thrown away without verifying it.
+		 * \param backend The kind of the verifier, the chunk was assigned to.
+		 * \param nonces The number of nonces in the chunk.
+		 */
+		static void drop(VerifierBackend backend, Poco::UInt64 nonces);
+
+		/**
+		 * \brief Returns the measured throughput of a kind of verifier.
+		 * \param backend The kind of the verifier.
+		 * \return The verified nonces per second or 0, if nothing was measured yet.
+		 */
+		static double getThroughput(VerifierBackend backend);
+
+		/**
+		 * \brief Returns the share of the gpu on the verified nonces.
+		 * \return The share between 0 and 1.
+		 */
+		static double getGpuShare();
+
+	private:
+		struct Backend
+		{
+			Poco::UInt64 pending = 0;
+			unsigned active = 0;
+			Poco::Timestamp busySince;
+			double busy = 0.;
+			double verified = 0.;
+		};
+
+		static Backend& get(VerifierBackend backend);
+		static double calcThroughput(const Backend& backend);
+
+		static bool active_;
+		static Backend cpu_, gpu_;
+		static Poco::FastMutex mutex_;
+	};
+}
@@ -0,0 +1,133 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#include "WakeUpScheduler.hpp"
+#include "MinerUtil.hpp"
+#include "mining/MinerConfig.hpp"
+#include <algorithm>
+
+std::vector<Poco::UInt64> Burst::WakeUpScheduler::blockTimes_;
+std::unordered_map<std::string, double> Burst::WakeUpScheduler::spinUps_;
+std::unordered_map<std::string, Poco::Timestamp> Burst::WakeUpScheduler::wakeUps_;
+std::unordered_map<std::string, Poco::UInt64> Burst::WakeUpScheduler::wakeUpReads_;
+Poco::Mutex Burst::WakeUpScheduler::mutex_;
+
+void Burst::WakeUpScheduler::setBlockTimes(std::vector<Poco::UInt64> blockTimes)
+{
+	std::sort(blockTimes.begin(), blockTimes.end());
+
+	Poco::ScopedLock<Poco::Mutex> lock{mutex_};
+	blockTimes_ = std::move(blockTimes);
+}
+
+double Burst::WakeUpScheduler::getBlockProbability(const double elapsed, const double window)
+{
+	Poco::ScopedLock<Poco::Mutex> lock{mutex_};
+
+	// P(elapsed < T <= elapsed + window | T > elapsed)
+	const auto survived = blockTimes_.end() - std::upper_bound(blockTimes_.begin(), blockTimes_.end(), elapsed);
+
+	if (survived == 0)
+		// the block is later than every known one, so it is overdue
+		return blockTimes_.empty() ? 0. : 1.;
+
+	const auto inWindow = std::upper_bound(blockTimes_.begin(), blockTimes_.end(), elapsed + window) -
+		std::upper_bound(blockTimes_.begin(), blockTimes_.end(), elapsed);
+
+	return static_cast<double>(inWindow) / survived;
+}
+
+void Burst::WakeUpScheduler::addSpinUp(const std::string& dir, const double seconds)
+{
+	// a spinning disk answers fast, only the slow wake ups tell us the spin-up time,
+	// so the estimate only decays slowly when the disk was already awake
+	const auto decay = 0.03;
+
+	Poco::ScopedLock<Poco::Mutex> lock{mutex_};
+
+	const auto iter = spinUps_.find(dir);
+
+	if (iter == spinUps_.end())
+		spinUps_.emplace(dir, seconds);
+	else if (seconds > iter->second)
+		iter->second = seconds;
+	else
+		iter->second = decay * seconds + (1. - decay) * iter->second;
+}
+
+double Burst::WakeUpScheduler::getSpinUp(const std::string& dir)
+{
+	Poco::ScopedLock<Poco::Mutex> lock{mutex_};
+
+	const auto iter = spinUps_.find(dir);
+
+	// typical spin-up time of a 3.5" disk
+	if (iter == spinUps_.end())
+		return 10.;
+
+	return iter->second;
+}
+
+bool Burst::WakeUpScheduler::shouldWakeUp(const std::string& dir, const double elapsed)
+{
+	const auto& config = MinerConfig::getConfig();
+	const auto window = getSpinUp(dir) + config.getWakeUpMargin();
+
+	if (getBlockProbability(elapsed, window) < config.getWakeUpProbability())
+		return false;
+
+	const auto powerState = getDevicePowerState(dir);
+
+	if (powerState == DevicePowerState::Active)
+		return false;
+
+	if (powerState == DevicePowerState::Standby)
+		return true;
+
+	// the power state is unknown, so we wake up the disk from time to time
+	Poco::ScopedLock<Poco::Mutex> lock{mutex_};
+
+	const auto iter = wakeUps_.find(dir);
+	const auto interval = std::max(config.getWakeUpTime(), 1u) * 1000ull * 1000ull;
+
+	return iter == wakeUps_.end() || static_cast<Poco::UInt64>(iter->second.elapsed()) >= interval;
+}
+
+void Burst::WakeUpScheduler::wokeUp(const std::string& dir)
+{
+	Poco::ScopedLock<Poco::Mutex> lock{mutex_};
+	wakeUps_[dir].update();
+}
+
+Poco::UInt64 Burst::WakeUpScheduler::getWakeUpOffset(const std::string& dir, const Poco::UInt64 size)
+{
+	// the reads jump in big odd steps of pages through the file, far away from the last one
+	const Poco::UInt64 pageSize = 4096;
+	const Poco::UInt64 step = 7919;
+	const auto pages = size / pageSize;
+
+	if (pages == 0)
+		return 0;
+
+	Poco::ScopedLock<Poco::Mutex> lock{mutex_};
+	return wakeUpReads_[dir]++ * step % pages * pageSize;
+}
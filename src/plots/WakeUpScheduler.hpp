@@ -0,0 +1,103 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <Poco/Mutex.h>
+#include <Poco/Timestamp.h>
+#include <Poco/Types.h>
+
+namespace Burst
+{
+	/**
+	 * \brief Decides, when the disks of the plot directories are woken up.
+	 * A disk is woken up just before the next block is expected, so that it is spinning
+	 * when the round starts. The expectation comes from the times of the last blocks,
+	 * the lead time from the measured spin-up time of the disk.
+	 */
+	class WakeUpScheduler
+	{
+	public:
+		~WakeUpScheduler() = delete;
+
+		/**
+		 * \brief Sets the times of the last blocks.
+		 * \param blockTimes The block times in seconds.
+		 */
+		static void setBlockTimes(std::vector<Poco::UInt64> blockTimes);
+
+		/**
+		 * \brief Returns the probability, that the next block arrives inside a time window.
+		 * \param elapsed The seconds since the current block arrived.
+		 * \param window The length of the window in seconds.
+		 * \return The probability between 0 and 1, 0 if there are no block times.
+		 */
+		static double getBlockProbability(double elapsed, double window);
+
+		/**
+		 * \brief Adds a measured time for the wake up of a plot directory.
+		 * \param dir The path of the plot directory.
+		 * \param seconds The time it took to read from the disk.
+		 */
+		static void addSpinUp(const std::string& dir, double seconds);
+
+		/**
+		 * \brief Returns the expected spin-up time of a plot directory.
+		 * \param dir The path of the plot directory.
+		 * \return The spin-up time in seconds.
+		 */
+		static double getSpinUp(const std::string& dir);
+
+		/**
+		 * \brief Checks, if a plot directory needs to be woken up now.
+		 * \param dir The path of the plot directory.
+		 * \param elapsed The seconds since the current block arrived.
+		 * \return true, if the directory should be woken up, false otherwise.
+		 */
+		static bool shouldWakeUp(const std::string& dir, double elapsed);
+
+		/**
+		 * \brief Notifies, that a plot directory was woken up.
+		 * \param dir The path of the plot directory.
+		 */
+		static void wokeUp(const std::string& dir);
+
+		/**
+		 * \brief Returns the position of the next wake up read in a plot file.
+		 * Every wake up of a plot directory reads somewhere else, so that the page cache can not answer it.
+		 * \param dir The path of the plot directory.
+		 * \param size The size of the plot file in bytes.
+		 * \return The position in bytes.
+		 */
+		static Poco::UInt64 getWakeUpOffset(const std::string& dir, Poco::UInt64 size);
+
+	private:
+		static std::vector<Poco::UInt64> blockTimes_;
+		static std::unordered_map<std::string, double> spinUps_;
+		static std::unordered_map<std::string, Poco::Timestamp> wakeUps_;
+		static std::unordered_map<std::string, Poco::UInt64> wakeUpReads_;
+		static Poco::Mutex mutex_;
+	};
+}
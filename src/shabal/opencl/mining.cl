@@ -394,13 +394,9 @@ __constant static const sph_u32 C_init_512[] = {
 #define HASH_CAP			4096
 #define GEN_SIZE			(PLOT_SIZE + 16)
 
-__kernel void calculate_deadlines(__global unsigned char* gen_sig, __global unsigned char* plot_data, __global unsigned long* deadlines,
-	unsigned long nonces, unsigned long baseTarget) {
-	int gid = get_global_id(0);
-
-	if (gid >= nonces)
-		return;
-
+// hashes the scoop of one nonce with the generation signature and returns its deadline
+unsigned long calculate_deadline(__global unsigned char* gen_sig, __global unsigned char* plot_data, unsigned long gid,
+	unsigned long baseTarget) {
 	sph_u32 A00 = A_init_256[0], A01 = A_init_256[1], A02 = A_init_256[2], A03 = A_init_256[3], A04 = A_init_256[4], A05 = A_init_256[5], A06 = A_init_256[6], A07 = A_init_256[7],
 		A08 = A_init_256[8], A09 = A_init_256[9], A0A = A_init_256[10], A0B = A_init_256[11];
 	sph_u32 B0 = B_init_256[0], B1 = B_init_256[1], B2 = B_init_256[2], B3 = B_init_256[3], B4 = B_init_256[4], B5 = B_init_256[5], B6 = B_init_256[6], B7 = B_init_256[7],
@@ -460,46 +456,49 @@ __kernel void calculate_deadlines(__global unsigned char* gen_sig, __global unsi
 	out[0] = B8;
 	out[1] = B9;
 
-	deadlines[gid] = *((unsigned long*)out) / baseTarget;
+	return *((unsigned long*)out) / baseTarget;
 }
 
-// changed type of parameter best from unsigned int to unsigned long, so we can also save the deadline without truncating it
-__kernel void reduce_best(__global unsigned long* deadlines, unsigned int length, __local unsigned int* best_pos, __local unsigned long* best_deadline, __global unsigned long* best) {
-	int gid = get_global_id(0);
-	int gsize = get_global_size(0);
 
-	unsigned int bpos = 0;
+// hashes the scoops and reduces them to the best deadline of every work group in one pass,
+// so no deadline array is needed; the results of the work groups are reduced by the host
+__kernel void calculate_best_deadline(__global unsigned char* gen_sig, __global unsigned char* plot_data, unsigned long nonces,
+	unsigned long baseTarget, __local unsigned long* best_pos, __local unsigned long* best_deadline, __global unsigned long* best) {
+	size_t gid = get_global_id(0);
+	size_t gsize = get_global_size(0);
+
+	unsigned long bpos = 0;
 	unsigned long bdeadline = 0xFFFFFFFFFFFFFFFFL;
-	for (int i = gid; i < length; i += gsize) {
-		unsigned long d = deadlines[i];
+	for (unsigned long i = gid; i < nonces; i += gsize) {
+		unsigned long d = calculate_deadline(gen_sig, plot_data, i, baseTarget);
 		if (d < bdeadline) {
 			bpos = i;
 			bdeadline = d;
 		}
 	}
 
-	int lid = get_local_id(0);
-	int lsize = get_local_size(0);
+	unsigned int lid = get_local_id(0);
+	unsigned int lsize = get_local_size(0);
 
 	best_pos[lid] = bpos;
 	best_deadline[lid] = bdeadline;
 	barrier(CLK_LOCAL_MEM_FENCE);
 
-	for (int offset = lsize / 2; offset > 0; offset >>= 1) {
-		if (lid < offset) {
-			if (best_deadline[lid + offset] < best_deadline[lid]) {
-				best_pos[lid] = best_pos[lid + offset];
-				best_deadline[lid] = best_deadline[lid + offset];
+	// the local size does not need to be a power of two
+	for (unsigned int size = lsize; size > 1;) {
+		unsigned int half = (size + 1) / 2;
+		if (lid + half < size) {
+			if (best_deadline[lid + half] < best_deadline[lid]) {
+				best_pos[lid] = best_pos[lid + half];
+				best_deadline[lid] = best_deadline[lid + half];
 			}
 		}
 		barrier(CLK_LOCAL_MEM_FENCE);
+		size = half;
 	}
 
 	if (lid == 0) {
-		// original: best[get_group_id(0)] = best_pos[0];
-		// we save a group of {index=>deadline} instead of only the index
 		best[get_group_id(0) * 2 + 0] = best_pos[0];
-		// the best deadline
 		best[get_group_id(0) * 2 + 1] = best_deadline[0];
 	}
 }
@@ -28,6 +28,10 @@
 #include "nxt/nxt_address.h"
 #include "logging/Message.hpp"
 #include "logging/MinerLogger.hpp"
+#include "AccountCache.hpp"
+#include "mining/MinerConfig.hpp"
+#include <unordered_set>
+#include <Poco/Timestamp.h>
 
 Burst::Account::Account()
 	: Account {0}
@@ -143,6 +147,24 @@ Poco::ActiveResult<std::vector<Burst::Block>> Burst::Account::getOrLoadAccountBl
 	return DataLoader::getInstance().getAccountBlocks(std::make_tuple(std::ref(*this), reset));
 }
 
+void Burst::Account::setName(const std::string& name)
+{
+	Poco::Mutex::ScopedLock lock{ mutex_ };
+	name_ = name;
+}
+
+void Burst::Account::setRewardRecipient(AccountId rewardRecipient)
+{
+	Poco::Mutex::ScopedLock lock{ mutex_ };
+	rewardRecipient_ = rewardRecipient;
+}
+
+void Burst::Account::setBlocks(const std::vector<Block>& blocks)
+{
+	Poco::Mutex::ScopedLock lock{ mutex_ };
+	blocks_ = blocks;
+}
+
 std::string Burst::Account::getAddress() const
 {
 	return NxtAddress(getId()).to_string();
@@ -221,6 +243,24 @@ std::vector<Burst::Block> Burst::Account::DataLoader::runGetAccountBlocks(const
 	});
 }
 
+Burst::Accounts::Accounts() = default;
+
+Burst::Accounts::~Accounts() = default;
+
+void Burst::Accounts::openCache(const std::string& databasePath)
+{
+	Poco::FastMutex::ScopedLock lock{ mutex_ };
+
+	try
+	{
+		cache_ = std::make_unique<AccountCache>(databasePath);
+	}
+	catch (Poco::Exception& e)
+	{
+		log_error(MinerLogger::wallet, "The account cache is disabled!\n\tReason: %s", e.displayText());
+	}
+}
+
 std::shared_ptr<Burst::Account> Burst::Accounts::getAccount(AccountId id, const Wallet& wallet, bool persistent)
 {
 	Poco::FastMutex::ScopedLock lock{ mutex_ };
@@ -230,11 +270,29 @@ std::shared_ptr<Burst::Account> Burst::Accounts::getAccount(AccountId id, const
 	// if the account is not in the cache, we have to fetch him
 	if (iter == accounts_.end())
 	{
-		auto account = std::make_shared<Account>(wallet, id, persistent);
+		// persistent accounts are fetched by refresh(), after the round is processed
+		auto account = std::make_shared<Account>(wallet, id);
 
 		// save the account in the cache if wanted
 		if (persistent)
 		{
+			AccountCache::Entry entry;
+			RefreshState state;
+
+			if (cache_ != nullptr && cache_->load(id, entry))
+			{
+				if (entry.refreshed > 0)
+				{
+					account->setName(entry.name);
+					account->setRewardRecipient(entry.rewardRecipient);
+					state.metadata = entry.refreshed;
+				}
+
+				account->setBlocks(entry.blocks);
+				state.blocks = entry.blocksRefreshed;
+			}
+
+			refreshStates_[id] = state;
 			accounts_.emplace(id, account);
 			log_debug(MinerLogger::general, "Cached accounts: %z", accounts_.size());
 		}
@@ -263,3 +321,127 @@ std::vector<std::shared_ptr<Burst::Account>> Burst::Accounts::getAccounts() cons
 
 	return accounts;
 }
+
+Poco::UInt64 Burst::Accounts::refresh(const Wallet& wallet)
+{
+	// only one refresh at a time, the next one finds the data fresh
+	Poco::FastMutex::ScopedLock refreshLock{ refreshMutex_ };
+
+	Poco::UInt64 wonBlocks = 0;
+
+	if (!wallet.isActive())
+		return 0;
+
+	for (auto& account : getAccounts())
+	{
+		refreshMetadata(*account, wallet);
+		refreshBlocks(*account, wallet);
+		wonBlocks += account->getBlocks().size();
+	}
+
+	return wonBlocks;
+}
+
+void Burst::Accounts::refreshMetadata(Account& account, const Wallet& wallet)
+{
+	const auto id = account.getId();
+	const auto timestamp = static_cast<Poco::UInt64>(Poco::Timestamp{}.epochTime());
+
+	{
+		Poco::FastMutex::ScopedLock lock{ mutex_ };
+
+		if (timestamp - refreshStates_[id].metadata < MinerConfig::getConfig().getAccountMetadataTtl())
+			return;
+	}
+
+	std::string name;
+	AccountId rewardRecipient = 0;
+
+	const auto nameFetched = wallet.getNameOfAccount(id, name);
+	const auto rewardRecipientFetched = wallet.getRewardRecipientOfAccount(id, rewardRecipient);
+
+	// try again on the next refresh
+	if (!nameFetched && !rewardRecipientFetched)
+		return;
+
+	if (nameFetched)
+		account.setName(name);
+	else
+		name = account.getName();
+
+	if (rewardRecipientFetched)
+		account.setRewardRecipient(rewardRecipient);
+	else
+		rewardRecipient = account.getRewardRecipient();
+
+	Poco::FastMutex::ScopedLock lock{ mutex_ };
+	refreshStates_[id].metadata = timestamp;
+
+	if (cache_ != nullptr)
+		cache_->saveMetadata(id, name, rewardRecipient);
+}
+
+void Burst::Accounts::refreshBlocks(Account& account, const Wallet& wallet)
+{
+	// most accounts have less blocks, so a cold cache costs only one request
+	static constexpr Poco::UInt32 PageSize = 100;
+
+	const auto id = account.getId();
+	const auto timestamp = static_cast<Poco::UInt64>(Poco::Timestamp{}.epochTime());
+
+	{
+		Poco::FastMutex::ScopedLock lock{ mutex_ };
+
+		if (timestamp - refreshStates_[id].blocks < MinerConfig::getConfig().getWonBlocksTtl())
+			return;
+	}
+
+	auto blocks = account.getBlocks();
+	const std::unordered_set<Block> knownBlocks(blocks.begin(), blocks.end());
+	std::unordered_set<Block> seenBlocks;
+	std::vector<Block> newBlocks, page;
+	auto complete = false;
+
+	// the wallet returns the newest blocks first, so we page until we reach a block known before this refresh
+	for (Poco::UInt32 firstIndex = 0; !complete; firstIndex += PageSize)
+	{
+		if (!wallet.getAccountBlocks(id, page, firstIndex, firstIndex + PageSize - 1))
+			return;
+
+		auto pageAdded = false;
+
+		for (auto block : page)
+		{
+			if (knownBlocks.find(block) != knownBlocks.end())
+			{
+				complete = true;
+				break;
+			}
+
+			// a block won while paging shifts the pages, so a page can repeat the end of the previous one
+			if (seenBlocks.insert(block).second)
+			{
+				newBlocks.emplace_back(block);
+				pageAdded = true;
+			}
+		}
+
+		// a wallet, that ignores the indices, returns the same blocks on every page
+		complete = complete || !pageAdded || page.size() < PageSize;
+	}
+
+	if (!newBlocks.empty())
+		log_debug(MinerLogger::wallet, "Account %Lu won %z new block(s)", id, newBlocks.size());
+
+	{
+		auto allBlocks = newBlocks;
+		allBlocks.insert(allBlocks.end(), blocks.begin(), blocks.end());
+		account.setBlocks(allBlocks);
+	}
+
+	Poco::FastMutex::ScopedLock lock{ mutex_ };
+	refreshStates_[id].blocks = timestamp;
+
+	if (cache_ != nullptr)
+		cache_->saveBlocks(id, newBlocks);
+}
@@ -29,10 +29,12 @@
 #include <Poco/JSON/Object.h>
 #include <vector>
 #include <Poco/ActiveDispatcher.h>
+#include <memory>
 
 namespace Burst
 {
 	class Wallet;
+	class AccountCache;
 
 	using Block = Poco::UInt64;
 
@@ -55,6 +57,10 @@ namespace Burst
 		Poco::ActiveResult<AccountId> getOrLoadRewardRecipient(bool reset = false);
 		Poco::ActiveResult<std::vector<Block>> getOrLoadAccountBlocks(bool reset = false);
 
+		void setName(const std::string& name);
+		void setRewardRecipient(AccountId rewardRecipient);
+		void setBlocks(const std::vector<Block>& blocks);
+
 		Poco::JSON::Object::Ptr toJSON() const;
 		
 	private:
@@ -90,12 +96,42 @@ namespace Burst
 	class Accounts
 	{
 	public:
+		Accounts();
+		~Accounts();
+
+		/**
+		 * \brief Opens the persistent cache for the metadata of the accounts.
+		 * Accounts that are already cached are not fetched from the wallet again.
+		 * \param databasePath The path to the SQLite database.
+		 */
+		void openCache(const std::string& databasePath);
+
 		std::shared_ptr<Account> getAccount(AccountId id, const Wallet& wallet, bool persistent);
 		bool isLoaded(AccountId id) const;
 		std::vector<std::shared_ptr<Account>> getAccounts() const;
 
+		/**
+		 * \brief Refreshes the expired metadata and won blocks of all persistent accounts.
+		 * Only the won blocks that are newer than the known ones are fetched.
+		 * \param wallet The wallet to fetch the data from.
+		 * \return The sum of the won blocks of all accounts.
+		 */
+		Poco::UInt64 refresh(const Wallet& wallet);
+
 	private:
+		struct RefreshState
+		{
+			Poco::UInt64 metadata = 0;
+			Poco::UInt64 blocks = 0;
+		};
+
+		void refreshMetadata(Account& account, const Wallet& wallet);
+		void refreshBlocks(Account& account, const Wallet& wallet);
+
 		std::unordered_map<AccountId, std::shared_ptr<Account>> accounts_;
+		std::unordered_map<AccountId, RefreshState> refreshStates_;
+		std::unique_ptr<AccountCache> cache_;
 		mutable Poco::FastMutex mutex_;
+		Poco::FastMutex refreshMutex_;
 	};
 }
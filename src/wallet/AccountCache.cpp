@@ -0,0 +1,141 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#include "AccountCache.hpp"
+#include "logging/MinerLogger.hpp"
+#include <Poco/Data/Session.h>
+#include <Poco/Format.h>
+#include <Poco/Timestamp.h>
+
+using namespace Poco::Data::Keywords;
+
+Burst::AccountCache::AccountCache(const std::string& databasePath)
+{
+	try
+	{
+		session_ = std::make_unique<Poco::Data::Session>("SQLite", databasePath);
+
+		*session_ <<
+			"CREATE TABLE IF NOT EXISTS account (" <<
+			"	id				INTEGER NOT NULL," <<
+			"	name			TEXT NOT NULL," <<
+			"	rewardRecipient	INTEGER NOT NULL," <<
+			"	refreshed		INTEGER NOT NULL," <<
+			"	blocksRefreshed	INTEGER NOT NULL," <<
+			"	PRIMARY KEY (id)" <<
+			")", now;
+
+		*session_ <<
+			"CREATE TABLE IF NOT EXISTS account_block (" <<
+			"	account			INTEGER NOT NULL," <<
+			"	block			INTEGER NOT NULL," <<
+			"	PRIMARY KEY (account, block)" <<
+			")", now;
+	}
+	catch (Poco::Exception& e)
+	{
+		throw Poco::Exception{Poco::format("Could not load/create the account cache '%s'\n\tReason: %s", databasePath, e.displayText())};
+	}
+}
+
+Burst::AccountCache::~AccountCache() = default;
+
+bool Burst::AccountCache::load(const AccountId id, Entry& entry)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+
+	try
+	{
+		std::vector<std::string> names;
+		std::vector<AccountId> rewardRecipients;
+		std::vector<Poco::UInt64> refreshed, blocksRefreshed;
+
+		*session_ << "SELECT name, rewardRecipient, refreshed, blocksRefreshed FROM account WHERE id = :id",
+			into(names), into(rewardRecipients), into(refreshed), into(blocksRefreshed), bind(id), now;
+
+		if (names.empty())
+			return false;
+
+		entry.name = names.front();
+		entry.rewardRecipient = rewardRecipients.front();
+		entry.refreshed = refreshed.front();
+		entry.blocksRefreshed = blocksRefreshed.front();
+		entry.blocks.clear();
+
+		// the blocks are inserted oldest first
+		*session_ << "SELECT block FROM account_block WHERE account = :id ORDER BY rowid DESC",
+			into(entry.blocks), bind(id), now;
+
+		return true;
+	}
+	catch (Poco::Exception& e)
+	{
+		log_error(MinerLogger::wallet, "Could not load account %Lu from the cache\n\tReason: %s", id, e.displayText());
+		return false;
+	}
+}
+
+void Burst::AccountCache::saveMetadata(const AccountId id, const std::string& name, const AccountId rewardRecipient)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+
+	try
+	{
+		const auto refreshed = static_cast<Poco::UInt64>(Poco::Timestamp{}.epochTime());
+
+		*session_ << "INSERT OR IGNORE INTO account VALUES (:id, '', 0, 0, 0)", bind(id), now;
+		*session_ << "UPDATE account SET name = :name, rewardRecipient = :recipient, refreshed = :refreshed WHERE id = :id",
+			bind(name), bind(rewardRecipient), bind(refreshed), bind(id), now;
+	}
+	catch (Poco::Exception& e)
+	{
+		log_error(MinerLogger::wallet, "Could not save account %Lu in the cache\n\tReason: %s", id, e.displayText());
+	}
+}
+
+void Burst::AccountCache::saveBlocks(const AccountId id, const std::vector<Block>& newBlocks)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+
+	try
+	{
+		const auto refreshed = static_cast<Poco::UInt64>(Poco::Timestamp{}.epochTime());
+
+		session_->begin();
+
+		*session_ << "INSERT OR IGNORE INTO account VALUES (:id, '', 0, 0, 0)", bind(id), now;
+
+		for (auto block = newBlocks.rbegin(); block != newBlocks.rend(); ++block)
+			*session_ << "INSERT OR IGNORE INTO account_block VALUES (:account, :block)", bind(id), bind(*block), now;
+
+		*session_ << "UPDATE account SET blocksRefreshed = :refreshed WHERE id = :id", bind(refreshed), bind(id), now;
+
+		session_->commit();
+	}
+	catch (Poco::Exception& e)
+	{
+		if (session_->isTransaction())
+			session_->rollback();
+
+		log_error(MinerLogger::wallet, "Could not save the blocks of account %Lu in the cache\n\tReason: %s", id, e.displayText());
+	}
+}
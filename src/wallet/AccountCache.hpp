@@ -0,0 +1,91 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Declarations.hpp"
+
+namespace Poco
+{
+	namespace Data
+	{
+		class Session;
+	}
+}
+
+namespace Burst
+{
+	using Block = Poco::UInt64;
+
+	/**
+	 * \brief Persists the metadata of accounts, so that it survives restarts and
+	 * does not need to be fetched from the wallet again.
+	 */
+	class AccountCache
+	{
+	public:
+		struct Entry
+		{
+			std::string name;
+			AccountId rewardRecipient = 0;
+			std::vector<Block> blocks;
+			Poco::UInt64 refreshed = 0;
+			Poco::UInt64 blocksRefreshed = 0;
+		};
+
+		/**
+		 * \brief Constructor.
+		 * \param databasePath The path to the SQLite database.
+		 * \throws Poco::Exception If the database could not be opened.
+		 */
+		explicit AccountCache(const std::string& databasePath);
+		~AccountCache();
+
+		/**
+		 * \brief Loads an account.
+		 * \param id The id of the account.
+		 * \param entry The cached data, the won blocks are ordered newest first.
+		 * \return true, if the account is cached, false otherwise.
+		 */
+		bool load(AccountId id, Entry& entry);
+
+		/**
+		 * \brief Saves the name and the reward recipient of an account and stamps them as refreshed.
+		 */
+		void saveMetadata(AccountId id, const std::string& name, AccountId rewardRecipient);
+
+		/**
+		 * \brief Adds won blocks to an account and stamps its blocks as refreshed.
+		 * \param id The id of the account.
+		 * \param newBlocks The new won blocks, ordered newest first.
+		 */
+		void saveBlocks(AccountId id, const std::vector<Block>& newBlocks);
+
+	private:
+		std::unique_ptr<Poco::Data::Session> session_;
+		std::mutex mutex_;
+	};
+}
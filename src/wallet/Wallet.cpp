@@ -35,10 +35,11 @@
 using namespace Poco::Net;
 
 Burst::Wallet::Wallet()
+	: sessionMutex_{std::make_unique<std::mutex>()}
 {}
 
 Burst::Wallet::Wallet(const Url& url)
-	: url_(url)
+	: url_(url), sessionMutex_{std::make_unique<std::mutex>()}
 {
 	poco_ndc(Wallet(const Url& url));
 }
@@ -171,16 +172,34 @@ void Burst::Wallet::getAccount(AccountId id, Account& account) const
 
 bool Burst::Wallet::getAccountBlocks(AccountId id, std::vector<Block>& blocks) const
 {
-	Poco::JSON::Object::Ptr json;
-	blocks.clear();
+	Poco::URI uri;
+	uri.setPath("/burst");
+	uri.addQueryParameter("requestType", "getAccountBlockIds");
+	uri.addQueryParameter("account", std::to_string(id));
 
-	if (!isActive())
-		return false;
+	return getAccountBlocks(uri, blocks);
+}
 
+bool Burst::Wallet::getAccountBlocks(AccountId id, std::vector<Block>& blocks, Poco::UInt32 firstIndex,
+	Poco::UInt32 lastIndex) const
+{
 	Poco::URI uri;
 	uri.setPath("/burst");
 	uri.addQueryParameter("requestType", "getAccountBlockIds");
 	uri.addQueryParameter("account", std::to_string(id));
+	uri.addQueryParameter("firstIndex", std::to_string(firstIndex));
+	uri.addQueryParameter("lastIndex", std::to_string(lastIndex));
+
+	return getAccountBlocks(uri, blocks);
+}
+
+bool Burst::Wallet::getAccountBlocks(const Poco::URI& uri, std::vector<Block>& blocks) const
+{
+	Poco::JSON::Object::Ptr json;
+	blocks.clear();
+
+	if (!isActive())
+		return false;
 
 	if (sendWalletRequest(uri, json))
 	{
@@ -225,16 +244,24 @@ bool Burst::Wallet::sendWalletRequest(const Poco::URI& uri, Poco::JSON::Object::
 		return false;
 
 	HTTPRequest request{ HTTPRequest::HTTP_GET, uri.getPathAndQuery(), HTTPRequest::HTTP_1_1};
-	request.setKeepAlive(false);
-		
-	Request req{ url_.createSession() };
-	auto resp = req.send(request);
+	request.setKeepAlive(true);
+
+	// one request after another, so that the wallet is not flooded
+	std::lock_guard<std::mutex> lock{*sessionMutex_};
 	std::string data;
 
 	for (auto i = 0u; i < MinerConfig::getConfig().getWalletRequestTries(); ++i)
 	{
+		if (session_ == nullptr)
+			session_ = url_.createSession();
+
+		Request req{ std::move(session_) };
+		auto resp = req.send(request);
+
 		if (resp.receive(data))
 		{
+			session_ = resp.transferSession();
+
 			try
 			{
 				Poco::JSON::Parser parser;
@@ -250,6 +277,8 @@ bool Burst::Wallet::sendWalletRequest(const Poco::URI& uri, Poco::JSON::Object::
 			}
 		}
 
+		// a broken connection is not reused
+		session_.reset();
 		std::this_thread::sleep_for(std::chrono::seconds(MinerConfig::getConfig().getWalletRequestRetryWaitTime()));
 	}
 
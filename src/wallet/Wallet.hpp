@@ -22,18 +22,16 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <vector>
 #include <Poco/JSON/Object.h>
+#include <Poco/Net/HTTPClientSession.h>
 #include "Declarations.hpp"
 #include "network/Url.hpp"
 
 namespace Poco
 {
 	class URI;
-
-	namespace Net
-	{
-		class HTTPClientSession;
-	}
 }
 
 namespace Burst
@@ -59,13 +57,27 @@ namespace Burst
 		void getAccount(AccountId id, Account& account) const;
 		bool getAccountBlocks(AccountId id, std::vector<Block>& blocks) const;
 
+		/**
+		 * \brief Fetches a page of the won blocks of an account, newest first.
+		 * \param id The id of the account.
+		 * \param blocks The won blocks on the page.
+		 * \param firstIndex The index of the first block on the page.
+		 * \param lastIndex The index of the last block on the page.
+		 * \return true, if the page could be fetched, false otherwise.
+		 */
+		bool getAccountBlocks(AccountId id, std::vector<Block>& blocks, Poco::UInt32 firstIndex, Poco::UInt32 lastIndex) const;
+
 		bool isActive() const;
 
 		Wallet& operator=(const Wallet& rhs) = delete;
 		Wallet& operator=(Wallet&& rhs) = default;
 
 	private:
+		bool getAccountBlocks(const Poco::URI& uri, std::vector<Block>& blocks) const;
 		bool sendWalletRequest(const Poco::URI& uri, Poco::JSON::Object::Ptr& json) const;
 		Url url_;
+		// the wallet requests share one keep-alive connection
+		mutable std::unique_ptr<Poco::Net::HTTPClientSession> session_;
+		mutable std::unique_ptr<std::mutex> sessionMutex_;
 	};
 }
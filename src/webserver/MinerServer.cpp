@@ -26,6 +26,7 @@
 #include <Poco/Net/HTTPServerRequest.h>
 #include <Poco/Net/HTTPRequestHandler.h>
 #include "RequestHandler.hpp"
+#include "WebsocketCodec.hpp"
 #include <Poco/JSON/Object.h>
 #include <Poco/File.h>
 #include "logging/MinerLogger.hpp"
@@ -38,14 +39,22 @@
 #include <Poco/Delegate.h>
 #include <Poco/Exception.h>
 #include <Poco/Net/SecureServerSocket.h>
+#include <Poco/UUIDGenerator.h>
 
 using namespace Poco;
 using namespace Net;
 
+namespace
+{
+	// the number of state changes, a reconnecting client can catch up with
+	const size_t historySize = 1024;
+}
+
 Burst::MinerServer::MinerServer(Miner& miner)
 	: miner_{&miner},
 	  minerData_(nullptr),
-	  port_{0}
+	  port_{0},
+	  epoch_{Poco::UUIDGenerator::defaultGenerator().createRandom().toString()}
 {
 	auto ip = MinerConfig::getConfig().getServerUrl().getCanonical();
 	auto port = std::to_string(MinerConfig::getConfig().getServerUrl().getPort());
@@ -95,7 +104,6 @@ void Burst::MinerServer::run(uint16_t port)
 	params->setSoftwareVersion(Settings::Project.nameAndVersion);
 
 	threadPool_.addCapacity(MinerConfig::getConfig().getMaxConnectionsActive());
-
 	if (server_ != nullptr)
 		server_->stopAll(true);
 
@@ -135,16 +143,105 @@ void Burst::MinerServer::connectToMinerData(MinerData& minerData)
 void Burst::MinerServer::sendToWebsockets(std::string& data)
 {
 	poco_ndc(MinerServer::sendToWebsockets);
+	WebsocketData websocketData{data, ""};
 	ScopedLock<Mutex> lock{mutex_};
-	newDataEvent(this, data);
+	newDataEvent(this, websocketData);
 }
 
 void Burst::MinerServer::sendToWebsockets(const JSON::Object& json)
 {
+	poco_ndc(MinerServer::sendToWebsockets);
+	JSON::Object sequenced{json};
+	WebsocketData websocketData;
 	std::stringstream sstream;
-	json.stringify(sstream);
-	auto jsonString = sstream.str();
-	sendToWebsockets(jsonString);
+
+	ScopedLock<Mutex> lock{mutex_};
+
+	// every state change gets the next sequence number, so that a client can resume after it
+	websocketData.sequence = ++sequence_;
+	sequenced.set("seq", websocketData.sequence);
+
+	sequenced.stringify(sstream);
+	websocketData.json = sstream.str();
+
+	// the binary form is encoded once for all binary clients
+	WebsocketCodec::encode(sequenced, websocketData.binary);
+
+	history_.emplace_back(websocketData);
+
+	if (history_.size() > historySize)
+		history_.pop_front();
+
+	newDataEvent(this, websocketData);
+}
+
+Poco::UInt64 Burst::MinerServer::getSequence()
+{
+	ScopedLock<Mutex> lock{mutex_};
+	return sequence_;
+}
+
+const std::string& Burst::MinerServer::getEpoch() const
+{
+	return epoch_;
+}
+
+bool Burst::MinerServer::getMissedData(const std::string& epoch, Poco::UInt64 since, std::vector<WebsocketData>& missed)
+{
+	ScopedLock<Mutex> lock{mutex_};
+
+	missed.clear();
+
+	// the sequence numbers of another server instance (e.g. before the miner was restarted) mean nothing here
+	if (epoch != epoch_)
+		return false;
+
+	// the client knows a state, that this server never sent
+	if (since > sequence_)
+		return false;
+
+	// the changes after the given one are already dropped
+	if (since < sequence_ && (history_.empty() || history_.front().sequence > since + 1))
+		return false;
+
+	for (const auto& data : history_)
+		if (data.sequence > since)
+			missed.emplace_back(data);
+
+	return true;
+}
+
+Poco::UInt64 Burst::MinerServer::createSnapshot(std::vector<JSON::Object>& snapshot)
+{
+	snapshot.clear();
+
+	// a change of the config or the plot dirs after this is sent again, which does not harm
+	snapshot.emplace_back(createJsonConfig());
+	snapshot.emplace_back(createJsonPlotDirsRescan());
+
+	auto sequence = getSequence();
+	std::shared_ptr<BlockData> block;
+
+	if (minerData_ != nullptr)
+		block = minerData_->getBlockData();
+
+	if (block != nullptr)
+		block->forEntries([&snapshot](const JSON::Object& json)
+		{
+			// the current config and plot dirs are already in the snapshot
+			const auto type = json.optValue<std::string>("type", "");
+
+			if (type != "config" && type != "plotdirs-rescan")
+				snapshot.emplace_back(json);
+
+			return true;
+		}, [this, &sequence]()
+		{
+			// the lock of the block is still held, so every collected entry has a sequence number up to this one
+			sequence = getSequence();
+		});
+
+	return sequence;
 }
 
 void Burst::MinerServer::onMinerDataChangeEvent(const void* sender, const Poco::JSON::Object& data)
@@ -164,6 +261,25 @@ void Burst::MinerServer::onMinerDataChangeEvent(const void* sender, const Poco::
 		progressRead_ = progressRead;
 		progressVerification_ = progressVerification;
 	}
+	// the same for the progress of the plot dirs
+	else if (data.has("type") &&
+		data.get("type") == "plotdir-progress")
+	{
+		const auto dir = data.get("dir").extract<std::string>();
+		const auto progress = static_cast<int>(data.get("value").extract<float>());
+		ScopedLock<Mutex> lock{mutex_};
+		const auto iter = progressDirs_.find(dir);
+
+		send = iter == progressDirs_.end() || iter->second != progress;
+		progressDirs_[dir] = progress;
+	}
+	// a new round starts the dir progress from the beginning
+	else if (data.has("type") &&
+		data.get("type") == "new block")
+	{
+		ScopedLock<Mutex> lock{mutex_};
+		progressDirs_.clear();
+	}
 
 	if (send)
 		sendToWebsockets(data);
@@ -21,7 +21,10 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 #include <Poco/Net/HTTPRequestHandlerFactory.h>
 #include "RequestHandler.hpp"
 
@@ -47,6 +50,18 @@ namespace Burst
 	struct BlockDataChangedNotification;
 	class MinerData;
 
+	/**
+	 * \brief A message for the websockets.
+	 * The binary form is empty, when the message has none.
+	 * The sequence number is 0, when the message is not part of the state sync.
+	 */
+	struct WebsocketData
+	{
+		std::string json;
+		std::string binary;
+		Poco::UInt64 sequence = 0;
+	};
+
 	class MinerServer
 	{
 	public:
@@ -60,7 +75,39 @@ namespace Burst
 		void sendToWebsockets(std::string& data);
 		void sendToWebsockets(const Poco::JSON::Object& json);
 
-		Poco::BasicEvent<std::string> newDataEvent;
+		/**
+		 * \brief Returns the sequence number of the last sent state change.
+		 * A client, that got a snapshot of the state at this number, only needs the changes after it.
+		 * \return The sequence number, 0 if nothing was sent yet.
+		 */
+		Poco::UInt64 getSequence();
+
+		/**
+		 * \brief Returns the id of this server instance.
+		 * The sequence numbers start again with every instance, so they are only valid together with the epoch.
+		 * \return The epoch.
+		 */
+		const std::string& getEpoch() const;
+
+		/**
+		 * \brief Collects the state changes, a reconnecting client has missed.
+		 * \param epoch The epoch of the server, the client got the changes from.
+		 * \param since The sequence number of the last change the client got.
+		 * \param missed The missed changes in the order they were sent.
+		 * \return true, if all missed changes are still known, false if the client needs a new snapshot.
+		 */
+		bool getMissedData(const std::string& epoch, Poco::UInt64 since, std::vector<WebsocketData>& missed);
+
+		/**
+		 * \brief Creates a snapshot of the current state for a new client.
+		 * The sequence number is read, before a new entry of the block can be added,
+		 * so the client only needs the changes after it.
+		 * \param snapshot The config, the plot dirs and the entries of the current block.
+		 * \return The sequence number of the last change, that is part of the snapshot.
+		 */
+		Poco::UInt64 createSnapshot(std::vector<Poco::JSON::Object>& snapshot);
+
+		Poco::BasicEvent<WebsocketData> newDataEvent;
 
 	private:
 		void onMinerDataChangeEvent(const void* sender, const Poco::JSON::Object& data);
@@ -73,6 +120,10 @@ namespace Burst
 		TemplateVariables variables_;
 		Poco::ThreadPool threadPool_;
 		float progressRead_ = 0.f, progressVerification_ = 0.f;
+		std::unordered_map<std::string, int> progressDirs_;
+		Poco::UInt64 sequence_ = 0;
+		std::string epoch_;
+		std::deque<WebsocketData> history_;
 
 		struct RequestFactory : Poco::Net::HTTPRequestHandlerFactory
 		{
@@ -29,6 +29,7 @@
 #include "MinerUtil.hpp"
 #include <Poco/JSON/Object.h>
 #include "MinerServer.hpp"
+#include "WebsocketCodec.hpp"
 #include "mining/Miner.hpp"
 #include <Poco/NestedDiagnosticContext.h>
 #include "network/Request.hpp"
@@ -46,6 +47,8 @@
 #include <Poco/Delegate.h>
 #include "plots/Plot.hpp"
 #include <Poco/Net/HTTPRequest.h>
+#include <Poco/NumberParser.h>
+#include <Poco/URI.h>
 
 const std::string cookieUserName = "creepminer-webserver-user";
 const std::string cookiePassName = "creepminer-webserver-pass";
@@ -95,30 +98,79 @@ void Burst::RequestHandler::WebsocketRequestHandler::handleRequest(Poco::Net::HT
 
 	try
 	{
+		// the client chooses the binary messages in the handshake
+		if (WebsocketCodec::isBinaryRequested(request))
+		{
+			response.set("Sec-WebSocket-Protocol", WebsocketCodec::BinaryProtocol);
+			binary_ = true;
+		}
+
+		// a reconnecting client tells the last change it got and the server instance it got it from
+		Poco::UInt64 since = 0;
+		std::string epoch;
+		auto resume = false;
+
+		for (const auto& parameter : URI{request.getURI()}.getQueryParameters())
+			if (parameter.first == "since")
+				resume = NumberParser::tryParseUnsigned64(parameter.second, since);
+			else if (parameter.first == "epoch")
+				epoch = parameter.second;
+
 		WebSocket ws(request, response);
 
+		// the changes up to this one are known by the client
+		Poco::UInt64 synced = 0;
+
 		try
 		{
-			// send the config
 			std::stringstream sstream;
-			createJsonConfig().stringify(sstream);
-			const auto configString = sstream.str();
-			ws.sendFrame(configString.data(), static_cast<int>(configString.size()));
-
-			// send the plot dir data
-			sstream.str("");
-			createJsonPlotDirsRescan().stringify(sstream);
-			const auto plotDirString = sstream.str();
-			ws.sendFrame(plotDirString.data(), static_cast<int>(plotDirString.size()));
 
-			data_.getBlockData()->forEntries([&](const JSON::Object& json)
+			const auto sendJson = [&](const JSON::Object& json)
 			{
 				sstream.str("");
 				JSON::Stringifier::condense(json, sstream);
 				const auto jsonString = sstream.str();
 				ws.sendFrame(jsonString.data(), static_cast<int>(jsonString.size()));
-				return true;
-			});
+			};
+
+			std::vector<WebsocketData> missed;
+			std::vector<JSON::Object> snapshot;
+			resume = resume && server_.getMissedData(epoch, since, missed);
+			synced = resume ? since : server_.createSnapshot(snapshot);
+
+			JSON::Object sync;
+			sync.set("type", "sync");
+			sync.set("seq", synced);
+			sync.set("epoch", server_.getEpoch());
+			sync.set("snapshot", !resume);
+			sendJson(sync);
+
+			if (resume)
+			{
+				// only the missed changes
+				for (const auto& data : missed)
+				{
+					if (binary_ && !data.binary.empty())
+						ws.sendFrame(data.binary.data(), static_cast<int>(data.binary.size()), WebSocket::FRAME_BINARY);
+					else
+						ws.sendFrame(data.json.data(), static_cast<int>(data.json.size()));
+
+					synced = data.sequence;
+				}
+			}
+			else
+			{
+				// the config, the plot dirs and the entries of the current block
+				std::string binary;
+
+				for (const auto& json : snapshot)
+				{
+					if (binary_ && WebsocketCodec::encode(json, binary))
+						ws.sendFrame(binary.data(), static_cast<int>(binary.size()), WebSocket::FRAME_BINARY);
+					else
+						sendJson(json);
+				}
+			}
 		}
 		catch (Exception& exc)
 		{
@@ -137,13 +189,18 @@ void Burst::RequestHandler::WebsocketRequestHandler::handleRequest(Poco::Net::HT
 			if (!close)
 			{
 				std::lock_guard<std::mutex> lock(mutex_);
+				// the changes, that are part of the snapshot or were already caught up with, are skipped
+				while (!queue_.empty() && queue_.front().sequence != 0 && queue_.front().sequence <= synced)
+					queue_.pop_front();
+
 				if (!queue_.empty())
 				{
-					auto data = queue_.front();
+					auto frame = queue_.front();
 					queue_.pop_front();
-					const auto s = ws.sendFrame(data.data(), static_cast<int>(data.size()));
-					if (s != static_cast<int>(data.size()))
-						log_warning(MinerLogger::server, "Could not fully send: %s", data);
+					const auto s = ws.sendFrame(frame.data.data(), static_cast<int>(frame.data.size()),
+						frame.binary ? WebSocket::FRAME_BINARY : WebSocket::FRAME_TEXT);
+					if (s != static_cast<int>(frame.data.size()))
+						log_warning(MinerLogger::server, "Could not fully send: %s", frame.binary ? std::string("binary frame") : frame.data);
 				}
 			}
 		};
@@ -182,10 +239,14 @@ void Burst::RequestHandler::WebsocketRequestHandler::handleRequest(Poco::Net::HT
 	}
 }
 
-void Burst::RequestHandler::WebsocketRequestHandler::onNewData(std::string& data)
+void Burst::RequestHandler::WebsocketRequestHandler::onNewData(WebsocketData& data)
 {
 	std::lock_guard<std::mutex> lock(mutex_);
-	queue_.emplace_back(data);
+
+	if (binary_ && !data.binary.empty())
+		queue_.emplace_back(Frame{data.binary, true, data.sequence});
+	else
+		queue_.emplace_back(Frame{data.json, false, data.sequence});
 }
 
 void Burst::RequestHandler::loadTemplate(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response,
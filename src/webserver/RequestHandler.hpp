@@ -29,6 +29,8 @@
 #include "mining/MinerConfig.hpp"
 #include <stack>
 #include <mutex>
+#include <atomic>
+#include <deque>
 
 namespace Poco
 {
@@ -47,6 +49,7 @@ namespace Burst
 {
 	class Miner;
 	class MinerServer;
+	struct WebsocketData;
 
 	/**
 	 * \brief This class holds key value pairs (string -> string)
@@ -104,6 +107,15 @@ namespace Burst
 			Lambda lambda_;
 		};
 
+		/**
+		 * \brief Keeps a websocket client in sync with the state of the miner.
+		 * A new client gets a snapshot of the state, after that only the changes.
+		 * Every change carries a sequence number ("seq"). A client, that reconnects with
+		 * the query "?since=<seq>&epoch=<epoch>", only gets the changes it missed, as long as the same
+		 * server instance still knows them.
+		 * The first message is always a "sync" message with the sequence number the client is at,
+		 * the epoch of the server instance and whether a snapshot follows.
+		 */
 		class WebsocketRequestHandler : public Poco::Net::HTTPRequestHandler
 		{
 		public:
@@ -112,13 +124,21 @@ namespace Burst
 			void handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response) override;
 
 		private:
-			void onNewData(std::string& data);
+			void onNewData(WebsocketData& data);
 
 		private:
+			struct Frame
+			{
+				std::string data;
+				bool binary;
+				Poco::UInt64 sequence;
+			};
+
 			std::mutex mutex_;
 			MinerServer& server_;
 			MinerData& data_;
-			std::deque<std::string> queue_;
+			std::deque<Frame> queue_;
+			std::atomic<bool> binary_{false};
 		};
 
 		/**
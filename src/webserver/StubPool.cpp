@@ -0,0 +1,465 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#include "StubPool.hpp"
+#include "RequestHandler.hpp"
+#include "Declarations.hpp"
+#include "MinerUtil.hpp"
+#include "logging/MinerLogger.hpp"
+#include "network/Request.hpp"
+#include <Poco/FileStream.h>
+#include <Poco/JSON/Array.h>
+#include <Poco/JSON/Object.h>
+#include <Poco/JSON/Parser.h>
+#include <Poco/Net/HTTPServer.h>
+#include <Poco/Net/HTTPServerRequest.h>
+#include <Poco/Net/HTTPServerResponse.h>
+#include <Poco/Net/ServerSocket.h>
+#include <Poco/NumberParser.h>
+#include <Poco/Thread.h>
+#include <Poco/URI.h>
+
+namespace
+{
+	std::string getQueryParameter(const Poco::URI& uri, const std::string& name)
+	{
+		for (const auto& param : uri.getQueryParameters())
+			if (param.first == name)
+				return param.second;
+
+		return "";
+	}
+
+	void sendJson(Poco::Net::HTTPServerResponse& response, const Poco::JSON::Object& json)
+	{
+		std::stringstream sstream;
+		json.stringify(sstream);
+		const auto data = sstream.str();
+
+		response.setContentType("application/json");
+		response.setContentLength(data.size());
+		response.send() << data;
+	}
+}
+
+Burst::StubPool::StubPool()
+	: random_{std::random_device{}()}
+{}
+
+Burst::StubPool::~StubPool()
+{
+	stop();
+
+	if (server_ != nullptr)
+		server_->stopAll(true);
+}
+
+bool Burst::StubPool::load(const std::string& path)
+{
+	poco_ndc(StubPool::load);
+
+	try
+	{
+		Poco::FileInputStream scriptStream{path};
+		Poco::JSON::Parser parser;
+		const auto script = parser.parse(scriptStream).extract<Poco::JSON::Object::Ptr>();
+
+		port_ = script->optValue<Poco::UInt16>("port", port_);
+		threads_ = std::max(script->optValue("threads", threads_), 1u);
+		loop_ = script->optValue("loop", loop_);
+
+		if (script->has("submit"))
+		{
+			const auto submit = script->getObject("submit");
+			submitLatency_ = submit->optValue("latency", submitLatency_);
+			submitJitter_ = submit->optValue("jitter", submitJitter_);
+			errorRate_ = submit->optValue("errorRate", errorRate_);
+			dropRate_ = submit->optValue("dropRate", dropRate_);
+		}
+
+		if (script->has("wallet"))
+		{
+			const auto wallet = script->getObject("wallet");
+			walletLatency_ = wallet->optValue("latency", walletLatency_);
+			walletName_ = wallet->optValue<std::string>("name", "");
+			rewardRecipient_ = wallet->optValue<Poco::UInt64>("rewardRecipient", 0);
+			generator_ = wallet->optValue<Poco::UInt64>("generator", 0);
+
+			if (wallet->has("blockIds"))
+				for (const auto& blockId : *wallet->getArray("blockIds"))
+					blockIds_.emplace_back(blockId.convert<Poco::UInt64>());
+		}
+
+		blocks_.clear();
+
+		if (script->has("blocks"))
+			for (const auto& blockVar : *script->getArray("blocks"))
+			{
+				const auto blockJson = blockVar.extract<Poco::JSON::Object::Ptr>();
+				Block block;
+
+				// without a height the blocks just count up
+				block.height = blockJson->optValue<Poco::UInt64>("height", blocks_.empty() ? 500000 : blocks_.back().height + 1);
+				block.baseTarget = blockJson->optValue<Poco::UInt64>("baseTarget", 50000);
+				block.targetDeadline = blockJson->optValue<Poco::UInt64>("targetDeadline", 0);
+				block.gensig = blockJson->optValue<std::string>("gensig", "");
+				block.duration = blockJson->optValue("duration", 240u);
+
+				if (block.gensig.size() != 64)
+				{
+					log_error(MinerLogger::server, "Block %Lu of the stub pool script needs a gensig with 64 hex characters!",
+						block.height);
+					return false;
+				}
+
+				if (!blocks_.empty() && block.height <= blocks_.back().height)
+				{
+					log_error(MinerLogger::server, "The block heights of the stub pool script must be ascending!");
+					return false;
+				}
+
+				blocks_.emplace_back(std::move(block));
+			}
+	}
+	catch (Poco::Exception& exc)
+	{
+		log_error(MinerLogger::server, "Could not read the stub pool script %s\n\t%s", path, exc.displayText());
+		return false;
+	}
+
+	if (blocks_.empty())
+	{
+		log_error(MinerLogger::server, "The stub pool script %s contains no blocks!", path);
+		return false;
+	}
+
+	return true;
+}
+
+bool Burst::StubPool::run()
+{
+	using namespace Poco::Net;
+	poco_ndc(StubPool::run);
+
+	ServerSocket socket;
+
+	try
+	{
+		socket.bind(port_, true);
+		socket.listen();
+	}
+	catch (Poco::Exception& exc)
+	{
+		log_fatal(MinerLogger::server, "Could not start the stub pool on port %hu!", port_);
+		log_exception(MinerLogger::server, exc);
+		startedEvent_.set();
+		return false;
+	}
+
+	auto params = new HTTPServerParams;
+	params->setMaxThreads(threads_);
+	params->setMaxQueued(threads_ * 4);
+	params->setKeepAlive(true);
+	params->setServerName("stub pool");
+	params->setSoftwareVersion(Settings::Project.nameAndVersion);
+
+	threadPool_.addCapacity(threads_);
+	server_ = std::make_unique<HTTPServer>(new RequestFactory{*this}, threadPool_, socket, params);
+	server_->start();
+
+	started_ = true;
+	startedEvent_.set();
+
+	log_success(MinerLogger::server, "Stub pool is listening on port %hu (%z blocks, %s)",
+		port_, blocks_.size(), std::string(loop_ ? "looping" : "once"));
+
+	auto stopped = false;
+	const auto heightRange = blocks_.back().height - blocks_.front().height + 1;
+
+	do
+	{
+		for (size_t i = 0; i < blocks_.size() && !stopped; ++i)
+		{
+			{
+				Poco::Mutex::ScopedLock lock{mutex_};
+				currentBlock_ = i;
+				stats_ = {};
+			}
+
+			log_information(MinerLogger::server, "Stub pool block %Lu for %u seconds", getCurrentHeight(), blocks_[i].duration);
+			stopped = stopEvent_.tryWait(blocks_[i].duration * 1000);
+			logBlockStats();
+		}
+
+		// the next loop needs higher heights, otherwise the miners would ignore the blocks
+		Poco::Mutex::ScopedLock lock{mutex_};
+		heightOffset_ += heightRange;
+	}
+	while (loop_ && !stopped);
+
+	server_->stopAll(true);
+	threadPool_.stopAll();
+
+	log_success(MinerLogger::server,
+		"Stub pool finished\n"
+		"\tmining infos: %Lu\n"
+		"\tsubmissions:  %Lu (%Lu confirmed, %Lu errors, %Lu dropped, %Lu stale)\n"
+		"\twallet:       %Lu",
+		total_.miningInfos, total_.submissions, total_.confirmed, total_.errors, total_.dropped, total_.stale,
+		total_.walletRequests);
+
+	return true;
+}
+
+bool Burst::StubPool::waitStarted()
+{
+	startedEvent_.wait();
+	return started_;
+}
+
+void Burst::StubPool::stop()
+{
+	stopEvent_.set();
+}
+
+void Burst::StubPool::handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response)
+{
+	using namespace Poco::Net;
+	poco_ndc(StubPool::handleRequest);
+
+	try
+	{
+		const auto requestType = getQueryParameter(Poco::URI{request.getURI()}, "requestType");
+
+		if (requestType == "getMiningInfo")
+			getMiningInfo(response);
+		else if (requestType == "submitNonce")
+			submitNonce(request, response);
+		else if (requestType == "getBlock" || requestType == "getAccount" ||
+			requestType == "getRewardRecipient" || requestType == "getAccountBlockIds")
+			answerWallet(request, response);
+		else
+		{
+			response.setStatusAndReason(HTTPResponse::HTTP_BAD_REQUEST);
+			response.setContentLength(0);
+			response.send();
+		}
+	}
+	catch (Poco::Exception& exc)
+	{
+		log_debug(MinerLogger::server, "Stub pool could not answer %s\n\t%s", request.getURI(), exc.displayText());
+
+		if (!response.sent())
+		{
+			response.setStatusAndReason(HTTPResponse::HTTP_BAD_REQUEST);
+			response.setContentLength(0);
+			response.send();
+		}
+	}
+}
+
+void Burst::StubPool::getMiningInfo(Poco::Net::HTTPServerResponse& response)
+{
+	Poco::JSON::Object json;
+
+	{
+		Poco::Mutex::ScopedLock lock{mutex_};
+		const auto& block = blocks_[currentBlock_];
+
+		// the real pools send the height as string
+		json.set("height", std::to_string(getCurrentHeight()));
+		json.set("baseTarget", std::to_string(block.baseTarget));
+		json.set("generationSignature", block.gensig);
+
+		if (block.targetDeadline > 0)
+			json.set("targetDeadline", block.targetDeadline);
+
+		++stats_.miningInfos;
+		++total_.miningInfos;
+	}
+
+	sendJson(response, json);
+}
+
+void Burst::StubPool::submitNonce(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response)
+{
+	using namespace Poco::Net;
+
+	const Poco::URI uri{request.getURI()};
+	const auto height = Poco::NumberParser::parseUnsigned64(getQueryParameter(uri, "blockheight"));
+	// the stub has no plots to verify the nonce, so it trusts the deadline of the miner
+	const auto deadline = request.has(X_Deadline) ? Poco::NumberParser::parseUnsigned64(request.get(X_Deadline)) : 0;
+
+	enum class Answer { Confirm, Error, Drop, Stale } answer;
+	unsigned latency;
+
+	{
+		Poco::Mutex::ScopedLock lock{mutex_};
+		latency = randomLatency(submitLatency_, submitJitter_);
+
+		if (height != getCurrentHeight())
+			answer = Answer::Stale;
+		else if (randomHit(dropRate_))
+			answer = Answer::Drop;
+		else if (randomHit(errorRate_))
+			answer = Answer::Error;
+		else
+			answer = Answer::Confirm;
+
+		const auto count = [&](Poco::UInt64 Stats::* counter)
+		{
+			++(stats_.*counter);
+			++(total_.*counter);
+		};
+
+		count(&Stats::submissions);
+
+		switch (answer)
+		{
+		case Answer::Confirm:
+			count(&Stats::confirmed);
+			if (stats_.bestDeadline == 0 || deadline < stats_.bestDeadline)
+				stats_.bestDeadline = deadline;
+			break;
+		case Answer::Error: count(&Stats::errors); break;
+		case Answer::Drop: count(&Stats::dropped); break;
+		case Answer::Stale: count(&Stats::stale); break;
+		}
+	}
+
+	if (latency > 0)
+		Poco::Thread::sleep(latency);
+
+	Poco::JSON::Object json;
+
+	switch (answer)
+	{
+	case Answer::Confirm:
+		json.set("result", "success");
+		json.set("deadline", deadline);
+		break;
+	case Answer::Error:
+		json.set("errorCode", 1004);
+		json.set("errorDescription", "Rejected by the stub pool");
+		break;
+	case Answer::Stale:
+		json.set("errorCode", 1005);
+		json.set("errorDescription", "Submitted on wrong height");
+		break;
+	case Answer::Drop:
+		// no confirmation at all, the miner has to resubmit
+		response.setStatusAndReason(HTTPResponse::HTTP_SERVICE_UNAVAILABLE);
+		response.setContentLength(0);
+		response.send();
+		return;
+	}
+
+	sendJson(response, json);
+}
+
+void Burst::StubPool::answerWallet(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response)
+{
+	const Poco::URI uri{request.getURI()};
+	const auto requestType = getQueryParameter(uri, "requestType");
+	Poco::JSON::Object json;
+	Poco::UInt64 currentHeight;
+
+	if (walletLatency_ > 0)
+		Poco::Thread::sleep(walletLatency_);
+
+	{
+		Poco::Mutex::ScopedLock lock{mutex_};
+		currentHeight = getCurrentHeight();
+		++stats_.walletRequests;
+		++total_.walletRequests;
+	}
+
+	if (requestType == "getBlock")
+	{
+		const auto height = getQueryParameter(uri, "height");
+		json.set("height", height.empty() ? currentHeight - 1 : Poco::NumberParser::parseUnsigned64(height));
+		json.set("generator", std::to_string(generator_));
+	}
+	else if (requestType == "getAccount")
+	{
+		json.set("account", getQueryParameter(uri, "account"));
+		json.set("name", walletName_);
+	}
+	else if (requestType == "getRewardRecipient")
+	{
+		json.set("rewardRecipient", std::to_string(rewardRecipient_));
+	}
+	else if (requestType == "getAccountBlockIds")
+	{
+		Poco::JSON::Array blockIds;
+
+		for (const auto blockId : blockIds_)
+			blockIds.add(std::to_string(blockId));
+
+		json.set("blockIds", blockIds);
+	}
+
+	sendJson(response, json);
+}
+
+Poco::UInt64 Burst::StubPool::getCurrentHeight() const
+{
+	return blocks_[currentBlock_].height + heightOffset_;
+}
+
+void Burst::StubPool::logBlockStats()
+{
+	Poco::Mutex::ScopedLock lock{mutex_};
+
+	log_information(MinerLogger::server,
+		"Stub pool block %Lu done\n"
+		"\tmining infos:  %Lu\n"
+		"\tsubmissions:   %Lu (%Lu confirmed, %Lu errors, %Lu dropped, %Lu stale)\n"
+		"\tbest deadline: %s",
+		getCurrentHeight(), stats_.miningInfos, stats_.submissions, stats_.confirmed, stats_.errors, stats_.dropped,
+		stats_.stale, stats_.confirmed > 0 ? deadlineFormat(stats_.bestDeadline) : std::string("-"));
+}
+
+unsigned Burst::StubPool::randomLatency(const unsigned latency, const unsigned jitter)
+{
+	if (jitter == 0)
+		return latency;
+
+	return latency + std::uniform_int_distribution<unsigned>{0, jitter}(random_);
+}
+
+bool Burst::StubPool::randomHit(const double rate)
+{
+	return rate > 0. && std::uniform_real_distribution<double>{0., 1.}(random_) < rate;
+}
+
+Burst::StubPool::RequestFactory::RequestFactory(StubPool& pool)
+	: pool_{&pool}
+{}
+
+Poco::Net::HTTPRequestHandler* Burst::StubPool::RequestFactory::createRequestHandler(const Poco::Net::HTTPServerRequest& request)
+{
+	return new RequestHandler::LambdaRequestHandler([this](Poco::Net::HTTPServerRequest& req, Poco::Net::HTTPServerResponse& res)
+	{
+		pool_->handleRequest(req, res);
+	});
+}
@@ -0,0 +1,139 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#pragma once
+
+#include <memory>
+#include <random>
+#include <vector>
+#include <Poco/Event.h>
+#include <Poco/Mutex.h>
+#include <Poco/ThreadPool.h>
+#include <Poco/Net/HTTPRequestHandlerFactory.h>
+
+namespace Poco
+{
+	namespace Net
+	{
+		class HTTPServer;
+	}
+}
+
+namespace Burst
+{
+	/**
+	 * \brief A local stand-in for a pool and a wallet.
+	 * Plays a scripted sequence of blocks and answers nonce submissions with
+	 * configurable latency and errors, so that the submission and proxy paths
+	 * can be load-tested without a network.
+	 */
+	class StubPool
+	{
+	public:
+		struct Block
+		{
+			Poco::UInt64 height = 0;
+			Poco::UInt64 baseTarget = 0;
+			Poco::UInt64 targetDeadline = 0;
+			std::string gensig;
+			unsigned duration = 0;
+		};
+
+		StubPool();
+		~StubPool();
+
+		/**
+		 * \brief Loads the script, that describes the blocks and the behaviour of the stub.
+		 * \param path The path to the JSON script.
+		 * \return true, if the script is valid.
+		 */
+		bool load(const std::string& path);
+
+		/**
+		 * \brief Starts the server and plays the scripted blocks.
+		 * Returns after the last block, unless the script loops.
+		 * \return true, if the server could be started.
+		 */
+		bool run();
+
+		/**
+		 * \brief Waits until a running script has started the server or failed to.
+		 * \return true, if the server was started and accepts requests.
+		 */
+		bool waitStarted();
+
+		/**
+		 * \brief Stops a running script.
+		 */
+		void stop();
+
+	private:
+		void handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response);
+		void getMiningInfo(Poco::Net::HTTPServerResponse& response);
+		void submitNonce(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response);
+		void answerWallet(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response);
+		Poco::UInt64 getCurrentHeight() const;
+		void logBlockStats();
+		unsigned randomLatency(unsigned latency, unsigned jitter);
+		bool randomHit(double rate);
+
+		std::vector<Block> blocks_;
+		size_t currentBlock_ = 0;
+		Poco::UInt64 heightOffset_ = 0;
+		Poco::UInt16 port_ = 8125;
+		unsigned threads_ = 64;
+		bool loop_ = false;
+		unsigned submitLatency_ = 0, submitJitter_ = 0, walletLatency_ = 0;
+		double errorRate_ = 0., dropRate_ = 0.;
+		std::string walletName_;
+		Poco::UInt64 rewardRecipient_ = 0, generator_ = 0;
+		std::vector<Poco::UInt64> blockIds_;
+
+		struct Stats
+		{
+			Poco::UInt64 miningInfos = 0;
+			Poco::UInt64 submissions = 0;
+			Poco::UInt64 confirmed = 0;
+			Poco::UInt64 errors = 0;
+			Poco::UInt64 dropped = 0;
+			Poco::UInt64 stale = 0;
+			Poco::UInt64 walletRequests = 0;
+			Poco::UInt64 bestDeadline = 0;
+		} stats_, total_;
+
+		Poco::Mutex mutex_;
+		Poco::Event stopEvent_;
+		Poco::Event startedEvent_;
+		bool started_ = false;
+		std::mt19937_64 random_;
+		Poco::ThreadPool threadPool_;
+		std::unique_ptr<Poco::Net::HTTPServer> server_;
+
+		struct RequestFactory : Poco::Net::HTTPRequestHandlerFactory
+		{
+			explicit RequestFactory(StubPool& pool);
+
+			StubPool* pool_;
+			Poco::Net::HTTPRequestHandler* createRequestHandler(const Poco::Net::HTTPServerRequest& request) override;
+		};
+	};
+}
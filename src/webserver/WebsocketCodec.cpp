@@ -0,0 +1,242 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#include "WebsocketCodec.hpp"
+#include "MinerUtil.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <Poco/Exception.h>
+#include <Poco/JSON/Object.h>
+#include <Poco/Net/HTTPServerRequest.h>
+#include <Poco/NumberParser.h>
+#include <Poco/String.h>
+#include <Poco/StringTokenizer.h>
+
+const std::string Burst::WebsocketCodec::BinaryProtocol = "creepminer-bin";
+
+namespace
+{
+	template <typename T>
+	void writeInteger(std::string& binary, T value)
+	{
+		for (auto i = 0u; i < sizeof(T); ++i)
+			binary.push_back(static_cast<char>((static_cast<Poco::UInt64>(value) >> (i * 8)) & 0xFF));
+	}
+
+	void writeFloat(std::string& binary, const float value)
+	{
+		Poco::UInt32 bits;
+		static_assert(sizeof bits == sizeof value, "float is not 32 bit");
+		memcpy(&bits, &value, sizeof bits);
+		writeInteger(binary, bits);
+	}
+
+	void writeString(std::string& binary, const std::string& value)
+	{
+		const auto size = std::min<size_t>(value.size(), std::numeric_limits<Poco::UInt16>::max());
+		writeInteger(binary, static_cast<Poco::UInt16>(size));
+		binary.append(value, 0, size);
+	}
+
+	void writeHeader(std::string& binary, const Burst::WebsocketCodec::MessageType type, const Poco::JSON::Object& json)
+	{
+		writeInteger(binary, static_cast<Poco::UInt8>(type));
+		writeInteger(binary, json.optValue<Poco::UInt64>("seq", 0));
+	}
+
+	// the numbers of a deadline are strings in the JSON message
+	Poco::UInt64 getNumber(const Poco::JSON::Object& json, const std::string& key)
+	{
+		return Poco::NumberParser::parseUnsigned64(json.getValue<std::string>(key));
+	}
+
+	const std::string deadlineKinds[] = {
+		"nonce found", "nonce found (too high)", "nonce submitted", "nonce confirmed"
+	};
+
+	class Reader
+	{
+	public:
+		explicit Reader(const std::string& binary)
+			: binary_(binary)
+		{}
+
+		template <typename T>
+		T readInteger()
+		{
+			need(sizeof(T));
+			Poco::UInt64 value = 0;
+
+			for (auto i = 0u; i < sizeof(T); ++i)
+				value |= static_cast<Poco::UInt64>(static_cast<Poco::UInt8>(binary_[pos_++])) << (i * 8);
+
+			return static_cast<T>(value);
+		}
+
+		float readFloat()
+		{
+			const auto bits = readInteger<Poco::UInt32>();
+			float value;
+			memcpy(&value, &bits, sizeof value);
+			return value;
+		}
+
+		std::string readString()
+		{
+			const auto size = readInteger<Poco::UInt16>();
+			need(size);
+			pos_ += size;
+			return binary_.substr(pos_ - size, size);
+		}
+
+		bool atEnd() const
+		{
+			return pos_ == binary_.size();
+		}
+
+	private:
+		void need(const size_t size) const
+		{
+			if (binary_.size() - pos_ < size)
+				throw Poco::DataFormatException{"The binary websocket message is too short"};
+		}
+
+		const std::string& binary_;
+		size_t pos_ = 0;
+	};
+}
+
+bool Burst::WebsocketCodec::isBinaryRequested(const Poco::Net::HTTPServerRequest& request)
+{
+	const Poco::StringTokenizer protocols{request.get("Sec-WebSocket-Protocol", ""), ",",
+		Poco::StringTokenizer::TOK_TRIM | Poco::StringTokenizer::TOK_IGNORE_EMPTY};
+
+	return std::any_of(protocols.begin(), protocols.end(), [](const std::string& protocol)
+	{
+		return Poco::icompare(protocol, BinaryProtocol) == 0;
+	});
+}
+
+bool Burst::WebsocketCodec::encode(const Poco::JSON::Object& json, std::string& binary)
+{
+	const auto type = json.optValue<std::string>("type", "");
+
+	binary.clear();
+
+	try
+	{
+		if (type == "progress")
+		{
+			writeHeader(binary, MessageType::Progress, json);
+			writeFloat(binary, json.getValue<float>("value"));
+			writeFloat(binary, json.getValue<float>("valueVerification"));
+			return true;
+		}
+
+		if (type == "plotdir-progress")
+		{
+			writeHeader(binary, MessageType::PlotDirProgress, json);
+			writeFloat(binary, json.getValue<float>("value"));
+			writeString(binary, json.getValue<std::string>("dir"));
+			return true;
+		}
+
+		const auto kind = std::find(std::begin(deadlineKinds), std::end(deadlineKinds), type);
+
+		if (kind != std::end(deadlineKinds))
+		{
+			writeHeader(binary, MessageType::Deadline, json);
+			writeInteger(binary, static_cast<Poco::UInt8>(kind - std::begin(deadlineKinds)));
+			writeInteger(binary, getNumber(json, "nonce"));
+			writeInteger(binary, getNumber(json, "deadlineNum"));
+			writeInteger(binary, getNumber(json, "accountId"));
+			writeInteger(binary, getNumber(json, "blockheight"));
+			writeString(binary, json.getValue<std::string>("account"));
+			writeString(binary, json.getValue<std::string>("plotfile"));
+			writeString(binary, json.getValue<std::string>("time"));
+			return true;
+		}
+	}
+	catch (Poco::Exception&)
+	{
+		// a message with missing or malformed fields is sent as JSON
+	}
+
+	binary.clear();
+	return false;
+}
+
+bool Burst::WebsocketCodec::decode(const std::string& binary, Poco::JSON::Object& json)
+{
+	json.clear();
+
+	try
+	{
+		Reader reader{binary};
+		const auto type = static_cast<MessageType>(reader.readInteger<Poco::UInt8>());
+		const auto seq = reader.readInteger<Poco::UInt64>();
+
+		if (type == MessageType::Progress)
+		{
+			json.set("type", "progress");
+			json.set("value", reader.readFloat());
+			json.set("valueVerification", reader.readFloat());
+		}
+		else if (type == MessageType::PlotDirProgress)
+		{
+			json.set("type", "plotdir-progress");
+			json.set("value", reader.readFloat());
+			json.set("dir", reader.readString());
+		}
+		else if (type == MessageType::Deadline)
+		{
+			const auto kind = reader.readInteger<Poco::UInt8>();
+
+			if (kind >= std::end(deadlineKinds) - std::begin(deadlineKinds))
+				return false;
+
+			json.set("type", deadlineKinds[kind]);
+			json.set("nonce", std::to_string(reader.readInteger<Poco::UInt64>()));
+			const auto deadline = reader.readInteger<Poco::UInt64>();
+			json.set("deadline", deadlineFormat(deadline));
+			json.set("deadlineNum", std::to_string(deadline));
+			json.set("accountId", std::to_string(reader.readInteger<Poco::UInt64>()));
+			json.set("blockheight", std::to_string(reader.readInteger<Poco::UInt64>()));
+			json.set("account", reader.readString());
+			json.set("plotfile", reader.readString());
+			json.set("time", reader.readString());
+		}
+		else
+			return false;
+
+		// a snapshot message has no sequence number
+		if (seq > 0)
+			json.set("seq", seq);
+
+		return reader.atEnd();
+	}
+	catch (Poco::Exception&)
+	{
+		return false;
+	}
+}
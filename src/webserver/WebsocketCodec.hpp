@@ -0,0 +1,100 @@
+﻿// ==========================================================================
+// 
+// creepMiner - Burstcoin cryptocurrency CPU and GPU miner
+// Copyright (C)  2016-2018 Creepsky (creepsky@gmail.com)
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110 - 1301  USA
+// 
+// ==========================================================================
+
+
+#pragma once
+
+#include <string>
+#include <Poco/Types.h>
+
+namespace Poco
+{
+	namespace JSON
+	{
+		class Object;
+	}
+
+	namespace Net
+	{
+		class HTTPServerRequest;
+	}
+}
+
+namespace Burst
+{
+	/**
+	 * \brief The frequent websocket messages in a compact binary form.
+	 * A client gets them, when it asks for the subprotocol "creepminer-bin" in the handshake.
+	 * All other messages stay JSON text frames, so a binary client has to handle both.
+	 *
+	 * Every binary frame starts with the type of the message (UInt8) and its sequence number (UInt64,
+	 * 0 for the messages of a snapshot). All numbers are little endian, strings are a UInt16 length
+	 * followed by the UTF-8 bytes.
+	 *
+	 * Progress (1): Float32 read progress, Float32 verification progress.
+	 * PlotDirProgress (2): Float32 progress, String dir.
+	 * Deadline (3): UInt8 kind (0 = nonce found, 1 = nonce found (too high), 2 = nonce submitted,
+	 * 3 = nonce confirmed), UInt64 nonce, UInt64 deadline, UInt64 account id, UInt64 blockheight,
+	 * String account name, String plot file, String time.
+	 * The formatted "deadline" of the JSON message is not sent, it is derived from the deadline in seconds.
+	 */
+	class WebsocketCodec
+	{
+	public:
+		~WebsocketCodec() = delete;
+
+		enum class MessageType : Poco::UInt8
+		{
+			Progress = 1,
+			PlotDirProgress = 2,
+			Deadline = 3
+		};
+
+		/**
+		 * \brief The name of the binary subprotocol.
+		 */
+		static const std::string BinaryProtocol;
+
+		/**
+		 * \brief Checks, if a websocket handshake asks for the binary subprotocol.
+		 * \param request The handshake request.
+		 * \return true, if the client understands the binary messages, false otherwise.
+		 */
+		static bool isBinaryRequested(const Poco::Net::HTTPServerRequest& request);
+
+		/**
+		 * \brief Encodes a JSON message in the binary form.
+		 * \param json The JSON message.
+		 * \param binary The binary message.
+		 * \return true, if the message has a binary form, false if it has to be sent as JSON.
+		 */
+		static bool encode(const Poco::JSON::Object& json, std::string& binary);
+
+		/**
+		 * \brief Decodes a binary message into its JSON form.
+		 * The numbers of a deadline are strings like in the JSON message, the formatted deadline is derived from the seconds.
+		 * \param binary The binary message.
+		 * \param json The JSON message.
+		 * \return true, if the message was decoded, false if it is malformed.
+		 */
+		static bool decode(const std::string& binary, Poco::JSON::Object& json);
+	};
+}